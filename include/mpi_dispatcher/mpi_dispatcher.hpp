@@ -87,6 +87,8 @@ struct MPIMaster {
     std::stack<JobId> JobStack;
     /// Stack of currently pending workers.
     std::stack<WorkerId> WorkerStack;
+    /// Stacks of jobs that should preferably be performed by specific workers.
+    std::map<WorkerId, std::stack<JobId>> AffineJobStacks;
 
     /// A mapping from job IDs to IDs of the workers assigned to perform the jobs.
     std::map<JobId, WorkerId> DispatchMap;
@@ -120,6 +122,14 @@ struct MPIMaster {
     ///                         Otherwise, skip the rank of the master process.
     MPIMaster(MPI_Comm const& Comm, std::size_t ntasks, bool include_boss = true);
 
+    /// Declare preferred workers for some of the jobs, e.g. the workers that already store the data
+    /// needed to perform the jobs. A pending worker is given its preferred jobs first, while jobs of busy
+    /// workers can still be given to other pending workers unless \p strict is set.
+    /// \param[in] affinity A mapping from job IDs to IDs of the preferred workers.
+    /// \param[in] strict Give the jobs listed in \p affinity only to their preferred workers.
+    /// \pre No jobs have been ordered yet.
+    void set_affinity(std::map<JobId, WorkerId> const& affinity, bool strict = false);
+
     /// Request a worker process to perform a job.
     /// \param[in] worker_id ID of the worker process.
     /// \param[in] job ID of the job to be performed.
@@ -134,6 +144,8 @@ struct MPIMaster {
 private:
     // Implementation details
     void fill_stack_();
+    bool next_job_(WorkerId worker, JobId& job);
+    bool has_jobs_();
 };
 
 ///@}
@@ -21,10 +21,12 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <functional>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <numeric>
+#include <queue>
 #include <tuple>
 #include <vector>
 
@@ -33,6 +35,9 @@ namespace pMPI {
 /// \addtogroup MPI
 ///@{
 
+/// Estimated computational cost of a job (in arbitrary units).
+using CostType = double;
+
 /// \brief Wrapper around a computable object that calls the compute() method
 /// of the wrapped object and carries information about the complexity of a call to that method.
 /// \tparam PartType Type of the wrapped object.
@@ -40,12 +45,12 @@ template <typename PartType> struct ComputeWrap {
     /// Reference to the wrapped object.
     PartType& x;
     /// Complexity of a call to x.compute().
-    int complexity;
+    CostType complexity;
 
     /// Constructor.
     /// \param[in] x Reference to the wrapped object.
     /// \param[in] complexity Complexity of a call to x.compute().
-    explicit ComputeWrap(PartType& x, int complexity = 1) : x(x), complexity(complexity) {}
+    explicit ComputeWrap(PartType& x, CostType complexity = 1) : x(x), complexity(complexity) {}
     /// Call compute() of the wrapped object \ref x.
     void run() { x.compute(); }
 };
@@ -57,23 +62,66 @@ template <typename PartType> struct PrepareWrap {
     /// Reference to the wrapped object.
     PartType& x;
     /// Complexity of a call to x.prepare().
-    int complexity;
+    CostType complexity;
 
     /// Constructor.
     /// \param[in] x Reference to the wrapped object.
     /// \param[in] complexity Complexity of a call to x.prepare().
-    explicit PrepareWrap(PartType& x, int complexity = 1) : x(x), complexity(complexity) {}
+    explicit PrepareWrap(PartType& x, CostType complexity = 1) : x(x), complexity(complexity) {}
     /// Call prepare() of the wrapped object \ref x.
     void run() { x.prepare(); }
 };
 
+/// \brief Predict load imbalance of the longest-processing-time-first (LPT) schedule.
+///
+/// Jobs are taken in the order of decreasing cost and each of them is given to the least loaded worker.
+/// \param[in] costs Estimated costs of the jobs.
+/// \param[in] n_workers Number of workers.
+/// \return Ratio of the maximal to the average predicted worker load.
+inline double lpt_imbalance(std::vector<CostType> costs, int n_workers) {
+    CostType total = std::accumulate(costs.begin(), costs.end(), CostType(0));
+    if(n_workers <= 0 || total <= 0)
+        return 1.0;
+    std::sort(costs.begin(), costs.end(), std::greater<CostType>());
+    std::priority_queue<CostType, std::vector<CostType>, std::greater<CostType>> loads;
+    for(int w = 0; w < n_workers; ++w)
+        loads.push(0);
+    for(CostType c : costs) {
+        CostType l = loads.top();
+        loads.pop();
+        loads.push(l + c);
+    }
+    CostType max_load = 0;
+    for(; !loads.empty(); loads.pop())
+        max_load = loads.top();
+    return max_load * n_workers / total;
+}
+
 /// \brief This structure carries a list of wrappers and uses the mpi_dispatcher mechanism
 /// to distribute the wrappers over MPI ranks and to call run() for all of them in parallel.
+///
+/// The jobs are dispatched in the order of decreasing estimated cost (longest processing time first).
+/// The cost of a job is given by the \p complexity member of its wrapper, unless a custom estimator
+/// \ref cost_estimator is provided.
 /// \tparam WrapType Type of the wrappers, one of \ref PrepareWrap and \ref ComputeWrap.
 template <typename WrapType> struct mpi_skel {
     /// List of wrappers
     std::vector<WrapType> parts;
-    /// Distribute the stored wrappers over MPI ranks according to their complexity
+    /// Optional mapping from job IDs (indices in \ref parts) to the preferred ranks to run the jobs on.
+    std::map<pMPI::JobId, pMPI::WorkerId> affinity;
+    /// Run the jobs listed in \ref affinity only on their preferred ranks.
+    bool strict_affinity = false;
+    /// Optional custom cost estimator for the wrapped jobs.
+    std::function<CostType(WrapType const&)> cost_estimator;
+
+    /// Ratio of the maximal to the average load of the workers predicted from the estimated costs
+    /// (set by \ref run()).
+    double predicted_imbalance = 1.0;
+    /// Ratio of the maximal to the average wall time spent by the workers running their jobs
+    /// (set by \ref run()).
+    double actual_imbalance = 1.0;
+
+    /// Distribute the stored wrappers over MPI ranks according to their estimated cost
     /// and call run() for each of the wrappers.
     /// \param[in] Comm MPI communicator.
     /// \param[in] VerboseOutput Print extra information about the parallelization process.
@@ -94,20 +142,28 @@ std::map<pMPI::JobId, pMPI::WorkerId> mpi_skel<WrapType>::run(MPI_Comm const& Co
 
     std::unique_ptr<pMPI::MPIMaster> disp;
 
+    std::vector<CostType> costs(parts.size());
+    for(std::size_t p = 0; p < parts.size(); ++p)
+        costs[p] = cost_estimator ? cost_estimator(parts[p]) : CostType(parts[p].complexity);
+
     if(comm_rank == root) {
         // prepare one Master on a root process for distributing parts.size() jobs
         std::vector<pMPI::JobId> job_order(parts.size());
         std::iota(job_order.begin(), job_order.end(), 0);
 
-        auto comp1 = [this](std::size_t l, std::size_t r) -> int {
-            return (parts[l].complexity > parts[r].complexity);
-        };
-        std::sort(job_order.begin(), job_order.end(), comp1);
+        // Longest processing time first
+        auto comp1 = [&costs](std::size_t l, std::size_t r) -> bool { return costs[l] > costs[r]; };
+        std::stable_sort(job_order.begin(), job_order.end(), comp1);
         disp.reset(new pMPI::MPIMaster(Comm, job_order, true));
+        if(!affinity.empty())
+            disp->set_affinity(affinity, strict_affinity);
     }
 
     MPI_Barrier(Comm);
 
+    // Wall time this process has spent running jobs
+    double busy_time = 0;
+
     // Start calculating data
     for(pMPI::MPIWorker worker(Comm, root); !worker.is_finished();) {
         if(comm_rank == root)
@@ -117,8 +173,10 @@ std::map<pMPI::JobId, pMPI::WorkerId> mpi_skel<WrapType>::run(MPI_Comm const& Co
             JobId p = worker.current_job();
             if(VerboseOutput)
                 std::cout << "[" << p + 1 << "/" << parts.size() << "] P" << comm_rank << " : part " << p << " ["
-                          << parts[p].complexity << "] run;\n";
+                          << costs[p] << "] run;\n";
+            double start_time = MPI_Wtime();
             parts[p].run();
+            busy_time += MPI_Wtime() - start_time;
             worker.report_job_done();
         }
         if(comm_rank == root)
@@ -131,6 +189,16 @@ std::map<pMPI::JobId, pMPI::WorkerId> mpi_skel<WrapType>::run(MPI_Comm const& Co
     if(VerboseOutput && comm_rank == root)
         std::cout << "done.\n";
 
+    // Compare predicted and actual load balance
+    predicted_imbalance = lpt_imbalance(costs, comm_size);
+    double max_busy_time = 0, total_busy_time = 0;
+    MPI_Allreduce(&busy_time, &max_busy_time, 1, MPI_DOUBLE, MPI_MAX, Comm);
+    MPI_Allreduce(&busy_time, &total_busy_time, 1, MPI_DOUBLE, MPI_SUM, Comm);
+    actual_imbalance = total_busy_time > 0 ? max_busy_time * comm_size / total_busy_time : 1.0;
+    if(VerboseOutput && comm_rank == root)
+        std::cout << "Load imbalance (max/average): predicted " << predicted_imbalance << ", actual "
+                  << actual_imbalance << '\n';
+
     MPI_Barrier(Comm);
     std::map<pMPI::JobId, pMPI::WorkerId> job_map;
     if(comm_rank == root) {
@@ -19,9 +19,12 @@
 #include "mpi_dispatcher/mpi_dispatcher.hpp"
 #include "mpi_dispatcher/mpi_skel.hpp"
 
+#include "pomerol/BetheSalpeter.hpp"
 #include "pomerol/DensityMatrix.hpp"
+#include "pomerol/DistributedVector.hpp"
 #include "pomerol/EnsembleAverage.hpp"
 #include "pomerol/FieldOperatorContainer.hpp"
+#include "pomerol/FrequencyGrids.hpp"
 #include "pomerol/GFContainer.hpp"
 #include "pomerol/Hamiltonian.hpp"
 #include "pomerol/Index.hpp"
@@ -32,6 +35,7 @@
 #include "pomerol/Operators.hpp"
 #include "pomerol/StatesClassification.hpp"
 #include "pomerol/Susceptibility.hpp"
+#include "pomerol/SymmetryAnalyzer.hpp"
 #include "pomerol/ThreePointSusceptibility.hpp"
 #include "pomerol/ThreePointSusceptibilityContainer.hpp"
 #include "pomerol/TwoParticleGF.hpp"
@@ -71,6 +75,8 @@ namespace Pomerol {
 ///       (\ref ThreePointSusceptibility, \ref ThreePointSusceptibilityContainer).
 ///     - Two-particle fermionic Green's functions and irreducible vertices (\ref TwoParticleGF,
 ///       \ref TwoParticleGFContainer, \ref Vertex4).
+///     - Generalized susceptibilities and channel-irreducible vertices from the Bethe-Salpeter equation
+///       (\ref BetheSalpeter).
 ///
 /// All available classes and functions are grouped into a few modules, so you can check out
 /// the <a href="modules.html">Modules</a> page to get an overview of libpomerol's API.
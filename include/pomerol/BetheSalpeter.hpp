@@ -0,0 +1,185 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file include/pomerol/BetheSalpeter.hpp
+/// \brief Generalized susceptibilities and channel-irreducible vertices from the Bethe-Salpeter equation.
+
+#ifndef POMEROL_INCLUDE_POMEROL_BETHESALPETER_HPP
+#define POMEROL_INCLUDE_POMEROL_BETHESALPETER_HPP
+
+#include "ComputableObject.hpp"
+#include "FrequencyGrids.hpp"
+#include "GFContainer.hpp"
+#include "Index.hpp"
+#include "Misc.hpp"
+#include "TwoParticleGFContainer.hpp"
+
+#include "mpi_dispatcher/misc.hpp"
+
+#include <cstddef>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Pomerol {
+
+/// \addtogroup 2PGF
+///@{
+
+/// \brief Generalized susceptibilities and channel-irreducible vertices.
+///
+/// For a given channel (\ref FreqGrid3 defines the frequency conventions) and each bosonic frequency
+/// \f$\Omega_m\f$, this class assembles the generalized susceptibility \f$X\f$ and the bubble \f$X^0\f$
+/// as dense matrices in the composite index \f$(p,\nu)\f$, where \f$p\f$ runs over a list of
+/// single-particle index pairs and \f$\nu\f$ over a range of fermionic frequencies.
+/// The composite index is \f$p N_\nu + (\nu - \nu_\mathrm{first})\f$.
+/// The row pair \f$p\f$ and the column pair \f$q\f$ form the element \f$\chi_{ijkl}\f$ of the two-particle
+/// Green's function as follows.
+/// \li Particle-particle channel: \f$p = (i,j)\f$, \f$q = (k,l)\f$.
+/// \li Particle-hole channel: \f$p = (i,k)\f$, \f$q = (j,l)\f$.
+/// \li Crossed particle-hole channel: \f$p = (i,l)\f$, \f$q = (j,k)\f$.
+///
+/// The disconnected part of \f$\chi_{ijkl}\f$ (see \ref Vertex4) consists of two terms. The term diagonal in
+/// \f$(\nu,\nu')\f$ forms the bubble \f$X^0\f$, and the generalized susceptibility \f$X\f$ is \f$\chi\f$ with the
+/// other term subtracted. The channel-irreducible vertex is then defined by the Bethe-Salpeter equation
+/// \f[
+///   X = X^0 + X^0 \Gamma X, \quad \Gamma = (X^0)^{-1} - X^{-1},
+/// \f]
+/// where all products are plain matrix products, i.e. no factors of \f$\beta\f$ or \f$1/2\f$ are included.
+///
+/// The bosonic frequencies are split into contiguous slices owned by processes of an MPI communicator,
+/// and the matrices for different bosonic frequencies within a slice are inverted in parallel by OpenMP threads.
+class BetheSalpeter : public ComputableObject {
+    /// Channel defining the frequency conventions and the pairing of indices.
+    Channel channel;
+    /// Single-particle index pairs \f$p\f$.
+    std::vector<IndexCombination2> Pairs;
+    /// Bosonic range \f$\Omega_m\f$.
+    MatsubaraRange W;
+    /// Fermionic range \f$\nu\f$.
+    MatsubaraRange Nu;
+
+    /// Elements \f$\chi_{ijkl}\f$ for all combinations of the row and column pairs, \f$p N_p + q\f$.
+    std::vector<IndexCombination4> Combinations;
+
+    /// MPI communicator used in \ref compute().
+    MPI_Comm Comm = MPI_COMM_WORLD;
+    /// Bosonic indices owned by the calling process.
+    MatsubaraRange LocalW;
+
+    /// Generalized susceptibilities, one row-major \f$D \times D\f$ matrix per owned bosonic frequency.
+    std::vector<ComplexType> Susceptibility;
+    /// Blocks of the bubble, one row-major \f$N_p \times N_p\f$ matrix per owned bosonic frequency and \f$\nu\f$.
+    std::vector<ComplexType> Bubble;
+    /// Irreducible vertices, one row-major \f$D \times D\f$ matrix per owned bosonic frequency.
+    std::vector<ComplexType> Vertex;
+
+    /// Return the range of bosonic indices owned by a process.
+    /// \param[in] Rank Rank of the process.
+    /// \param[in] Size Number of processes.
+    MatsubaraRange getBosonicSlice(int Rank, int Size) const;
+
+    /// Assemble \f$X\f$ and \f$X^0\f$ and solve the Bethe-Salpeter equation.
+    /// \param[in] LocalChi Values of \f$\chi_{ijkl}\f$ for each element of \ref Combinations,
+    ///                     stored in the dense tensor layout of the grid restricted to \ref LocalW.
+    /// \param[in] G Single-particle Green's function \f$G_{ij}\f$.
+    void solve(std::vector<std::vector<ComplexType>> const& LocalChi, GFContainer& G);
+
+    /// Assemble a matrix stored for all owned bosonic frequencies on one process.
+    /// \param[in] Data Matrices stored on the calling process.
+    /// \param[in] Root Rank of the receiving process.
+    std::vector<ComplexType> gather(std::vector<ComplexType> const& Data, int Root) const;
+
+public:
+    /// Constructor.
+    /// \param[in] channel Channel defining the frequency conventions and the pairing of indices.
+    /// \param[in] Pairs Single-particle index pairs forming the rows and the columns of the matrices.
+    /// \param[in] W Range of bosonic indices \f$m\f$.
+    /// \param[in] Nu Range of fermionic indices \f$n\f$ of \f$\nu\f$ and \f$\nu'\f$.
+    BetheSalpeter(Channel channel,
+                  std::vector<IndexCombination2> const& Pairs,
+                  MatsubaraRange const& W,
+                  MatsubaraRange const& Nu);
+
+    /// Channel defining the frequency conventions and the pairing of indices.
+    Channel getChannel() const { return channel; }
+
+    /// Return the grid of Matsubara frequency triplets, on which values of \f$\chi_{ijkl}\f$ are needed.
+    FreqGrid3 getGrid() const { return FreqGrid3(channel, W, Nu, Nu); }
+
+    /// Return the index combinations \f$(i,j,k,l)\f$ of the elements \f$\chi_{ijkl}\f$ that are needed.
+    std::set<IndexCombination4> getIndexCombinations() const {
+        return std::set<IndexCombination4>(Combinations.begin(), Combinations.end());
+    }
+
+    /// Return the size \f$D = N_p N_\nu\f$ of the matrices.
+    std::size_t getMatrixSize() const { return Pairs.size() * Nu.size(); }
+
+    /// Return the position of a composite index \f$(p,\nu)\f$ in the matrices.
+    /// \param[in] Pair Position of the pair \f$p\f$ in the list of pairs.
+    /// \param[in] n Index of the fermionic frequency \f$\nu\f$.
+    std::size_t getMatrixIndex(std::size_t Pair, long n) const {
+        return Pair * Nu.size() + static_cast<std::size_t>(n - Nu.Begin);
+    }
+
+    /// \brief Solve the Bethe-Salpeter equation using precomputed values of \f$\chi_{ijkl}\f$.
+    ///
+    /// This is a collective operation on \p comm.
+    /// \param[in] ChiValues Values of all elements listed by \ref getIndexCombinations() stored in the dense tensor
+    ///                      layout of \ref getGrid(), e.g. the result of \ref TwoParticleGFContainer::computeAll().
+    /// \param[in] G Single-particle Green's function \f$G_{ij}\f$.
+    /// \param[in] comm MPI communicator, over which the bosonic frequencies are distributed.
+    /// \pre G.computeAll() has been called.
+    void compute(std::map<IndexCombination4, std::vector<ComplexType>> const& ChiValues,
+                 GFContainer& G,
+                 MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Solve the Bethe-Salpeter equation evaluating \f$\chi_{ijkl}\f$ from its computed terms.
+    ///
+    /// Each process evaluates \f$\chi_{ijkl}\f$ only at its own bosonic frequencies by
+    /// \ref TwoParticleGF::evaluate(), so the full grid is never stored. This is a collective operation on \p comm.
+    /// \param[in] Chi Two-particle Green's function \f$\chi_{ijkl}\f$ containing all elements listed by
+    ///                \ref getIndexCombinations().
+    /// \param[in] G Single-particle Green's function \f$G_{ij}\f$.
+    /// \param[in] comm MPI communicator used to compute \p Chi.
+    /// \pre Chi.computeAll() has been called with \p clearTerms = false, and G.computeAll() has been called.
+    void compute(TwoParticleGFContainer& Chi, GFContainer& G, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// Return the range of bosonic indices owned by the calling process.
+    MatsubaraRange const& getLocalBosonicRange() const { return LocalW; }
+
+    /// Return the generalized susceptibility \f$X\f$ at a bosonic frequency owned by the calling process.
+    /// \param[in] m Index of the bosonic frequency \f$\Omega_m\f$.
+    ComplexMatrixType getSusceptibility(long m) const;
+    /// Return the bubble \f$X^0\f$ at a bosonic frequency owned by the calling process.
+    /// \param[in] m Index of the bosonic frequency \f$\Omega_m\f$.
+    ComplexMatrixType getBubble(long m) const;
+    /// Return the irreducible vertex \f$\Gamma\f$ at a bosonic frequency owned by the calling process.
+    /// \param[in] m Index of the bosonic frequency \f$\Omega_m\f$.
+    ComplexMatrixType getVertex(long m) const;
+
+    /// Assemble the irreducible vertex at all bosonic frequencies on one process. This is a collective operation.
+    /// \param[in] Root Rank of the receiving process.
+    /// \return Row-major \f$D \times D\f$ matrices for all bosonic frequencies stored one after another
+    ///         on the process \p Root and an empty vector on the other processes.
+    std::vector<ComplexType> gatherVertex(int Root = 0) const { return gather(Vertex, Root); }
+    /// Assemble the generalized susceptibility at all bosonic frequencies on one process.
+    /// This is a collective operation.
+    /// \param[in] Root Rank of the receiving process.
+    /// \return Row-major \f$D \times D\f$ matrices for all bosonic frequencies stored one after another
+    ///         on the process \p Root and an empty vector on the other processes.
+    std::vector<ComplexType> gatherSusceptibility(int Root = 0) const { return gather(Susceptibility, Root); }
+};
+
+///@}
+
+} // namespace Pomerol
+
+#endif // #ifndef POMEROL_INCLUDE_POMEROL_BETHESALPETER_HPP
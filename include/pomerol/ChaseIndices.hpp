@@ -26,9 +26,10 @@
 namespace Pomerol {
 
 /// Make the lagging index catch up or outrun the leading index.
-template <bool Complex>
-inline bool chaseIndices(typename RowMajorMatrixType<Complex>::InnerIterator& index1_iter,
-                         typename ColMajorMatrixType<Complex>::InnerIterator& index2_iter) {
+/// \tparam Iterator1 Inner iterator over a row of a row-major sparse matrix or view.
+/// \tparam Iterator2 Inner iterator over a column of a column-major sparse matrix or view.
+template <typename Iterator1, typename Iterator2>
+inline bool chaseIndices(Iterator1& index1_iter, Iterator2& index2_iter) {
     InnerQuantumState index1 = index1_iter.index();
     InnerQuantumState index2 = index2_iter.index();
 
@@ -0,0 +1,197 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file include/pomerol/Davidson.hpp
+/// \brief Block Davidson method for the lowest eigenpairs of a Hermitian matrix.
+
+#ifndef POMEROL_INCLUDE_POMEROL_DAVIDSON_HPP
+#define POMEROL_INCLUDE_POMEROL_DAVIDSON_HPP
+
+#include "Misc.hpp"
+
+#include <Eigen/Eigenvalues>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Pomerol {
+
+/// \addtogroup ED
+///@{
+
+/// Column-major dense block of vectors the Davidson eigensolver operates on.
+/// \tparam Complex Whether the vectors are complex.
+template <bool Complex>
+using DavidsonBlockType = Eigen::Matrix<MelemType<Complex>, Eigen::Dynamic, Eigen::Dynamic, Eigen::ColMajor>;
+
+/// \brief Compute a few lowest eigenpairs of a Hermitian matrix using the block Davidson method.
+///
+/// The matrix \f$H\f$ is accessed only through its action on blocks of vectors and through its diagonal,
+/// which serves as a preconditioner for the correction vectors. The search subspace is thick-restarted
+/// with the lowest Ritz vectors whenever it grows beyond \f$3 k + 16\f$ vectors.
+/// \tparam Complex Whether the matrix is complex.
+/// \tparam MatVec Type of the callable object that computes \f$Y = H X\f$.
+/// \param[in] HOp A callable object with signature
+///                `void(DavidsonBlockType<Complex> const& X, DavidsonBlockType<Complex>& Y)`.
+/// \param[in] Diagonal Diagonal matrix elements of \f$H\f$.
+/// \param[in] NumEigenvalues Number \f$k\f$ of the lowest eigenpairs to compute.
+/// \param[in] Tolerance Convergence threshold for the residual norms \f$\|H x_i - \lambda_i x_i\|\f$
+///                      (relative to \f$|\lambda_i|\f$ when \f$|\lambda_i| > 1\f$).
+/// \param[in] MaxIterations Maximal number of iterations.
+/// \param[out] Eigenvalues The lowest \f$k\f$ eigenvalues in ascending order.
+/// \param[out] Eigenvectors A rectangular matrix, whose columns are the respective eigenvectors.
+/// \return Number of performed iterations.
+template <bool Complex, typename MatVec>
+unsigned int davidsonLowest(MatVec const& HOp,
+                            RealVectorType const& Diagonal,
+                            Eigen::Index NumEigenvalues,
+                            RealType Tolerance,
+                            unsigned int MaxIterations,
+                            RealVectorType& Eigenvalues,
+                            MatrixType<Complex>& Eigenvectors) {
+    using BlockType = DavidsonBlockType<Complex>;
+    using ScalarType = MelemType<Complex>;
+
+    Eigen::Index const N = Diagonal.size();
+    Eigen::Index const NEV = std::min(NumEigenvalues, N);
+    if(NEV <= 0)
+        throw std::invalid_argument("davidsonLowest: Number of requested eigenpairs must be positive");
+
+    Eigen::Index const MaxBasisSize = std::min(N, 3 * NEV + 16);
+    Eigen::Index const RestartSize = std::min(2 * NEV, MaxBasisSize - NEV);
+    RealType const MinDenominator = 1e-8;
+
+    // Orthonormal basis V of the search subspace, H V and the projected matrix V^\dagger H V
+    BlockType V(N, MaxBasisSize);
+    BlockType W(N, MaxBasisSize);
+    BlockType T = BlockType::Zero(MaxBasisSize, MaxBasisSize);
+
+    std::mt19937 rng(N);
+    std::uniform_real_distribution<RealType> noise(-1e-2, 1e-2);
+
+    // Orthonormalize columns of Candidates against the first m basis vectors and among themselves,
+    // then append the surviving columns to the basis.
+    auto appendToBasis = [&V, N](BlockType& Candidates, Eigen::Index m) -> Eigen::Index {
+        Eigen::Index Added = 0;
+        for(Eigen::Index c = 0; c < Candidates.cols(); ++c) {
+            auto t = Candidates.col(c);
+            RealType Norm0 = t.norm();
+            if(Norm0 == 0)
+                continue;
+            // Classical Gram-Schmidt with reorthogonalization
+            for(int pass = 0; pass < 2; ++pass) {
+                if(m + Added > 0)
+                    t -= V.leftCols(m + Added) * (V.leftCols(m + Added).adjoint() * t);
+            }
+            RealType Norm = t.norm();
+            if(Norm < 1e-8 * Norm0 || m + Added >= N)
+                continue;
+            V.col(m + Added) = t / Norm;
+            ++Added;
+        }
+        return Added;
+    };
+
+    // Initial guess: unit vectors corresponding to the lowest diagonal elements with a small random admixture
+    std::vector<Eigen::Index> Order(N);
+    for(Eigen::Index i = 0; i < N; ++i)
+        Order[i] = i;
+    std::partial_sort(Order.begin(), Order.begin() + NEV, Order.end(), [&Diagonal](Eigen::Index a, Eigen::Index b) {
+        return Diagonal(a) < Diagonal(b);
+    });
+    BlockType Guess(N, NEV);
+    for(Eigen::Index j = 0; j < NEV; ++j) {
+        for(Eigen::Index i = 0; i < N; ++i)
+            Guess(i, j) = noise(rng);
+        Guess(Order[j], j) += 1.0;
+    }
+
+    Eigen::Index m = 0;
+    Eigen::Index NumNew = appendToBasis(Guess, m);
+
+    BlockType X, HX, R;
+    for(unsigned int iter = 1;; ++iter) {
+        // Act with H on the new basis vectors and extend the projected matrix
+        BlockType NewV = V.middleCols(m, NumNew);
+        BlockType NewW(N, NumNew);
+        HOp(NewV, NewW);
+        W.middleCols(m, NumNew) = NewW;
+        T.block(0, m, m + NumNew, NumNew).noalias() = V.leftCols(m + NumNew).adjoint() * NewW;
+        T.block(m, 0, NumNew, m) = T.block(0, m, m, NumNew).adjoint();
+        m += NumNew;
+
+        // Rayleigh-Ritz procedure
+        Eigen::SelfAdjointEigenSolver<BlockType> Solver(T.topLeftCorner(m, m), Eigen::ComputeEigenvectors);
+        RealVectorType const& Theta = Solver.eigenvalues();
+        BlockType const& S = Solver.eigenvectors();
+
+        Eigen::Index NumRitz = std::min(m, NEV);
+        X.noalias() = V.leftCols(m) * S.leftCols(NumRitz);
+        HX.noalias() = W.leftCols(m) * S.leftCols(NumRitz);
+        R = HX - X * Theta.head(NumRitz).template cast<ScalarType>().asDiagonal();
+
+        // Convergence check and preconditioned corrections for non-converged Ritz pairs
+        std::vector<Eigen::Index> NotConverged;
+        for(Eigen::Index i = 0; i < NumRitz; ++i) {
+            if(R.col(i).norm() > Tolerance * std::max(RealType(1), std::abs(Theta(i))))
+                NotConverged.push_back(i);
+        }
+
+        if(NumRitz == NEV && NotConverged.empty()) {
+            Eigenvalues = Theta.head(NEV);
+            Eigenvectors = X;
+            return iter;
+        }
+        if(iter >= MaxIterations)
+            throw std::runtime_error("davidsonLowest: No convergence after " + std::to_string(MaxIterations) +
+                                     " iterations");
+
+        BlockType Corrections(N, NotConverged.size());
+        for(std::size_t c = 0; c < NotConverged.size(); ++c) {
+            Eigen::Index i = NotConverged[c];
+            for(Eigen::Index n = 0; n < N; ++n) {
+                RealType Denominator = Theta(i) - Diagonal(n);
+                if(std::abs(Denominator) < MinDenominator)
+                    Denominator = std::copysign(MinDenominator, Denominator);
+                Corrections(n, c) = R(n, i) / Denominator;
+            }
+        }
+
+        // Thick restart with the lowest Ritz vectors
+        if(m + Corrections.cols() > MaxBasisSize) {
+            Eigen::Index Keep = std::min(m, RestartSize);
+            V.leftCols(Keep) = (V.leftCols(m) * S.leftCols(Keep)).eval();
+            W.leftCols(Keep) = (W.leftCols(m) * S.leftCols(Keep)).eval();
+            T.topLeftCorner(Keep, Keep) = Theta.head(Keep).template cast<ScalarType>().asDiagonal();
+            m = Keep;
+        }
+
+        NumNew = appendToBasis(Corrections, m);
+        if(NumNew == 0) {
+            // Stagnation: extend the search subspace with a random vector
+            if(m >= N)
+                throw std::runtime_error("davidsonLowest: Search subspace cannot be extended");
+            BlockType Random(N, 1);
+            for(Eigen::Index n = 0; n < N; ++n)
+                Random(n, 0) = noise(rng);
+            NumNew = appendToBasis(Random, m);
+        }
+    }
+}
+
+///@}
+
+} // namespace Pomerol
+
+#endif // #ifndef POMEROL_INCLUDE_POMEROL_DAVIDSON_HPP
@@ -49,6 +49,8 @@ class DensityMatrixPart : public Thermal {
 
     /// Eigenvalues of the density matrix within this block.
     RealVectorType weights;
+    /// Upper bounds of the statistical weights, \f$\max_{s'\geq s} w_{s'}\f$.
+    RealVectorType MaxWeights;
 
     /// Contribution of this block to the partition function.
     RealType Z_part = 0;
@@ -70,10 +72,17 @@ public:
     /// \param[in] Z The partition function.
     void normalize(RealType Z);
 
-    /// Return a statistical weight \f$w_s\f$.
+    /// Return a statistical weight \f$w_s\f$. Weights of eigenstates that have not been computed
+    /// (see \ref HamiltonianPart::computeLowest()) are zero.
     /// \param[in] s Index of the weight within this block.
     RealType getWeight(InnerQuantumState s) const;
 
+    /// Return the maximal statistical weight among the eigenstates with indices starting from \p s,
+    /// \f$\max_{s'\geq s} w_{s'}\f$. It is a non-increasing function of \p s, which can be used to terminate
+    /// loops over eigenstates once all remaining weights are negligible.
+    /// \param[in] s Index of the first eigenstate within this block.
+    RealType getMaxWeight(InnerQuantumState s = 0) const;
+
     /// Compute the energy averaged over this block, \f$ \langle E\rangle = \sum_{s\in B} E_s w_s\f$.
     RealType getAverageEnergy() const;
 
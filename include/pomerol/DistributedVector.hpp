@@ -0,0 +1,92 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file include/pomerol/DistributedVector.hpp
+/// \brief A vector of complex values distributed over processes of an MPI communicator.
+
+#ifndef POMEROL_INCLUDE_POMEROL_DISTRIBUTEDVECTOR_HPP
+#define POMEROL_INCLUDE_POMEROL_DISTRIBUTEDVECTOR_HPP
+
+#include "Misc.hpp"
+
+#include "mpi_dispatcher/misc.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Pomerol {
+
+/// \addtogroup Misc
+///@{
+
+/// \brief A vector of complex values split into contiguous slices owned by processes of an MPI communicator.
+///
+/// The slice owned by the process of rank \f$r\f$ in a communicator of size \f$P\f$ spans the positions
+/// \f$[\lfloor rN/P \rfloor, \lfloor (r+1)N/P \rfloor)\f$, where \f$N\f$ is the total size of the vector.
+/// Each process stores only its own slice; the whole vector can be assembled on one process by \ref gather().
+class DistributedVector {
+    /// MPI communicator over which the vector is distributed.
+    MPI_Comm Comm;
+    /// Total size of the vector.
+    std::size_t TotalSize = 0;
+    /// Values in the slice owned by the calling process.
+    std::vector<ComplexType> LocalData;
+
+public:
+    /// Construct an empty vector.
+    /// \param[in] comm MPI communicator over which the vector is distributed.
+    ///                 It must remain valid during the lifetime of the vector.
+    explicit DistributedVector(MPI_Comm const& comm = MPI_COMM_WORLD) : Comm(comm) {}
+
+    /// Return the MPI communicator over which the vector is distributed.
+    MPI_Comm const& getComm() const { return Comm; }
+
+    /// Return the total size of the vector.
+    std::size_t size() const { return TotalSize; }
+
+    /// Return the position of the first element of the slice owned by a given process.
+    /// \param[in] Rank Rank of the process in the communicator.
+    std::size_t getOffset(int Rank) const;
+    /// Return the position of the first element of the slice owned by the calling process.
+    std::size_t getOffset() const { return getOffset(pMPI::rank(Comm)); }
+
+    /// Return the size of the slice owned by the calling process.
+    std::size_t getLocalSize() const { return LocalData.size(); }
+    /// Return values in the slice owned by the calling process.
+    std::vector<ComplexType> const& getLocalData() const { return LocalData; }
+    /// Return values in the slice owned by the calling process.
+    std::vector<ComplexType>& getLocalData() { return LocalData; }
+
+    /// Change the total size of the vector. The slice owned by the calling process is resized accordingly
+    /// and filled with zeros.
+    /// \param[in] NewTotalSize New total size of the vector.
+    void resize(std::size_t NewTotalSize);
+
+    /// Sum full-length contributions of all processes and scatter the sums over the slices.
+    /// This is a collective operation.
+    /// \param[in,out] Contributions Contribution of the calling process to all elements of the vector.
+    ///                              It is released after the reduction.
+    /// \pre All processes pass contributions of the same size.
+    void reduceScatter(std::vector<ComplexType>& Contributions);
+
+    /// Assemble the whole vector on one process. This is a collective operation.
+    /// \param[in] Root Rank of the receiving process.
+    /// \return The whole vector on the process \p Root and an empty vector on the other processes.
+    std::vector<ComplexType> gather(int Root = 0) const;
+
+    /// Assemble the whole vector on all processes. This is a collective operation.
+    std::vector<ComplexType> allgather() const;
+};
+
+///@}
+
+} // namespace Pomerol
+
+#endif // #ifndef POMEROL_INCLUDE_POMEROL_DISTRIBUTEDVECTOR_HPP
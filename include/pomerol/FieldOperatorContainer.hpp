@@ -44,6 +44,25 @@ class FieldOperatorContainer {
     std::unordered_map<ParticleIndex, AnnihilationOperator> mapAnnihilationOperators;
 
 public:
+    /// If true, \ref computeAll() makes the parts of each annihilation operator share the sparse matrices with
+    /// the respective parts of the creation operator instead of storing their own copies. This halves
+    /// the memory occupied by the operators; the parts of the annihilation operators are then accessible only
+    /// through the read-only views \ref MonomialOperatorPart::getRowMajorView() and
+    /// \ref MonomialOperatorPart::getColMajorView().
+    bool SharedStorage = false;
+
+    /// If true, \ref computeAll() does not compute any matrices, but defers computation of each part until
+    /// it is accessed for the first time (see \ref MonomialOperatorPart::computeLazily()).
+    /// Parts not used by any correlator, e.g. those connecting blocks discarded by
+    /// \ref DensityMatrix::truncateBlocks(), are then never computed.
+    /// The parts needed by all prepared correlators can also be computed at once by \ref computeRequested().
+    bool Lazy = false;
+
+    /// Parts of the operators, in which the fraction of non-negligible matrix elements exceeds this threshold,
+    /// are stored as dense matrices (see \ref MonomialOperatorPart::compute()). Correlators use faster
+    /// dense kernels for such parts. The default value 1 means that all parts are stored sparsely.
+    RealType DenseFillThreshold = 1;
+
     /// Constructor.
     /// \tparam IndexTypes Types of indices carried by the creation and annihilation operators.
     /// \param[in] IndexInfo Map for fermionic operator index tuples.
@@ -79,11 +98,21 @@ public:
             C.second.prepare(HS);
     }
 
-    /// Compute all stored creation and annihilation operators.
+    /// Compute all stored creation and annihilation operators. Parts of all creation operators are distributed
+    /// over processes of \p comm at once, and the annihilation operators are obtained by the Hermitian conjugation.
     /// \param[in] Tolerance Matrix elements with the absolute value equal or below this threshold
     ///                      are considered negligible.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
     /// \pre \ref prepareAll() has been called.
-    void computeAll(RealType Tolerance = 1e-8);
+    void computeAll(RealType Tolerance = 1e-8, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// Compute all pending parts marked as needed by the prepared correlators (see
+    /// \ref MonomialOperatorPart::request()). The parts are distributed over processes of \p comm
+    /// in the same way as in \ref computeAll(). This is a collective operation.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \pre \ref computeAll() has been called with \ref Lazy set to true, and the correlators using
+    ///      the operators have been prepared on all processes of \p comm.
+    void computeRequested(MPI_Comm const& comm = MPI_COMM_WORLD);
 
     /// Return a reference to a creation operator by its single-particle index.
     /// \param[in] in Single-particle index.
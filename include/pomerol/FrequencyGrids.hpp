@@ -0,0 +1,305 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file include/pomerol/FrequencyGrids.hpp
+/// \brief Structured grids of Matsubara frequencies used to precompute
+/// values of two-particle Green's functions and 3-point susceptibilities,
+/// and reduction of frequency lists by symmetry relations.
+
+#ifndef POMEROL_INCLUDE_POMEROL_FREQUENCYGRIDS_HPP
+#define POMEROL_INCLUDE_POMEROL_FREQUENCYGRIDS_HPP
+
+#include "Misc.hpp"
+
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace Pomerol {
+
+/// \addtogroup Misc
+///@{
+
+/// Triplet of fermionic Matsubara frequency indices \f$(n_1, n_2, n_3)\f$, \f$\omega_{n}=\pi(2n+1)/\beta\f$.
+using MatsubaraTriplet = std::array<long, 3>;
+/// Duplet of fermionic Matsubara frequency indices \f$(n_1, n_2)\f$, \f$\omega_{n}=\pi(2n+1)/\beta\f$.
+using MatsubaraDuplet = std::array<long, 2>;
+
+/// \brief Contiguous range of Matsubara frequency indices.
+///
+/// The range includes indices \f$n = \mathrm{Begin}, \mathrm{Begin}+1, \ldots, \mathrm{End}-1\f$.
+/// Whether the indices refer to fermionic (\f$\omega_n = \pi(2n+1)/\beta\f$) or
+/// bosonic (\f$\Omega_n = 2\pi n/\beta\f$) frequencies is determined by the grid using the range.
+struct MatsubaraRange {
+    /// First index in the range.
+    long Begin;
+    /// Index past the last one in the range.
+    long End;
+
+    /// Constructor.
+    /// \param[in] Begin First index in the range.
+    /// \param[in] End Index past the last one in the range.
+    MatsubaraRange(long Begin, long End) : Begin(Begin), End(End) {
+        if(End < Begin)
+            throw std::invalid_argument("MatsubaraRange: End must not precede Begin");
+    }
+
+    /// Number of indices in the range.
+    std::size_t size() const { return static_cast<std::size_t>(End - Begin); }
+
+    /// Return the i-th index in the range.
+    /// \param[in] i Position within the range.
+    long operator[](std::size_t i) const { return Begin + static_cast<long>(i); }
+
+    /// Does the range include a given index?
+    /// \param[in] n Index.
+    bool contains(long n) const { return n >= Begin && n < End; }
+};
+
+/// \brief Grid of Matsubara frequency triplets for the two-particle Green's function.
+///
+/// The grid is a direct product of a bosonic range \f$\Omega_m\f$ and two fermionic
+/// ranges \f$\nu_n\f$, \f$\nu'_{n'}\f$. The frequencies \f$(\omega_1, \omega_2, \omega_3)\f$
+/// of \f$\chi(\omega_1, \omega_2; \omega_3, \omega_1+\omega_2-\omega_3)\f$ are defined by the channel.
+/// \li Particle-hole channel: \f$(\omega_1, \omega_2, \omega_3) = (\nu+\Omega, \nu', \nu)\f$.
+/// \li Particle-particle channel: \f$(\omega_1, \omega_2, \omega_3) = (\nu, \Omega-\nu, \nu')\f$.
+/// \li Crossed particle-hole channel: \f$(\omega_1, \omega_2, \omega_3) = (\nu+\Omega, \nu', \nu'+\Omega)\f$.
+///
+/// Values on the grid are stored in a dense row-major tensor of shape
+/// \f$N_\Omega \times N_\nu \times N_{\nu'}\f$, with \f$\nu'\f$ being the fastest running index.
+class FreqGrid3 {
+    /// Channel defining the frequency convention.
+    Channel channel;
+    /// Bosonic range \f$\Omega_m\f$.
+    MatsubaraRange W;
+    /// First fermionic range \f$\nu_n\f$.
+    MatsubaraRange Nu;
+    /// Second fermionic range \f$\nu'_{n'}\f$.
+    MatsubaraRange NuPrime;
+
+public:
+    /// Constructor.
+    /// \param[in] channel Channel defining the frequency convention.
+    /// \param[in] W Range of bosonic indices \f$m\f$.
+    /// \param[in] Nu Range of fermionic indices \f$n\f$.
+    /// \param[in] NuPrime Range of fermionic indices \f$n'\f$.
+    FreqGrid3(Channel channel, MatsubaraRange const& W, MatsubaraRange const& Nu, MatsubaraRange const& NuPrime)
+        : channel(channel), W(W), Nu(Nu), NuPrime(NuPrime) {}
+
+    /// Channel defining the frequency convention.
+    Channel getChannel() const { return channel; }
+
+    /// Shape of the dense tensor \f$(N_\Omega, N_\nu, N_{\nu'})\f$.
+    std::array<std::size_t, 3> shape() const { return {W.size(), Nu.size(), NuPrime.size()}; }
+
+    /// Total number of frequency triplets in the grid.
+    std::size_t size() const { return W.size() * Nu.size() * NuPrime.size(); }
+
+    /// Position of a grid point in the dense tensor.
+    /// \param[in] iW Position within the bosonic range.
+    /// \param[in] iNu Position within the first fermionic range.
+    /// \param[in] iNuPrime Position within the second fermionic range.
+    std::size_t index(std::size_t iW, std::size_t iNu, std::size_t iNuPrime) const {
+        return (iW * Nu.size() + iNu) * NuPrime.size() + iNuPrime;
+    }
+
+    /// Return Matsubara indices \f$(n_1, n_2, n_3)\f$ of \f$(\omega_1, \omega_2, \omega_3)\f$
+    /// at a given position in the dense tensor.
+    /// \param[in] k Position in the dense tensor.
+    MatsubaraTriplet operator[](std::size_t k) const {
+        long m = W[k / (Nu.size() * NuPrime.size())];
+        long n = Nu[(k / NuPrime.size()) % Nu.size()];
+        long np = NuPrime[k % NuPrime.size()];
+        switch(channel) {
+        case PP: return {n, m - n - 1, np};
+        case xPH: return {n + m, np, np + m};
+        default: return {n + m, np, n};
+        }
+    }
+
+    /// Find the position of a triplet of Matsubara indices \f$(n_1, n_2, n_3)\f$ in the dense tensor.
+    /// \param[in] n Matsubara indices \f$(n_1, n_2, n_3)\f$.
+    /// \param[out] k Position in the dense tensor.
+    /// \return false if the triplet does not belong to the grid.
+    bool find(MatsubaraTriplet const& n, std::size_t& k) const {
+        long m, nu, np;
+        switch(channel) {
+        case PP:
+            m = n[0] + n[1] + 1;
+            nu = n[0];
+            np = n[2];
+            break;
+        case xPH:
+            m = n[2] - n[1];
+            nu = n[0] - m;
+            np = n[1];
+            break;
+        default:
+            m = n[0] - n[2];
+            nu = n[2];
+            np = n[1];
+        }
+        if(!W.contains(m) || !Nu.contains(nu) || !NuPrime.contains(np))
+            return false;
+        k = index(static_cast<std::size_t>(m - W.Begin),
+                  static_cast<std::size_t>(nu - Nu.Begin),
+                  static_cast<std::size_t>(np - NuPrime.Begin));
+        return true;
+    }
+};
+
+/// \brief Grid of fermionic Matsubara frequency duplets for the 3-point susceptibility.
+///
+/// The grid is a direct product of two fermionic ranges \f$\omega_{n_1}\f$, \f$\omega_{n_2}\f$.
+/// Values on the grid are stored in a dense row-major matrix of shape \f$N_1 \times N_2\f$.
+class FreqGrid2 {
+    /// Range of the first fermionic frequency.
+    MatsubaraRange Nu1;
+    /// Range of the second fermionic frequency.
+    MatsubaraRange Nu2;
+
+public:
+    /// Constructor.
+    /// \param[in] Nu1 Range of fermionic indices \f$n_1\f$.
+    /// \param[in] Nu2 Range of fermionic indices \f$n_2\f$.
+    FreqGrid2(MatsubaraRange const& Nu1, MatsubaraRange const& Nu2) : Nu1(Nu1), Nu2(Nu2) {}
+
+    /// Shape of the dense matrix \f$(N_1, N_2)\f$.
+    std::array<std::size_t, 2> shape() const { return {Nu1.size(), Nu2.size()}; }
+
+    /// Total number of frequency duplets in the grid.
+    std::size_t size() const { return Nu1.size() * Nu2.size(); }
+
+    /// Position of a grid point in the dense matrix.
+    /// \param[in] i1 Position within the first fermionic range.
+    /// \param[in] i2 Position within the second fermionic range.
+    std::size_t index(std::size_t i1, std::size_t i2) const { return i1 * Nu2.size() + i2; }
+
+    /// Return Matsubara indices \f$(n_1, n_2)\f$ at a given position in the dense matrix.
+    /// \param[in] k Position in the dense matrix.
+    MatsubaraDuplet operator[](std::size_t k) const { return {Nu1[k / Nu2.size()], Nu2[k % Nu2.size()]}; }
+};
+
+/// Find the index \f$n\f$ of a fermionic Matsubara frequency \f$i\omega_n = i\pi(2n+1)/\beta\f$.
+/// \param[in] z Complex frequency.
+/// \param[in] beta Inverse temperature \f$\beta\f$.
+/// \param[out] n Index of the Matsubara frequency.
+/// \return false if \p z is not a fermionic Matsubara frequency.
+inline bool getMatsubaraIndex(ComplexType z, RealType beta, long& n) {
+    RealType const Spacing = M_PI / beta;
+    n = std::lround((z.imag() / Spacing - 1) / 2);
+    return std::abs(z - ComplexType(0, Spacing * RealType(2 * n + 1))) <= 1e-10 * Spacing;
+}
+
+/// \brief Reduction of a list of Matsubara index tuples to an irreducible subset.
+///
+/// Values of a function \f$f\f$ at some of the index tuples are related by exact symmetry relations
+/// of the form \f$f(M(n)) = s f(n)\f$ or \f$f(M(n)) = s f(n)^*\f$, \f$s = \pm 1\f$.
+/// Each tuple in the list is either included in the irreducible subset or is obtained from an irreducible
+/// tuple by a sequence of the relations. The function only needs to be evaluated on the irreducible subset.
+/// \tparam IndexTuple Type of the index tuples, \ref MatsubaraTriplet or \ref MatsubaraDuplet.
+template <typename IndexTuple> class FrequencySymmetryReduction {
+public:
+    /// \brief Symmetry relation \f$f(M(n)) = s f(n)\f$ or \f$f(M(n)) = s f(n)^*\f$.
+    ///
+    /// The mapping \f$M\f$ must be an involution or generate a finite group together with other relations.
+    struct Relation {
+        /// Mapping of index tuples \f$M\f$.
+        std::function<IndexTuple(IndexTuple const&)> Map;
+        /// Sign \f$s\f$.
+        int Sign;
+        /// Is the value complex conjugated?
+        bool Conjugate;
+    };
+
+private:
+    /// Irreducible index tuples.
+    std::vector<IndexTuple> Irreducible;
+    /// Position of the irreducible tuple related to each tuple of the original list.
+    std::vector<std::size_t> Source;
+    /// Sign relating each tuple of the original list to its irreducible tuple.
+    std::vector<int> Signs;
+    /// Is the value at each tuple of the original list complex conjugated?
+    std::vector<bool> Conjugate;
+
+public:
+    /// Constructor.
+    /// \param[in] Points List of index tuples.
+    /// \param[in] Relations Symmetry relations between values at different index tuples.
+    FrequencySymmetryReduction(std::vector<IndexTuple> const& Points, std::vector<Relation> const& Relations)
+        : Source(Points.size()), Signs(Points.size()), Conjugate(Points.size()) {
+        std::map<IndexTuple, std::vector<std::size_t>> Positions;
+        for(std::size_t w = 0; w < Points.size(); ++w)
+            Positions[Points[w]].push_back(w);
+
+        std::vector<bool> Assigned(Points.size(), false);
+        for(std::size_t w = 0; w < Points.size(); ++w) {
+            if(Assigned[w])
+                continue;
+            std::size_t r = Irreducible.size();
+            Irreducible.push_back(Points[w]);
+
+            // Visit the orbit of Points[w] and relate all listed tuples in it to Points[w]
+            struct OrbitPoint {
+                IndexTuple Point;
+                int Sign;
+                bool Conjugate;
+            };
+            std::set<IndexTuple> Visited = {Points[w]};
+            std::vector<OrbitPoint> Queue = {{Points[w], 1, false}};
+            while(!Queue.empty()) {
+                OrbitPoint Current = Queue.back();
+                Queue.pop_back();
+                auto It = Positions.find(Current.Point);
+                if(It != Positions.end()) {
+                    for(std::size_t v : It->second) {
+                        if(Assigned[v])
+                            continue;
+                        Assigned[v] = true;
+                        Source[v] = r;
+                        Signs[v] = Current.Sign;
+                        Conjugate[v] = Current.Conjugate;
+                    }
+                }
+                for(auto const& R : Relations) {
+                    IndexTuple Image = R.Map(Current.Point);
+                    if(Visited.insert(Image).second)
+                        Queue.push_back({Image, Current.Sign * R.Sign, Current.Conjugate != R.Conjugate});
+                }
+            }
+        }
+    }
+
+    /// Irreducible index tuples.
+    std::vector<IndexTuple> const& getIrreducible() const { return Irreducible; }
+
+    /// Restore values at all tuples of the original list from the values at the irreducible tuples.
+    /// \param[in] IrreducibleValues Values at the tuples returned by \ref getIrreducible().
+    std::vector<ComplexType> expand(std::vector<ComplexType> const& IrreducibleValues) const {
+        std::vector<ComplexType> Values(Source.size());
+        for(std::size_t w = 0; w < Source.size(); ++w) {
+            ComplexType Value = IrreducibleValues[Source[w]];
+            Values[w] = RealType(Signs[w]) * (Conjugate[w] ? std::conj(Value) : Value);
+        }
+        return Values;
+    }
+};
+
+///@}
+
+} // namespace Pomerol
+
+#endif // #ifndef POMEROL_INCLUDE_POMEROL_FREQUENCYGRIDS_HPP
@@ -203,6 +203,7 @@ public:
 private:
     /// Implementation details.
     template <bool Complex> void computeImpl();
+    template <bool Complex> void computeDenseImpl();
 };
 
 ///@}
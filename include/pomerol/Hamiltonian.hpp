@@ -26,6 +26,7 @@
 #include "mpi_dispatcher/misc.hpp"
 
 #include <cmath>
+#include <memory>
 #include <type_traits>
 #include <vector>
 
@@ -54,10 +55,22 @@ class Hamiltonian : public ComputableObject {
     /// The ground state energy.
     RealType GroundEnergy = -HUGE_VAL;
 
+    /// The type-erased real/complex-valued \p libcommute::loperator object, kept alive for
+    /// parts with \ref HamiltonianPart::MatrixFreeStorage.
+    std::shared_ptr<void> HOp = nullptr;
+
 public:
+    /// If true, eigenvectors of each diagonal block are stored only by the MPI process that has
+    /// diagonalized the block. The other processes fetch them on demand using one-sided MPI communication
+    /// (see \ref HamiltonianPart::fetchMatrix()). Eigenvalues are always available to all processes.
+    bool DistributedEigenvectors = false;
+
     /// Constructor.
     /// \param[in] S Information about invariant subspaces of the Hamiltonian.
     explicit Hamiltonian(StatesClassification const& S) : S(S) {}
+    /// Destructor. It is collective over the MPI communicator used in \ref compute()
+    /// if \ref DistributedEigenvectors is set.
+    ~Hamiltonian();
 
     /// Fill matrices of all diagonal blocks in parallel.
     /// \tparam ScalarType Scalar type (either double or std::complex<double>) of the expression \p H.
@@ -65,21 +78,45 @@ public:
     /// \param[in] H Expression of the Hamiltonian.
     /// \param[in] HS Hilbert space.
     /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[in] Storage Storage format of the diagonal blocks. Sparse and matrix-free blocks can
+    ///                    only be fully diagonalized after conversion to dense matrices, so these formats
+    ///                    are meant to be used together with \ref computeLowest().
     template <typename ScalarType, typename... IndexTypes>
     void prepare(Operators::expression<ScalarType, IndexTypes...> const& H,
                  HilbertSpace<IndexTypes...> const& HS,
-                 MPI_Comm const& comm = MPI_COMM_WORLD);
+                 MPI_Comm const& comm = MPI_COMM_WORLD,
+                 HamiltonianPart::StorageEnum Storage = HamiltonianPart::DenseStorage);
 
     /// Diagonalize matrices of all diagonal blocks in parallel.
     /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[in] EigenvaluesOnly Compute only eigenvalues and free the matrices of the blocks right away.
+    ///                            This is sufficient for thermodynamic quantities (\ref DensityMatrix).
+    ///                            Eigenvectors of a block are computed by the calling process
+    ///                            on first access, e.g. when a \ref MonomialOperator is computed.
+    /// \pre \ref prepare() has been called.
+    void compute(MPI_Comm const& comm = MPI_COMM_WORLD, bool EigenvaluesOnly = false);
+
+    /// Compute only a few lowest eigenpairs in each diagonal block in parallel using the iterative
+    /// block Davidson method (see \ref HamiltonianPart::computeLowest()). The resulting parts store
+    /// rectangular eigenvector matrices.
+    /// \param[in] NumEigenvalues Maximal number of eigenpairs to compute per block (0 means no limit).
+    /// \param[in] Cutoff Only eigenpairs with energies not exceeding the ground state energy
+    ///                   plus \p Cutoff are retained.
+    /// \param[in] Tolerance Convergence threshold for norms of the eigenpair residuals.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
     /// \pre \ref prepare() has been called.
-    void compute(MPI_Comm const& comm = MPI_COMM_WORLD);
+    void computeLowest(InnerQuantumState NumEigenvalues,
+                       RealType Cutoff = HUGE_VAL,
+                       RealType Tolerance = 1e-10,
+                       MPI_Comm const& comm = MPI_COMM_WORLD);
 
     /// Discard all eigenvalues exceeding a given cutoff and truncate the size of all diagonalized
     /// blocks accordingly.
     /// \param[in] Cutoff Maximum allowed excitation energy (energy level calculated w.r.t. the ground state energy).
+    /// \param[in] comm MPI communicator used in \ref compute(). This method is collective over \p comm
+    ///                 if \ref DistributedEigenvectors is set.
     /// \pre \ref compute() has been called.
-    void reduce(RealType Cutoff);
+    void reduce(RealType Cutoff, MPI_Comm const& comm = MPI_COMM_WORLD);
 
     /// Is the Hamiltonian a complex-valued matrix?
     bool isComplex() const { return Complex; }
@@ -117,21 +154,30 @@ private:
     void computeGroundEnergy();
 
     // cppcheck-suppress unusedPrivateFunction
-    template <bool C> void prepareImpl(LOperatorTypeRC<C> const& HOp, MPI_Comm const& comm);
-    template <bool C> void computeImpl(MPI_Comm const& comm);
+    template <bool C>
+    void prepareImpl(LOperatorTypeRC<C> const& HOp, MPI_Comm const& comm, HamiltonianPart::StorageEnum Storage);
+    template <bool C>
+    void computeImpl(InnerQuantumState NumEigenvalues,
+                     RealType Cutoff,
+                     RealType Tolerance,
+                     bool EigenvaluesOnly,
+                     MPI_Comm const& comm);
+    template <bool C> void exposeEigenvectors(MPI_Comm const& comm);
 };
 
 template <typename ScalarType, typename... IndexTypes>
 void Hamiltonian::prepare(Operators::expression<ScalarType, IndexTypes...> const& H,
                           HilbertSpace<IndexTypes...> const& HS,
-                          MPI_Comm const& comm) {
+                          MPI_Comm const& comm,
+                          HamiltonianPart::StorageEnum Storage) {
 
     if(getStatus() >= Prepared)
         return;
 
     Complex = std::is_same<ScalarType, ComplexType>::value;
-    LOperatorType<ScalarType> HOp(H, HS.getFullHilbertSpace());
-    prepareImpl<std::is_same<ScalarType, ComplexType>::value>(HOp, comm);
+    auto HOp_ = std::make_shared<LOperatorType<ScalarType>>(H, HS.getFullHilbertSpace());
+    HOp = HOp_;
+    prepareImpl<std::is_same<ScalarType, ComplexType>::value>(*HOp_, comm, Storage);
 
     setStatus(Prepared);
 }
@@ -17,6 +17,7 @@
 #define POMEROL_INCLUDE_POMEROL_HAMILTONIANPART_HPP
 
 #include "ComputableObject.hpp"
+#include "Davidson.hpp"
 #include "IndexClassification.hpp"
 #include "Misc.hpp"
 #include "StatesClassification.hpp"
@@ -24,6 +25,9 @@
 #include <libcommute/algebra_ids.hpp>
 #include <libcommute/loperator/loperator.hpp>
 
+#include <mpi.h>
+
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <type_traits>
@@ -39,6 +43,15 @@ namespace Pomerol {
 /// invariant subspace of the Hamiltonian.
 class HamiltonianPart : public ComputableObject {
 
+public:
+    /// Storage format of the Hamiltonian matrix block before diagonalization.
+    enum StorageEnum {
+        DenseStorage,     ///< Dense matrix.
+        SparseStorage,    ///< Sparse matrix in the compressed row storage (CSR) format.
+        MatrixFreeStorage ///< No matrix is stored, the linear operator is applied to vectors on the fly.
+    };
+
+private:
     /// Information about invariant subspaces of the Hamiltonian.
     StatesClassification const& S;
 
@@ -51,12 +64,37 @@ class HamiltonianPart : public ComputableObject {
     /// A type-erased pointer to the respective real/complex-valued \p libcommute::loperator object.
     void const* HOp;
 
+    /// Storage format of the matrix block before diagonalization.
+    StorageEnum Storage;
+
     /// The type-erased real/complex matrix of this block of the Hamiltonian.
-    std::shared_ptr<void> HMatrix = nullptr;
+    /// It is mutable because eigenvectors can be computed lazily on first access.
+    mutable std::shared_ptr<void> HMatrix = nullptr;
+
+    /// The type-erased real/complex sparse matrix of this block (\ref SparseStorage only).
+    std::shared_ptr<void> HSparseMatrix = nullptr;
+
+    /// The type-erased \p libcommute::basis_mapper object used to apply \ref HOp to vectors within this block.
+    std::shared_ptr<void> Mapper = nullptr;
+
+    /// Diagonal matrix elements of this block (\ref MatrixFreeStorage only).
+    RealVectorType Diagonal;
 
     /// Eigenvalues of this block.
     RealVectorType Eigenvalues;
 
+    /// Whether only eigenvalues have been computed by \ref compute(), so that the eigenvectors
+    /// are to be computed on first access.
+    bool LazyEigenvectors = false;
+
+    /// Rank of the MPI process that has diagonalized this block.
+    int Owner = -1;
+    /// MPI window exposing eigenvectors of all blocks owned by the respective processes
+    /// (distributed storage mode only).
+    std::shared_ptr<MPI_Win> Window = nullptr;
+    /// Address of the eigenvector matrix within \ref Window on the owner process.
+    MPI_Aint RemoteAddress = 0;
+
     friend class Hamiltonian;
 
 public:
@@ -65,16 +103,35 @@ public:
     /// \param[in] HOp The linear operator object corresponding to the Hamiltonian.
     /// \param[in] S Information about invariant subspaces of the Hamiltonian.
     /// \param[in] Block Index of the block (invariant subspace) this part corresponds to.
+    /// \param[in] Storage Storage format of the matrix block before diagonalization.
+    ///            \p HOp must outlive this object if \ref MatrixFreeStorage is selected.
     template <typename ScalarType>
-    HamiltonianPart(LOperatorType<ScalarType> const& HOp, StatesClassification const& S, BlockNumber Block)
-        : S(S), Block(Block), Complex(std::is_same<ScalarType, ComplexType>::value), HOp(&HOp) {}
+    HamiltonianPart(LOperatorType<ScalarType> const& HOp,
+                    StatesClassification const& S,
+                    BlockNumber Block,
+                    StorageEnum Storage = DenseStorage)
+        : S(S), Block(Block), Complex(std::is_same<ScalarType, ComplexType>::value), HOp(&HOp), Storage(Storage) {}
 
-    /// Fill the matrix with elements.
+    /// Fill the matrix with elements. Nothing but the diagonal is computed for \ref MatrixFreeStorage.
     void prepare();
 
     /// Diagonalize the matrix.
+    /// \param[in] EigenvaluesOnly If true, only eigenvalues are computed and the matrix is freed.
+    ///                            The eigenvectors are then computed on first access
+    ///                            (see \ref fetchMatrix()), which requires the linear operator \p HOp
+    ///                            passed to the constructor to be still alive.
+    /// \pre \ref prepare() has been called.
+    void compute(bool EigenvaluesOnly = false);
+
+    /// Compute only a few lowest eigenpairs of the matrix using the iterative block Davidson method.
+    /// After the call the stored matrix becomes rectangular, with columns being the computed eigenvectors.
+    /// Blocks that are too small for the iterative method to pay off are fully diagonalized and truncated.
+    /// \param[in] NumEigenvalues Maximal number of eigenpairs to compute (0 means no limit).
+    /// \param[in] Cutoff Only eigenpairs with energies not exceeding the lowest eigenvalue of this block
+    ///                   plus \p Cutoff are computed.
+    /// \param[in] Tolerance Convergence threshold for norms of the eigenpair residuals.
     /// \pre \ref prepare() has been called.
-    void compute();
+    void computeLowest(InnerQuantumState NumEigenvalues, RealType Cutoff = HUGE_VAL, RealType Tolerance = 1e-10);
 
     /// Discard all eigenvalues exceeding a given cutoff and truncate the size of the diagonalized
     /// matrix accordingly.
@@ -85,12 +142,41 @@ public:
     /// Is this object storing a complex-valued matrix?
     bool isComplex() const { return Complex; }
 
+    /// Return the storage format of the matrix block.
+    StorageEnum getStorage() const { return Storage; }
+
+    /// Act with the matrix block on a block of vectors, \f$Y = H X\f$. Depending on the storage format,
+    /// this method multiplies by the dense or the sparse matrix, or applies the linear operator on the fly.
+    /// In the latter case, OpenMP threads process different columns of \p X or, if there are fewer columns
+    /// than threads, different ranges of basis states.
+    /// \tparam Complex Whether the vectors are complex.
+    /// \param[in] X Block of vectors, one vector per column.
+    /// \param[out] Y Result of the action.
+    /// \pre \ref prepare() has been called, \ref compute() and \ref computeLowest() have not been called.
+    template <bool Complex> void apply(DavidsonBlockType<Complex> const& X, DavidsonBlockType<Complex>& Y) const;
+
+    /// Return a constant reference to the stored sparse matrix of this block.
+    /// \tparam Complex Request a reference to a complex-valued matrix.
+    /// \pre \ref prepare() has been called, the storage format is \ref SparseStorage.
+    template <bool Complex> RowMajorMatrixType<Complex> const& getSparseMatrix() const;
+
     /// Return the index of the block (invariant subspace) this part corresponds to.
     BlockNumber getBlockNumber() const { return Block; }
 
     /// Return dimension of the respective invariant subspace.
     InnerQuantumState getSize() const;
 
+    /// Return the estimated cost of \ref compute(), \f$N^3\f$ where \f$N\f$ is the block size.
+    double estimateCost() const {
+        auto N = static_cast<double>(getSize());
+        return N * N * N;
+    }
+
+    /// Return the number of computed eigenpairs. It is smaller than \ref getSize() if \ref computeLowest()
+    /// or \ref reduce() have been called.
+    /// \pre \ref compute() has been called.
+    InnerQuantumState getNumberOfEigenValues() const;
+
     /// Access eigenvalues of the matrix.
     /// \pre \ref compute() has been called.
     RealVectorType const& getEigenValues() const;
@@ -102,24 +188,49 @@ public:
 
     /// Return a constant reference to the stored matrix. Before \ref compute() has been called,
     /// this matrix is the diagonal block of the Hamiltonian. After the call it becomes a unitary
-    /// matrix, whose columns are eigenvectors of the block.
+    /// matrix, whose columns are eigenvectors of the block. Only the computed eigenvectors
+    /// are stored after a call to \ref computeLowest() or \ref reduce().
     /// \tparam Complex Request a reference to a complex-valued matrix.
     /// \pre \ref prepare() has been called.
     /// \pre The compile-time value of \p Complex must agree with the result of \ref isComplex().
     template <bool Complex> MatrixType<Complex> const& getMatrix() const;
     /// Return a reference to the stored matrix. Before \ref compute() has been called,
     /// this matrix is the diagonal block of the Hamiltonian. After the call it becomes a unitary
-    /// matrix, whose columns are eigenvectors of the block.
+    /// matrix, whose columns are eigenvectors of the block. Only the computed eigenvectors
+    /// are stored after a call to \ref computeLowest() or \ref reduce().
     /// \tparam Complex Request a reference to a complex-valued matrix.
     /// \pre \ref prepare() has been called.
     /// \pre The compile-time value of \p Complex must agree with the result of \ref isComplex().
     template <bool Complex> MatrixType<Complex>& getMatrix();
 
+    /// Does this process store eigenvectors of the block? This is always true unless the eigenvectors are
+    /// stored in the distributed mode (\ref Hamiltonian::DistributedEigenvectors) and the block has been
+    /// diagonalized by another process.
+    /// \pre \ref compute() has been called.
+    bool hasLocalEigenvectors() const { return static_cast<bool>(HMatrix); }
+
+    /// Return rank of the MPI process that has diagonalized this block.
+    /// \pre \ref compute() has been called.
+    int getOwner() const { return Owner; }
+
+    /// Are eigenvectors of the blocks distributed over processes (\ref Hamiltonian::DistributedEigenvectors)?
+    /// \pre \ref compute() has been called.
+    bool hasDistributedEigenvectors() const { return static_cast<bool>(Window); }
+
+    /// Return a shared pointer to the matrix of eigenvectors. If only eigenvalues have been computed,
+    /// the eigenvectors are computed and stored by this call. If the eigenvectors are stored on another process,
+    /// they are fetched from it using one-sided MPI communication and the returned object owns the fetched copy.
+    /// Otherwise, the returned pointer shares ownership of the stored matrix.
+    /// \tparam Complex Request a pointer to a complex-valued matrix.
+    /// \pre \ref compute() has been called.
+    /// \pre The compile-time value of \p Complex must agree with the result of \ref isComplex().
+    template <bool Complex> std::shared_ptr<MatrixType<Complex> const> fetchMatrix() const;
+
     /// Return the lowest eigenvalue.
     /// \pre \ref compute() has been called.
     RealType getMinimumEigenvalue() const;
 
-    /// Return a single eigenstate.
+    /// Return a single eigenstate. The eigenvectors are fetched from the owner process if necessary.
     /// \tparam Complex Request a reference to a complex-valued eigenvector.
     /// \param[in] State Index of the eigenstate.
     /// \pre The compile-time value of \p Complex must agree with the result of \ref isComplex().
@@ -130,6 +241,15 @@ public:
     /// \param[in] part HamiltonianPart to be inserted.
     /// \return Reference to the output stream.
     friend std::ostream& operator<<(std::ostream& os, HamiltonianPart const& part) {
+        if(!part.HMatrix) {
+            if(part.HSparseMatrix) {
+                if(part.isComplex())
+                    os << part.getSparseMatrix<true>() << '\n';
+                else
+                    os << part.getSparseMatrix<false>() << '\n';
+            }
+            return os;
+        }
         if(part.isComplex())
             os << part.getMatrix<true>() << '\n';
         else
@@ -142,7 +262,16 @@ private:
     // Implementation details
     template <bool C> void initHMatrix();
     template <bool C> void prepareImpl();
-    template <bool C> void computeImpl();
+    template <bool C> void prepareSparseImpl();
+    template <bool C> void makeDense();
+    template <bool C> RealVectorType getDiagonal() const;
+    template <bool C, typename F> void foreachElement(F&& f) const;
+    void initMapper();
+    void releaseStorage();
+    template <bool C> void computeImpl(bool EigenvaluesOnly);
+    template <bool C> void computeEigenvectorsImpl() const;
+    template <bool C> void computeLowestImpl(InnerQuantumState NumEigenvalues, RealType Cutoff, RealType Tolerance);
+    template <bool C> void truncateImpl(Eigen::Index NumEigenvalues);
 
     void checkComputed() const;
 };
@@ -18,10 +18,12 @@
 
 #include "Index.hpp"
 #include "IndexClassification.hpp"
+#include "SymmetryAnalyzer.hpp"
 
 #include <map>
 #include <memory>
 #include <set>
+#include <stdexcept>
 #include <utility>
 
 namespace Pomerol {
@@ -44,6 +46,9 @@ protected:
     /// Stored elements are created by calling Source.createElement(Indices).
     SourceObject const& Source;
 
+    /// Symmetries of the Hamiltonian used to identify equivalent index combinations.
+    SymmetryAnalyzer Symmetries;
+
     /// Generate a complete set of index combinations usable to address
     /// elements in the container.
     std::set<IndexCombination2> enumerateIndices() const;
@@ -70,6 +75,17 @@ public:
     /// \return Reference to the created element.
     ElementType& create(IndexCombination2 const& Indices);
 
+    /// \brief Set symmetries of the Hamiltonian to be used by subsequent calls to \ref fill() and \ref create().
+    ///
+    /// A newly created element is also stored under all index combinations \f$(P(i),P(j))\f$,
+    /// where \f$P\f$ runs over the symmetry group, so that only one element per equivalence class is computed.
+    /// \param[in] Symmetries Symmetry group of the Hamiltonian.
+    void setSymmetries(SymmetryAnalyzer const& Symmetries) {
+        if(!Symmetries.isTrivial() && Symmetries.getNumIndices() != NumIndices)
+            throw std::runtime_error("IndexContainer2: Symmetries are defined for a different number of indices");
+        this->Symmetries = Symmetries;
+    }
+
     /// Check if an element for a given index combination is stored in the container.
     /// \param[in] Indices Index combination.
     bool isInContainer(IndexCombination2 const& Indices) const;
@@ -104,11 +120,6 @@ bool IndexContainer2<ElementType, SourceObject>::isInContainer(ParticleIndex Ind
 
 template <typename ElementType, typename SourceObject>
 void IndexContainer2<ElementType, SourceObject>::fill(std::set<IndexCombination2> Indices) {
-    // TODO: this method should use symmetry information
-    // Indices should be split into equivalence classes with
-    // the equivalence relation provided by a symmetry analyzer
-    // The resulting classes may be extended afterwards (optionally)
-
     // remove existing elements
     ElementsMap.clear();
 
@@ -131,6 +142,12 @@ ElementType& IndexContainer2<ElementType, SourceObject>::create(IndexCombination
                                              "added an element with indices "
                                           << Indices << " (" << pElement << ").");
 
+    // Index combinations related to Indices by a symmetry of the Hamiltonian
+    for(auto const& EquivalentIndices : Symmetries.getOrbit(Indices)) {
+        if(!isInContainer(EquivalentIndices))
+            ElementsMap[EquivalentIndices] = pElement;
+    }
+
     return *pElement;
 }
 
@@ -18,10 +18,12 @@
 
 #include "Index.hpp"
 #include "IndexClassification.hpp"
+#include "SymmetryAnalyzer.hpp"
 
 #include <map>
 #include <memory>
 #include <set>
+#include <stdexcept>
 #include <utility>
 
 namespace Pomerol {
@@ -80,6 +82,15 @@ protected:
     /// Sparse storage for the plain (non-decorated) elements.
     std::map<IndexCombination4, std::shared_ptr<ElementType>> NonTrivialElements;
 
+    /// Symmetries of the Hamiltonian used to identify equivalent index combinations.
+    SymmetryAnalyzer Symmetries;
+
+    /// Store a decorated element under a given index combination as well as under the index combinations
+    /// obtained by swapping the first two and/or the last two indices.
+    /// \param[in] Indices Index combination.
+    /// \param[in] pElement The element to be stored.
+    void addElement(IndexCombination4 const& Indices, std::shared_ptr<ElementType> const& pElement);
+
 public:
     /// Construct from a source object and an index classification object.
     /// The container is initially empty and shall be populated with elements
@@ -102,6 +113,17 @@ public:
     /// \return Reference to the created element.
     ElementWithPermFreq<ElementType>& create(IndexCombination4 const& Indices);
 
+    /// \brief Set symmetries of the Hamiltonian to be used by subsequent calls to \ref fill() and \ref create().
+    ///
+    /// A newly created element is also stored under all index combinations \f$(P(i),P(j),P(k),P(l))\f$,
+    /// where \f$P\f$ runs over the symmetry group, so that only one element per equivalence class is computed.
+    /// \param[in] Symmetries Symmetry group of the Hamiltonian.
+    void setSymmetries(SymmetryAnalyzer const& Symmetries) {
+        if(!Symmetries.isTrivial() && Symmetries.getNumIndices() != NumIndices)
+            throw std::runtime_error("IndexContainer4: Symmetries are defined for a different number of indices");
+        this->Symmetries = Symmetries;
+    }
+
     /// Check if an element for a given index combination is stored in the container.
     /// \param[in] Indices Index combination.
     bool isInContainer(IndexCombination4 const& Indices) const;
@@ -170,11 +192,6 @@ inline bool IndexContainer4<ElementType, SourceObject>::isInContainer(ParticleIn
 
 template <typename ElementType, typename SourceObject>
 inline void IndexContainer4<ElementType, SourceObject>::fill(std::set<IndexCombination4> Indices) {
-    // TODO: this method should use symmetry information
-    // Indices should be split into equivalence classes with
-    // the equivalence relation provided by a symmetry analyzer
-    // The resulting classes may be extended afterwards (optionally)
-
     // remove existing elements
     ElementsMap.clear();
 
@@ -191,7 +208,22 @@ template <typename ElementType, typename SourceObject>
 inline ElementWithPermFreq<ElementType>&
 IndexContainer4<ElementType, SourceObject>::create(IndexCombination4 const& Indices) {
     std::shared_ptr<ElementType> pElement(Source.createElement(Indices));
-    auto iter = ElementsMap.emplace(Indices, ElementWithPermFreq<ElementType>(pElement, permutations4[0])).first;
+    NonTrivialElements.emplace(Indices, pElement);
+    addElement(Indices, pElement);
+
+    // Index combinations related to Indices by a symmetry of the Hamiltonian
+    for(auto const& EquivalentIndices : Symmetries.getOrbit(Indices)) {
+        if(!isInContainer(EquivalentIndices))
+            addElement(EquivalentIndices, pElement);
+    }
+
+    return ElementsMap.find(Indices)->second;
+}
+
+template <typename ElementType, typename SourceObject>
+inline void IndexContainer4<ElementType, SourceObject>::addElement(IndexCombination4 const& Indices,
+                                                                   std::shared_ptr<ElementType> const& pElement) {
+    ElementsMap.emplace(Indices, ElementWithPermFreq<ElementType>(pElement, permutations4[0]));
 
     DEBUG("IndexContainer4::fill() at " << this << ": "
                                         << "added an element with indices " << Indices << " and frequency permutation "
@@ -200,8 +232,6 @@ IndexContainer4<ElementType, SourceObject>::create(IndexCombination4 const& Indi
     bool SameCIndices = (Indices.Index1 == Indices.Index2);
     bool SameCXIndices = (Indices.Index3 == Indices.Index4);
 
-    NonTrivialElements.emplace(Indices, pElement);
-
     if(!SameCIndices) {
         IndexCombination4 Indices2134(Indices.Index2, Indices.Index1, Indices.Index3, Indices.Index4);
         if(!isInContainer(Indices2134)) {
@@ -232,8 +262,6 @@ IndexContainer4<ElementType, SourceObject>::create(IndexCombination4 const& Indi
                                                 << ").");
         }
     }
-
-    return iter->second;
 }
 
 template <typename ElementType, typename SourceObject>
@@ -17,9 +17,11 @@
 #ifndef POMEROL_INCLUDE_POMEROL_MATSUBARACONTAINERS_HPP
 #define POMEROL_INCLUDE_POMEROL_MATSUBARACONTAINERS_HPP
 
+#include "FrequencyGrids.hpp"
 #include "Misc.hpp"
 
 #include <cmath>
+#include <cstddef>
 #include <vector>
 
 namespace Pomerol {
@@ -49,6 +51,20 @@ template <typename SourceObject> class MatsubaraContainer4 {
     /// one offsets per bosonic frequency.
     std::vector<long> FermionicIndexOffset;
 
+    /// Allocate storage for a given number of Matsubara frequencies.
+    /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
+    ///            \f$\omega_1\f$ and \f$\omega_2\f$ for which values are stored.
+    void resize(long NumberOfMatsubaras);
+
+    /// Call a function for each stored element.
+    /// Elements for different bosonic frequencies are visited in parallel by OpenMP threads.
+    /// \tparam F Type of the function object.
+    /// \param[in] f Function object called as
+    ///              f(Value, Position, MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3),
+    ///              where Value is a reference to the stored element and Position is its serial number
+    ///              in the order of increasing bosonic frequency, \f$\nu\f$ and \f$\nu'\f$.
+    template <typename F> void forEachElement(F const& f);
+
 public:
     /// Construct from a source function object.
     /// The container is initially empty and shall be populated with values
@@ -66,10 +82,23 @@ public:
 
     /// Fill the container with precomputed values from the source function object.
     /// Each value is created by calling Source.value(MatsubaraNumber1,MatsubaraNumber2,MatsubaraNumber3).
+    /// Values for different bosonic frequencies are computed in parallel by OpenMP threads,
+    /// so Source.value() must be safe to call concurrently.
     /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
     ///            \f$\omega_1\f$ and \f$\omega_2\f$ for which values are precomputed and stored.
     void fill(long NumberOfMatsubaras);
 
+    /// Fill the container with precomputed values obtained from a function that computes all of them at once.
+    /// This is useful when the values are computed by a collective operation. The list of triplets is built and
+    /// the returned values are stored in parallel over bosonic frequencies by OpenMP threads.
+    /// \tparam BatchFunc Type of the function object.
+    /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
+    ///            \f$\omega_1\f$ and \f$\omega_2\f$ for which values are precomputed and stored.
+    /// \param[in] BatchValues Function object called once as BatchValues(Indices), where Indices is the list of
+    ///                        all stored Matsubara index triplets \f$(n_1,n_2,n_3)\f$. It must return the list of
+    ///                        values at these triplets.
+    template <typename BatchFunc> void fill(long NumberOfMatsubaras, BatchFunc const& BatchValues);
+
     /// Get the number of positive fermionic Matsubara frequencies \f$\omega_1\f$ and \f$\omega_2\f$
     /// for which values are precomputed and stored.
     long getNumberOfMatsubaras() const { return NumberOfMatsubaras; }
@@ -77,7 +106,7 @@ public:
 
 ///@}
 
-template <typename SourceObject> inline void MatsubaraContainer4<SourceObject>::fill(long NumberOfMatsubaras) {
+template <typename SourceObject> inline void MatsubaraContainer4<SourceObject>::resize(long NumberOfMatsubaras) {
     this->NumberOfMatsubaras = NumberOfMatsubaras;
 
     if(NumberOfMatsubaras == 0) {
@@ -95,18 +124,71 @@ template <typename SourceObject> inline void MatsubaraContainer4<SourceObject>::
         long FermionicMatrixSize = 2 * NumberOfMatsubaras - std::abs(BosonicIndex + 1);
         Values[BosonicIndexV].resize(FermionicMatrixSize, FermionicMatrixSize);
         FermionicIndexOffset[BosonicIndexV] = (BosonicIndex < 0 ? 0 : BosonicIndex + 1) - NumberOfMatsubaras;
+    }
+}
 
-        for(long NuIndexM = 0; NuIndexM < FermionicMatrixSize; ++NuIndexM)
-            for(long NupIndexM = 0; NupIndexM < FermionicMatrixSize; ++NupIndexM) {
+template <typename SourceObject>
+template <typename F>
+inline void MatsubaraContainer4<SourceObject>::forEachElement(F const& f) {
+    // Serial number of the first element stored for each bosonic frequency
+    long NumBosonic = static_cast<long>(Values.size());
+    std::vector<std::size_t> FirstPosition(Values.size() + 1, 0);
+    for(std::size_t BosonicIndexV = 0; BosonicIndexV < Values.size(); ++BosonicIndexV)
+        FirstPosition[BosonicIndexV + 1] = FirstPosition[BosonicIndexV] + Values[BosonicIndexV].size();
+
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(long BosonicIndexV = 0; BosonicIndexV < NumBosonic; ++BosonicIndexV) {
+        long BosonicIndex = BosonicIndexV - 2 * NumberOfMatsubaras;
+        std::size_t Position = FirstPosition[BosonicIndexV];
+        for(long NuIndexM = 0; NuIndexM < Values[BosonicIndexV].rows(); ++NuIndexM)
+            for(long NupIndexM = 0; NupIndexM < Values[BosonicIndexV].cols(); ++NupIndexM) {
                 long MatsubaraNumber1 = NuIndexM + FermionicIndexOffset[BosonicIndexV];
                 long MatsubaraNumber2 = BosonicIndex - MatsubaraNumber1;
                 long MatsubaraNumber3 = NupIndexM + FermionicIndexOffset[BosonicIndexV];
-                Values[BosonicIndexV](NuIndexM, NupIndexM) =
-                    Source.value(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3);
+                f(Values[BosonicIndexV](NuIndexM, NupIndexM),
+                  Position++,
+                  MatsubaraNumber1,
+                  MatsubaraNumber2,
+                  MatsubaraNumber3);
             }
     }
 }
 
+template <typename SourceObject> inline void MatsubaraContainer4<SourceObject>::fill(long NumberOfMatsubaras) {
+    resize(NumberOfMatsubaras);
+    forEachElement([this](ComplexType& Value,
+                          std::size_t,
+                          long MatsubaraNumber1,
+                          long MatsubaraNumber2,
+                          long MatsubaraNumber3) {
+        Value = Source.value(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3);
+    });
+}
+
+template <typename SourceObject>
+template <typename BatchFunc>
+inline void MatsubaraContainer4<SourceObject>::fill(long NumberOfMatsubaras, BatchFunc const& BatchValues) {
+    resize(NumberOfMatsubaras);
+
+    std::size_t Size = 0;
+    for(auto const& V : Values)
+        Size += static_cast<std::size_t>(V.size());
+
+    std::vector<MatsubaraTriplet> Indices(Size);
+    forEachElement([&Indices](ComplexType&,
+                              std::size_t Position,
+                              long MatsubaraNumber1,
+                              long MatsubaraNumber2,
+                              long MatsubaraNumber3) {
+        Indices[Position] = {MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3};
+    });
+    std::vector<ComplexType> Data = BatchValues(Indices);
+
+    forEachElement([&Data](ComplexType& Value, std::size_t Position, long, long, long) { Value = Data[Position]; });
+}
+
 template <typename SourceObject>
 inline ComplexType MatsubaraContainer4<SourceObject>::operator()(long MatsubaraNumber1,
                                                                  long MatsubaraNumber2,
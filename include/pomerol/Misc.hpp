@@ -116,6 +116,12 @@ template <bool Complex> using ColMajorMatrixType = Eigen::SparseMatrix<MelemType
 /// Sparse real or complex matrix with row-major storage.
 /// \tparam Complex Whether the matrix in question is complex.
 template <bool Complex> using RowMajorMatrixType = Eigen::SparseMatrix<MelemType<Complex>, Eigen::RowMajor>;
+/// Read-only view of a compressed sparse real or complex matrix with column-major storage.
+/// \tparam Complex Whether the matrix in question is complex.
+template <bool Complex> using ColMajorMatrixView = Eigen::Map<ColMajorMatrixType<Complex> const>;
+/// Read-only view of a compressed sparse real or complex matrix with row-major storage.
+/// \tparam Complex Whether the matrix in question is complex.
+template <bool Complex> using RowMajorMatrixView = Eigen::Map<RowMajorMatrixType<Complex> const>;
 
 /// Imaginary unit \f$i\f$.
 static ComplexType const I = ComplexType(0.0, 1.0); // 'static' to prevent linking problems
@@ -96,6 +96,20 @@ protected:
     /// List of parts (matrix blocks).
     std::vector<MonomialOperatorPart> parts;
 
+    /// Compute a list of parts in parallel and broadcast the computed matrices to all processes.
+    /// The parts are distributed over the processes according to their estimated cost. If the eigenvectors
+    /// of the Hamiltonian are distributed, each part is computed by the process that stores the larger of
+    /// the eigenvector matrices it needs.
+    /// \param[in] Parts List of parts to compute.
+    /// \param[in] Tolerance Matrix elements with the absolute value equal or below this threshold
+    ///                      are considered negligible.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[in] DenseFillThreshold Fill ratio threshold passed to \ref MonomialOperatorPart::compute().
+    static void computeParts(std::vector<MonomialOperatorPart*> const& Parts,
+                             RealType Tolerance,
+                             MPI_Comm const& comm,
+                             RealType DenseFillThreshold = 1);
+
 public:
     /// Constructor.
     /// \tparam ScalarType Scalar type (either double or std::complex<double>) of the expression \p MO.
@@ -21,12 +21,15 @@
 #include "Misc.hpp"
 #include "StatesClassification.hpp"
 
+#include "mpi_dispatcher/misc.hpp"
+
 #include <libcommute/algebra_ids.hpp>
 #include <libcommute/loperator/loperator.hpp>
 
 #include <memory>
 #include <ostream>
 #include <type_traits>
+#include <vector>
 
 namespace Pomerol {
 
@@ -42,8 +45,12 @@ namespace Pomerol {
 /// \f[
 ///   \langle {\rm left}|\hat M|{\rm right}\rangle.
 /// \f]
+/// Constant methods of a computed part may be called by several threads concurrently. A pending part
+/// (see \ref computeLazily()) is computed by the first constant method called on it, and this first call
+/// must not run concurrently with any other call.
 class MonomialOperatorPart : public ComputableObject {
     friend class FieldOperatorContainer;
+    friend class MonomialOperator;
 
 private:
     /// Whether the following \p libcommute::loperator object is complex-valued.
@@ -63,12 +70,45 @@ private:
 
 protected:
     /// Type-erased real/complex sparse matrix \f$\langle {\rm left}|\hat M|{\rm right}\rangle\f$
-    /// stored in the row-major order.
+    /// stored in the row-major order (empty if the matrix is stored densely, see \ref isDense()).
     std::shared_ptr<void> elementsRowMajor;
     /// Type-erased real/complex sparse matrix \f$\langle {\rm left}|\hat M|{\rm right}\rangle\f$
-    /// stored in the column-major order.
+    /// stored in the column-major order (empty if the matrix is stored densely, see \ref isDense()).
     std::shared_ptr<void> elementsColMajor;
 
+    /// Whether the matrix is stored as a dense matrix \ref elementsDense.
+    bool Dense = false;
+    /// Type-erased real/complex dense matrix \f$\langle {\rm left}|\hat M|{\rm right}\rangle\f$
+    /// (only if \ref Dense is true).
+    std::shared_ptr<void> elementsDense;
+
+    /// Whether the matrices are shared with the adjoint part (see \ref setFromAdjoint()). In that case,
+    /// \ref elementsRowMajor points to the column-major matrix of the adjoint part and \ref elementsColMajor
+    /// to its row-major matrix, as the compressed storage of a matrix in one order is the compressed storage
+    /// of its transpose in the other order.
+    bool SharedWithAdjoint = false;
+    /// Complex conjugated values of the shared matrices in the row-major order (complex matrices only).
+    std::vector<ComplexType> ConjValuesRowMajor;
+    /// Complex conjugated values of the shared matrices in the column-major order (complex matrices only).
+    std::vector<ComplexType> ConjValuesColMajor;
+
+    /// Whether the matrices are to be computed on first access (see \ref computeLazily()).
+    bool Lazy = false;
+    /// Tolerance used to compute the matrices on first access.
+    RealType LazyTolerance = 0;
+    /// Fill ratio threshold used to compute the matrices on first access.
+    RealType LazyDenseFillThreshold = 1;
+    /// If not null, the matrices are obtained on first access from this adjoint part by \ref setFromAdjoint().
+    MonomialOperatorPart const* LazyAdjoint = nullptr;
+    /// Whether the matrices obtained from \ref LazyAdjoint are to be shared with it.
+    bool LazyShare = false;
+    /// Whether this part is needed by a correlator. It is mutable because it is marked by parts of
+    /// the correlators, which hold constant references to this part.
+    mutable bool Requested = false;
+
+    /// Rank of the MPI process that has computed this part.
+    int Owner = -1;
+
 public:
     /// Constructor.
     /// \tparam ScalarType Scalar type (either double or std::complex<double>) of the linear operator \p MOp.
@@ -91,12 +131,56 @@ public:
     /// Compute and store all matrix elements of \f$\hat M\f$ in the eigenbasis of the Hamiltonian.
     /// \param[in] Tolerance Matrix elements with the absolute value equal or below this threshold
     ///                      are considered negligible.
-    void compute(RealType Tolerance);
+    /// \param[in] DenseFillThreshold The matrix is stored as a dense matrix if the fraction of its
+    ///                               non-negligible elements exceeds this threshold.
+    ///                               The default value 1 means that the matrix is always stored sparsely.
+    void compute(RealType Tolerance, RealType DenseFillThreshold = 1);
+
+    /// Return the estimated cost of \ref compute(). It is dominated by the product of the adjoint eigenvector matrix
+    /// of the left subspace and the operator applied to the eigenvectors of the right subspace,
+    /// \f$N_{\rm left} D_{\rm left} N_{\rm right}\f$, where \f$D\f$ is the dimension of a subspace
+    /// and \f$N\f$ is the number of its computed eigenpairs.
+    double estimateCost() const;
+
+    /// Broadcast the computed matrices from one process to all other processes of a communicator.
+    /// This is a collective operation.
+    /// \param[in] comm MPI communicator.
+    /// \param[in] root Rank of the process that has computed the matrices.
+    void broadcast(MPI_Comm const& comm, int root);
 
     /// Reset the stored sparse matrices to those obtained from
     /// \f$\langle {\rm right}|\hat M^\dagger|{\rm left}\rangle\f$.
     /// \param[in] part Monomial operator part \f$\langle {\rm right}|\hat M^\dagger|{\rm left}\rangle\f$.
-    void setFromAdjoint(MonomialOperatorPart const& part);
+    /// If \p part is stored densely, so is this part.
+    /// \param[in] Share If true, this part does not store its own copies of the matrices, but refers to those of
+    ///                  \p part (only the conjugated values of complex matrices are stored).
+    ///                  Densely stored matrices are never shared.
+    ///                  The matrices are then accessible only through \ref getRowMajorView()
+    ///                  and \ref getColMajorView().
+    void setFromAdjoint(MonomialOperatorPart const& part, bool Share = false);
+
+    /// Defer computation of the matrices until they are accessed for the first time. The first access
+    /// calls \ref compute() or, if \p Adjoint is not null, \ref setFromAdjoint().
+    /// Matrices of a pending part must not be accessed concurrently by several threads.
+    /// \param[in] Tolerance Matrix elements with the absolute value equal or below this threshold
+    ///                      are considered negligible.
+    /// \param[in] Adjoint Monomial operator part \f$\langle {\rm right}|\hat M^\dagger|{\rm left}\rangle\f$
+    ///                    to obtain the matrices from, or nullptr to compute them directly.
+    ///                    It must outlive this part.
+    /// \param[in] Share Share the matrices with \p Adjoint, see \ref setFromAdjoint().
+    /// \param[in] DenseFillThreshold Fill ratio threshold passed to \ref compute().
+    void computeLazily(RealType Tolerance,
+                       MonomialOperatorPart const* Adjoint = nullptr,
+                       bool Share = false,
+                       RealType DenseFillThreshold = 1);
+
+    /// Is computation of the matrices deferred until first access and not performed yet?
+    bool isPending() const { return Lazy && getStatus() < Computed; }
+
+    /// Mark this part as needed by a correlator. Parts of the correlators call this method on construction.
+    void request() const { Requested = true; }
+    /// Has this part been marked as needed by a correlator?
+    bool isRequested() const { return Requested; }
 
     /// Is this object storing a complex-valued sparse matrices?
     bool isComplex() const { return Complex; }
@@ -118,11 +202,71 @@ public:
     /// \pre The compile-time value of \p C must agree with the result of \ref isComplex().
     template <bool C> ColMajorMatrixType<C> const& getColMajorValue() const;
 
+    /// Return a read-only view of the row-major sparse matrix, which is valid whether or not
+    /// the matrices are shared with the adjoint part.
+    /// \tparam C Request a view of the complex-valued matrix.
+    /// \pre The compile-time value of \p C must agree with the result of \ref isComplex(),
+    ///      and \ref isDense() must return false.
+    template <bool C> RowMajorMatrixView<C> getRowMajorView() const;
+    /// Return a read-only view of the row-major sparse matrix, converting a densely stored matrix if necessary.
+    /// \tparam C Request a view of the complex-valued matrix.
+    /// \param[out] Storage If the matrix is stored densely, this argument receives its sparse copy, which
+    ///                     the returned view refers to. The copy is not kept by this part.
+    /// \pre The compile-time value of \p C must agree with the result of \ref isComplex().
+    template <bool C> RowMajorMatrixView<C> getRowMajorView(RowMajorMatrixType<C>& Storage) const;
+    /// Return a read-only view of the column-major sparse matrix, which is valid whether or not
+    /// the matrices are shared with the adjoint part.
+    /// \tparam C Request a view of the complex-valued matrix.
+    /// \pre The compile-time value of \p C must agree with the result of \ref isComplex(),
+    ///      and \ref isDense() must return false.
+    template <bool C> ColMajorMatrixView<C> getColMajorView() const;
+    /// Return a read-only view of the column-major sparse matrix, converting a densely stored matrix if necessary.
+    /// \tparam C Request a view of the complex-valued matrix.
+    /// \param[out] Storage If the matrix is stored densely, this argument receives its sparse copy, which
+    ///                     the returned view refers to. The copy is not kept by this part.
+    /// \pre The compile-time value of \p C must agree with the result of \ref isComplex().
+    template <bool C> ColMajorMatrixView<C> getColMajorView(ColMajorMatrixType<C>& Storage) const;
+
+    /// Are the matrices shared with the adjoint part?
+    bool isSharedWithAdjoint() const { return SharedWithAdjoint; }
+
+    /// Is the matrix stored as a dense matrix?
+    bool isDense() const {
+        ensureComputed();
+        return Dense;
+    }
+    /// Return a constant reference to the stored dense matrix.
+    /// \tparam C Request a reference to the complex-valued matrix.
+    /// \pre The compile-time value of \p C must agree with the result of \ref isComplex(),
+    ///      and \ref isDense() must return true.
+    template <bool C> MatrixType<C> const& getDenseValue() const;
+
+    /// Return the number of stored non-zero matrix elements.
+    /// \pre \ref compute() or \ref setFromAdjoint() has been called.
+    Eigen::Index getNonZeros() const;
+
+    /// Return the number of stored non-zero matrix elements or, for a pending part (see \ref isPending()),
+    /// its upper bound \f$N_{\rm left} N_{\rm right}\f$ without computing the matrices.
+    double estimateNonZeros() const;
+
+    /// Return the maximal magnitude of stored matrix elements, or zero if there are none.
+    /// \pre \ref compute() or \ref setFromAdjoint() has been called.
+    RealType getMaxAbsElement() const;
+
     /// Return the index of the right invariant subspace.
     BlockNumber getRightIndex() const { return HFrom.getBlockNumber(); }
     /// Return the index of the left invariant subspace.
     BlockNumber getLeftIndex() const { return HTo.getBlockNumber(); }
 
+    /// Return rank of the MPI process that has computed this part, or -1 if the part has been computed
+    /// without distributing the work over processes.
+    int getOwner() const { return Owner; }
+
+    /// Return the number of rows of the matrix, i.e. the number of eigenstates in the left invariant subspace.
+    InnerQuantumState getNumberOfRows() const { return HTo.getNumberOfEigenValues(); }
+    /// Return the number of columns of the matrix, i.e. the number of eigenstates in the right invariant subspace.
+    InnerQuantumState getNumberOfColumns() const { return HFrom.getNumberOfEigenValues(); }
+
     /// Output stream insertion operator.
     /// \param[out] os Output stream.
     /// \param[in] part \ref MonomialOperatorPart to be inserted.
@@ -137,8 +281,10 @@ public:
 
 private:
     // Implementation details
-    template <bool C, bool HC> void computeImpl(RealType Tolerance);
+    template <bool C, bool HC> void computeImpl(RealType Tolerance, RealType DenseFillThreshold);
+    template <bool C> void broadcastImpl(MPI_Comm const& comm, int root);
     template <bool C> void streamOutputImpl(std::ostream& os) const;
+    void ensureComputed() const;
 };
 
 ///@}
@@ -205,6 +205,11 @@ public:
 private:
     // Implementation detail of compute().
     template <bool AComplex, bool BComplex> void computeImpl();
+    template <bool AComplex, bool BComplex> void computeDenseImpl();
+
+    /// Can a pair of eigenstates from the outer and the inner block contribute to \ref ZeroPoleWeight?
+    /// This is the case if the energy ranges of the blocks are closer than \ref PoleResolution.
+    bool mayHaveZeroPoles() const;
 };
 
 ///@}
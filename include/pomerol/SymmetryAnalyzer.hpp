@@ -0,0 +1,144 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file include/pomerol/SymmetryAnalyzer.hpp
+/// \brief Detection of single-particle index permutations that leave the Hamiltonian invariant.
+
+#ifndef POMEROL_INCLUDE_POMEROL_SYMMETRYANALYZER_HPP
+#define POMEROL_INCLUDE_POMEROL_SYMMETRYANALYZER_HPP
+
+#include "Index.hpp"
+#include "IndexClassification.hpp"
+#include "Misc.hpp"
+#include "Operators.hpp"
+
+#include <libcommute/expression/generator_fermion.hpp>
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Pomerol {
+
+/// \addtogroup Misc
+///@{
+
+/// \brief Symmetry group of a Hamiltonian formed by permutations of single-particle indices.
+///
+/// A permutation \f$P\f$ of single-particle indices is a symmetry of the Hamiltonian \f$\hat H\f$
+/// if the relabeling \f$c_i \to c_{P(i)}\f$, \f$c^\dagger_i \to c^\dagger_{P(i)}\f$ maps \f$\hat H\f$ onto itself.
+/// Typical examples are spin rotations by \f$\pi\f$, permutations of degenerate orbitals and lattice
+/// translations. Such a relabeling is implemented by a unitary transformation commuting with \f$\hat H\f$
+/// and with the density matrix, so that, for instance,
+/// \f$G_{ij} = G_{P(i)P(j)}\f$ and \f$\chi_{ijkl} = \chi_{P(i)P(j)P(k)P(l)}\f$.
+///
+/// The group is represented by a set of generators found by a backtracking search.
+/// For each single-particle index \f$k\f$ taken in reverse order, the search looks for permutations fixing
+/// all indices below \f$k\f$ and mapping \f$k\f$ onto each index that has not yet been reached from \f$k\f$
+/// by the generators found so far.
+class SymmetryAnalyzer {
+public:
+    /// Permutation of single-particle indices, \f$i \to P[i]\f$.
+    using IndexPermutation = std::vector<ParticleIndex>;
+
+private:
+    /// Normal ordered product of fermionic operators
+    /// \f$c^\dagger_{i_1}\ldots c^\dagger_{i_n} c_{j_m}\ldots c_{j_1}\f$,
+    /// \f$i_1 < \ldots < i_n\f$, \f$j_1 < \ldots < j_m\f$.
+    struct Monomial {
+        /// Indices \f$i_1, \ldots, i_n\f$ of the creation operators.
+        std::vector<ParticleIndex> Creation;
+        /// Indices \f$j_m, \ldots, j_1\f$ of the annihilation operators.
+        std::vector<ParticleIndex> Annihilation;
+
+        /// Lexicographical less comparison operator.
+        /// \param[in] rhs Monomial to compare to.
+        bool operator<(Monomial const& rhs) const {
+            return Creation < rhs.Creation || (Creation == rhs.Creation && Annihilation < rhs.Annihilation);
+        }
+    };
+
+    /// Number of single-particle indices.
+    ParticleIndex NumIndices = 0;
+    /// Generators of the symmetry group.
+    std::vector<IndexPermutation> Generators;
+
+    /// Find the generators for a Hamiltonian given as a map of normal ordered monomials to their coefficients.
+    /// \param[in] Terms Monomials of the Hamiltonian with their coefficients.
+    /// \param[in] Tolerance Maximal difference between coefficients to be considered equal.
+    void findGenerators(std::map<Monomial, ComplexType> const& Terms, RealType Tolerance);
+
+    /// Bring a monomial into the normal order.
+    /// \param[in,out] M Monomial whose operators are sorted.
+    /// \return Sign of the permutation of the fermionic operators.
+    static int normalOrder(Monomial& M);
+
+public:
+    /// Construct a trivial group that contains only the identity permutation.
+    SymmetryAnalyzer() = default;
+
+    /// Find symmetries of a Hamiltonian.
+    /// If the Hamiltonian contains non-fermionic operators, no symmetries are detected.
+    /// \tparam ScalarType Coefficient type of the Hamiltonian.
+    /// \tparam IndexTypes Types of indices carried by operators in the Hamiltonian.
+    /// \param[in] HExpr Expression of the Hamiltonian.
+    /// \param[in] IndexInfo Map for fermionic operator index tuples.
+    /// \param[in] Tolerance Maximal difference between coefficients of the Hamiltonian to be considered equal.
+    template <typename ScalarType, typename... IndexTypes>
+    SymmetryAnalyzer(Operators::expression<ScalarType, IndexTypes...> const& HExpr,
+                     IndexClassification<IndexTypes...> const& IndexInfo,
+                     RealType Tolerance = 1e-12);
+
+    /// Return the number of single-particle indices.
+    ParticleIndex getNumIndices() const { return NumIndices; }
+    /// Return the generators of the symmetry group.
+    std::vector<IndexPermutation> const& getGenerators() const { return Generators; }
+    /// Does the group consist only of the identity permutation?
+    bool isTrivial() const { return Generators.empty(); }
+
+    /// Return all index combinations equivalent to a given one, including itself.
+    /// \param[in] Indices Index combination \f$(i,j)\f$.
+    std::set<IndexCombination2> getOrbit(IndexCombination2 const& Indices) const;
+    /// Return all index combinations equivalent to a given one, including itself.
+    /// \param[in] Indices Index combination \f$(i,j,k,l)\f$.
+    std::set<IndexCombination4> getOrbit(IndexCombination4 const& Indices) const;
+};
+
+///@}
+
+template <typename ScalarType, typename... IndexTypes>
+SymmetryAnalyzer::SymmetryAnalyzer(Operators::expression<ScalarType, IndexTypes...> const& HExpr,
+                                   IndexClassification<IndexTypes...> const& IndexInfo,
+                                   RealType Tolerance)
+    : NumIndices(IndexInfo.getIndexSize()) {
+    std::map<Monomial, ComplexType> Terms;
+    for(auto const& mon : HExpr) {
+        Monomial M;
+        for(auto const& g : mon.monomial) {
+            if(!libcommute::is_fermion(g))
+                return;
+            ParticleIndex Index = IndexInfo.getIndex(g.indices());
+            if(static_cast<libcommute::generator_fermion<IndexTypes...> const&>(g).dagger()) {
+                // Creation operators must precede annihilation operators
+                if(!M.Annihilation.empty())
+                    return;
+                M.Creation.push_back(Index);
+            } else
+                M.Annihilation.push_back(Index);
+        }
+        int Sign = normalOrder(M);
+        Terms[M] += ComplexType(mon.coeff) * RealType(Sign);
+    }
+    findGenerators(Terms, Tolerance);
+}
+
+} // namespace Pomerol
+
+#endif // #ifndef POMEROL_INCLUDE_POMEROL_SYMMETRYANALYZER_HPP
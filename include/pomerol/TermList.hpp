@@ -22,6 +22,7 @@
 #include <algorithm>
 #include <cstddef>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace Pomerol {
@@ -37,6 +38,10 @@ namespace Pomerol {
 /// Similar terms are automatically collected and reduced to one term using \p operator+=().
 /// A term T is considered negligible and is automatically removed from the
 /// container if \p TermType::IsNegligible(T, current_number_of_terms + 1) evaluates to true.
+///
+/// The terms are stored contiguously in a vector. Lookup of similar terms is done via a flat open-addressing
+/// hash table with linear probing, whose slots hold hash values and positions of the terms in the vector.
+/// Similar terms are reduced in place, so that adding a term does not involve any per-term heap allocations.
 /// \tparam TermType Type of a single term.
 template <typename TermType> class TermList {
 
@@ -47,42 +52,165 @@ template <typename TermType> class TermList {
     /// Type of the term 'is negligible' predicate.
     using IsNegligible = typename TermType::IsNegligible;
 
-    /// The unordered set of terms.
-    std::unordered_set<TermType, Hash, KeyEqual> data;
+    /// A slot of the hash table.
+    struct Slot {
+        /// Hash value of the term.
+        std::size_t hash;
+        /// Position of the term in \ref data, or \ref EmptySlot.
+        std::size_t index;
+    };
+    /// Value of \ref Slot::index marking an empty slot.
+    static constexpr std::size_t EmptySlot = std::size_t(-1);
+    /// Initial number of slots in the hash table (must be a power of 2).
+    static constexpr std::size_t InitialCapacity = 16;
+
+    /// Hasher.
+    Hash hasher;
+    /// Similarity predicate.
+    KeyEqual key_equal;
     /// The 'is negligible' predicate.
     IsNegligible is_negligible;
 
+    /// The terms.
+    std::vector<TermType> data;
+    /// The hash table, its size is a power of 2 and it is at most half full.
+    std::vector<Slot> slots;
+
+    /// Position of a hash value in the hash table.
+    std::size_t home_slot(std::size_t hash) const { return hash & (slots.size() - 1); }
+
+    /// Find a slot pointing to a term similar to a given one.
+    /// \param[in] term Term to look up.
+    /// \param[in] hash Hash value of \p term.
+    /// \return Position of the slot, or position of the empty slot that terminates the probe sequence.
+    std::size_t find_slot(TermType const& term, std::size_t hash) const {
+        std::size_t mask = slots.size() - 1;
+        std::size_t pos = home_slot(hash);
+        for(; slots[pos].index != EmptySlot; pos = (pos + 1) & mask) {
+            if(slots[pos].hash == hash && key_equal(data[slots[pos].index], term))
+                break;
+        }
+        return pos;
+    }
+
+    /// Rebuild the hash table with a given number of slots.
+    /// \param[in] capacity New number of slots (must be a power of 2).
+    void rehash(std::size_t capacity) {
+        std::vector<Slot> old_slots(capacity, Slot{0, EmptySlot});
+        std::swap(slots, old_slots);
+        std::size_t mask = capacity - 1;
+        for(Slot const& slot : old_slots) {
+            if(slot.index == EmptySlot)
+                continue;
+            std::size_t pos = home_slot(slot.hash);
+            while(slots[pos].index != EmptySlot)
+                pos = (pos + 1) & mask;
+            slots[pos] = slot;
+        }
+    }
+
+    /// Insert a new term without looking for similar terms.
+    /// \param[in] term Term to be inserted.
+    /// \param[in] hash Hash value of \p term.
+    /// \param[in] pos Position of the empty slot to put the term into.
+    void insert(TermType const& term, std::size_t hash, std::size_t pos) {
+        slots[pos] = Slot{hash, data.size()};
+        data.push_back(term);
+        if(2 * data.size() > slots.size())
+            rehash(2 * slots.size());
+    }
+
+    /// Remove a term from the container.
+    /// \param[in] pos Position of the slot pointing to the term.
+    void erase(std::size_t pos) {
+        std::size_t index = slots[pos].index;
+        std::size_t mask = slots.size() - 1;
+
+        // Backward shift deletion
+        for(std::size_t next = (pos + 1) & mask; slots[next].index != EmptySlot; next = (next + 1) & mask) {
+            std::size_t home = home_slot(slots[next].hash);
+            // Can the term in slot 'next' be moved to 'pos' without breaking its probe sequence?
+            bool movable = (next > pos) ? (home <= pos || home > next) : (home <= pos && home > next);
+            if(movable) {
+                slots[pos] = slots[next];
+                pos = next;
+            }
+        }
+        slots[pos].index = EmptySlot;
+
+        // Fill the gap in the term storage with the last term
+        std::size_t last = data.size() - 1;
+        if(index != last) {
+            std::size_t last_pos = home_slot(hasher(data[last]));
+            while(slots[last_pos].index != last)
+                last_pos = (last_pos + 1) & mask;
+            slots[last_pos].index = index;
+            data[index] = std::move(data[last]);
+        }
+        data.pop_back();
+    }
+
 public:
     /// Constructor.
-    /// \param[in] hasher Hasher for the underlying \p std::unordered_set object.
-    /// \param[in] key_equal KeyEqual predicate for the underlying \p std::unordered_set object.
+    /// \param[in] hasher Hasher for the terms.
+    /// \param[in] key_equal KeyEqual predicate for the terms.
     /// \param[in] is_negligible Predicate that determines whether a term can be neglected.
     TermList(Hash const& hasher, KeyEqual const& key_equal, IsNegligible const& is_negligible)
-        : data(1, hasher, key_equal), is_negligible(is_negligible) {}
+        : hasher(hasher),
+          key_equal(key_equal),
+          is_negligible(is_negligible),
+          slots(InitialCapacity, Slot{0, EmptySlot}) {}
 
     /// Add a new term to the container
     /// \param[in] term Term to be added
     void add_term(TermType const& term) {
-        auto it = data.find(term);
-        if(it == data.end()) { // new term
-            data.emplace(term);
+        std::size_t hash = hasher(term);
+        std::size_t pos = find_slot(term, hash);
+        if(slots[pos].index == EmptySlot) { // new term
+            insert(term, hash, pos);
         } else { // similar term
-            TermType sum = *it;
+            TermType& sum = data[slots[pos].index];
             sum += term;
-            data.erase(*it);
-            if(!is_negligible(sum, data.size() + 1))
-                data.emplace(sum);
+            if(is_negligible(sum, data.size())) {
+                erase(pos);
+            } else {
+                // Poles of the sum might have moved to another bin
+                std::size_t new_hash = hasher(sum);
+                if(new_hash != hash) {
+                    TermType moved = sum;
+                    erase(pos);
+                    add_term(moved);
+                }
+            }
         }
     }
 
+    /// Add all terms from another container to this container.
+    /// \param[in] other Container to take the terms from.
+    void merge(TermList const& other) {
+        for(auto const& term : other.data)
+            add_term(term);
+    }
+
     /// Number of terms in the container.
     std::size_t size() const { return data.size(); }
 
-    /// Remove all terms from the container.
-    void clear() { data.clear(); }
+    /// Number of bytes allocated to store the terms and the hash table.
+    std::size_t getMemoryUsage() const { return data.capacity() * sizeof(TermType) + slots.capacity() * sizeof(Slot); }
 
-    /// Access the underlying set of terms.
-    std::unordered_set<TermType, Hash, KeyEqual> const& as_set() const { return data; }
+    /// Remove all terms from the container and release the memory they occupy.
+    void clear() {
+        std::vector<TermType>().swap(data);
+        std::vector<Slot>(InitialCapacity, Slot{0, EmptySlot}).swap(slots);
+    }
+
+    /// Access the underlying contiguous storage of terms.
+    std::vector<TermType> const& as_vector() const { return data; }
+
+    /// Return a copy of the terms in form of an unordered set.
+    std::unordered_set<TermType, Hash, KeyEqual> as_set() const {
+        return std::unordered_set<TermType, Hash, KeyEqual>(data.begin(), data.end(), data.size(), hasher, key_equal);
+    }
 
     /// Access the 'is negligible' predicate.
     IsNegligible const& get_is_negligible() const { return is_negligible; }
@@ -104,23 +232,28 @@ public:
     /// \param[in] comm The MPI communicator for the broadcast operation.
     /// \param[in] root Rank of the root MPI process.
     void broadcast(MPI_Comm const& comm, int root) {
-        auto hasher = data.hash_function();
-        auto key_eq = data.key_eq();
-
         hasher.broadcast(comm, root);
-        key_eq.broadcast(comm, root);
-
-        long n_terms;
-        if(pMPI::rank(comm) == root) { // Broadcast the terms from this process
-            n_terms = data.size();
-            std::vector<TermType> v(data.begin(), data.end());
-            MPI_Bcast(&n_terms, 1, MPI_LONG, root, comm);
-            MPI_Bcast(v.data(), v.size(), TermType::mpi_datatype(), root, comm);
-        } else { // Receive terms
-            MPI_Bcast(&n_terms, 1, MPI_LONG, root, comm);
-            std::vector<TermType> v(n_terms);
-            MPI_Bcast(v.data(), v.size(), TermType::mpi_datatype(), root, comm);
-            data = std::unordered_set<TermType, Hash, KeyEqual>(v.begin(), v.end(), 1, hasher, key_eq);
+        key_equal.broadcast(comm, root);
+
+        long n_terms = data.size();
+        MPI_Bcast(&n_terms, 1, MPI_LONG, root, comm);
+        if(pMPI::rank(comm) != root) { // Receive terms and rebuild the hash table
+            data.resize(n_terms);
+            std::size_t capacity = InitialCapacity;
+            while(2 * data.size() > capacity)
+                capacity *= 2;
+            slots.assign(capacity, Slot{0, EmptySlot});
+        }
+        MPI_Bcast(data.data(), n_terms, TermType::mpi_datatype(), root, comm);
+        if(pMPI::rank(comm) != root) {
+            std::size_t mask = slots.size() - 1;
+            for(std::size_t index = 0; index < data.size(); ++index) {
+                std::size_t hash = hasher(data[index]);
+                std::size_t pos = home_slot(hash);
+                while(slots[pos].index != EmptySlot)
+                    pos = (pos + 1) & mask;
+                slots[pos] = Slot{hash, index};
+            }
         }
 
         is_negligible.broadcast(comm, root);
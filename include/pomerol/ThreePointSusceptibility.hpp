@@ -17,6 +17,8 @@
 
 #include "ComputableObject.hpp"
 #include "DensityMatrix.hpp"
+#include "DistributedVector.hpp"
+#include "FrequencyGrids.hpp"
 #include "Hamiltonian.hpp"
 #include "Misc.hpp"
 #include "MonomialOperator.hpp"
@@ -26,6 +28,7 @@
 
 #include "mpi_dispatcher/misc.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <numeric>
 #include <tuple>
@@ -92,12 +95,34 @@ class ThreePointSusceptibility : public Thermal, public ComputableObject {
 protected:
     /// A flag that marks an identically vanishing susceptibility.
     bool Vanishing = true;
+    /// \brief A flag that marks terms stored only on the processes that have computed them.
+    ///
+    /// It is set by \ref compute() with \p clear = false if \ref DistributedTerms is set.
+    bool TermsDistributed = false;
 
 public:
     /// Lehmann representation: Maximal distance between energy poles to be consider coinciding.
     RealType PoleResolution = 1e-8;
     /// Lehmann representation: Maximal magnitude of a term coefficient to be considered negligible.
     RealType CoefficientTolerance = 1e-16;
+    /// \brief Evaluate the susceptibility only at an irreducible subset of the requested Matsubara frequencies.
+    ///
+    /// The following relations are used to restore the remaining values.
+    /// - \f$\chi^{(3)}_{pp}(\omega_{n_2},\omega_{n_1}) = -\chi^{(3)}_{pp}(\omega_{n_1},\omega_{n_2})\f$
+    ///   if \f$c^\dagger_1 = c^\dagger_3\f$.
+    /// - \f$\chi^{(3)}(-\omega_{n_1},-\omega_{n_2}) = \chi^{(3)}(\omega_{n_1},\omega_{n_2})^*\f$
+    ///   if the Hamiltonian and the operators are real.
+    ///
+    /// Only used by \ref compute() when all requested frequencies belong to the fermionic Matsubara grid.
+    bool UseFrequencySymmetries = false;
+    /// \brief Keep the terms of each part only on the process that has computed it.
+    ///
+    /// By default, \ref compute() with \p clear = false broadcasts terms of all parts to all processes.
+    /// If this flag is set, the terms are distributed over the processes instead, so that the memory needed per
+    /// process decreases with the number of processes. Values must then be obtained by the collective method
+    /// \ref evaluate(), while operator() throws \ref StatusMismatch unless all parts are stored on the calling
+    /// process.
+    bool DistributedTerms = false;
 
     /// Constructor
     /// \param[in] channel Channel of the 3-point susceptibility.
@@ -130,12 +155,56 @@ public:
     std::vector<ComplexType>
     compute(bool clear = false, FreqVec2 const& freqs = {}, MPI_Comm const& comm = MPI_COMM_WORLD);
 
+    /// Compute the parts in parallel and fill the internal cache of precomputed values on a frequency grid.
+    /// \param[in] clear If true, computed \ref ThreePointSusceptibilityPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] grid Grid of fermionic Matsubara frequency duplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \return Precomputed values stored in the dense matrix layout of \p grid.
+    /// \pre \ref prepare() has been called.
+    std::vector<ComplexType> compute(bool clear, FreqGrid2 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Compute the parts in parallel and distribute the precomputed values over the processes.
+    ///
+    /// Unlike \ref compute(), which sums contributions of all processes into a full copy of the values on each
+    /// process, this method combines the contributions by a reduce-scatter operation. Each process receives only
+    /// a contiguous slice of the values, which it can store directly, or the slices can be assembled on one
+    /// process by \ref DistributedVector::gather(). \ref UseFrequencySymmetries is not used by this method.
+    /// \param[in] clear If true, computed \ref ThreePointSusceptibilityPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] freqs List of frequency duplets \f$(\omega_{n_1},\omega_{n_2})\f$.
+    /// \param[in] comm MPI communicator used to parallelize the computation and to distribute the values.
+    /// \return Precomputed values distributed over \p comm.
+    /// \pre \ref prepare() has been called.
+    DistributedVector computeDistributed(bool clear, FreqVec2 const& freqs, MPI_Comm const& comm = MPI_COMM_WORLD);
+    /// Compute the parts in parallel and distribute the precomputed values on a frequency grid over the processes.
+    /// \param[in] clear If true, computed \ref ThreePointSusceptibilityPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] grid Grid of fermionic Matsubara frequency duplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation and to distribute the values.
+    /// \return Precomputed values stored in the dense matrix layout of \p grid and distributed over \p comm.
+    /// \pre \ref prepare() has been called.
+    /// \see \ref computeDistributed(bool, FreqVec2 const&, MPI_Comm const&)
+    DistributedVector computeDistributed(bool clear, FreqGrid2 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Evaluate the 3-point susceptibility at a list of frequency duplets using the computed terms.
+    ///
+    /// If the terms are distributed (\ref areTermsDistributed()), each process evaluates the parts it has computed,
+    /// and the values are summed over \p comm. This is a collective operation in that case.
+    /// \param[in] freqs List of frequency duplets \f$(\omega_{n_1},\omega_{n_2})\f$.
+    /// \param[in] comm MPI communicator used in \ref compute().
+    /// \return A list of values.
+    /// \pre \ref compute() has been called with \p clear = false.
+    std::vector<ComplexType> evaluate(FreqVec2 const& freqs, MPI_Comm const& comm = MPI_COMM_WORLD) const;
+
     /// Returns the single particle index of one of the operators \f$c^\dagger_1, c_2, c^\dagger_3, c_4\f$.
     /// \param[in] Position Position of the requested operator, 0--3.
     ParticleIndex getIndex(std::size_t Position) const;
 
     /// Return the value of the 3-point susceptibility calculated at a given complex frequency duplet.
     /// This method ignores the precomputed value cache.
+    /// It throws \ref StatusMismatch if the terms are distributed (\ref areTermsDistributed()) and some parts
+    /// are stored on other processes. Use the collective method \ref evaluate() in that case.
     /// \param[in] z1 First frequency \f$z_1\f$.
     /// \param[in] z2 Second frequency \f$z_2\f$.
     ComplexType operator()(ComplexType z1, ComplexType z2) const;
@@ -149,7 +218,37 @@ public:
     /// Is this susceptibility identically zero?
     bool isVanishing() const { return Vanishing; }
 
+    /// Are the terms stored only on the processes that have computed them?
+    /// This is the case after \ref compute() with \p clear = false if \ref DistributedTerms is set.
+    /// Values must then be obtained by the collective method \ref evaluate().
+    bool areTermsDistributed() const { return TermsDistributed; }
+
 private:
+    /// Compute the parts in parallel and fill the precomputed values using a given function.
+    /// \tparam FillFunc Type of the function object returning a value of a part at a given frequency.
+    /// \param[in] clear If true, computed \ref ThreePointSusceptibilityPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] NumFreqs Number of precomputed values.
+    /// \param[in] Value Function object called as Value(part, w), where w is the position of a frequency duplet.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[out] Slices If not null, the values are reduce-scattered into this distributed vector and
+    ///                    an empty list is returned.
+    template <typename FillFunc>
+    std::vector<ComplexType> computeParts(bool clear,
+                                          std::size_t NumFreqs,
+                                          FillFunc const& Value,
+                                          MPI_Comm const& comm,
+                                          DistributedVector* Slices = nullptr);
+
+    /// Compute the parts in parallel, fill the precomputed values at an irreducible subset of Matsubara
+    /// frequency duplets and restore the rest of the values using the frequency symmetries.
+    /// \param[in] clear If true, computed \ref ThreePointSusceptibilityPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] indices List of Matsubara index duplets \f$(n_1,n_2)\f$.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    std::vector<ComplexType>
+    computeIrreducible(bool clear, std::vector<MatsubaraDuplet> const& indices, MPI_Comm const& comm);
+
     /// Select operators F1, F2, B1 and B2 depending on the selected channel
     CreationOperator const& getF1() const;
     MonomialOperator const& getF2() const;
@@ -163,6 +262,11 @@ inline ComplexType ThreePointSusceptibility::operator()(ComplexType z1, ComplexT
     if(Vanishing)
         return 0;
     else {
+        if(TermsDistributed && std::any_of(parts.begin(), parts.end(), [](ThreePointSusceptibilityPart const& p) {
+               return p.getStatus() != ThreePointSusceptibilityPart::Computed;
+           }))
+            throw StatusMismatch("ThreePointSusceptibility: Terms of some parts are stored on other processes, "
+                                 "use evaluate() instead of operator()");
         return std::accumulate(
             parts.begin(),
             parts.end(),
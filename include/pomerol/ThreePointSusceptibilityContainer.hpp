@@ -49,6 +49,12 @@ public:
     RealType PoleResolution = 1e-8;
     /// Lehmann representation: Maximal magnitude of a term coefficient to be considered negligible.
     RealType CoefficientTolerance = 1e-16;
+    /// Evaluate elements only at irreducible subsets of the requested Matsubara frequencies.
+    /// \see \ref ThreePointSusceptibility::UseFrequencySymmetries
+    bool UseFrequencySymmetries = false;
+    /// Keep the terms of each part only on the process that has computed it.
+    /// \see \ref ThreePointSusceptibility::DistributedTerms
+    bool DistributedTerms = false;
 
     /// Constructor.
     /// \tparam IndexTypes Types of indices carried by the creation and annihilation operators.
@@ -86,6 +92,16 @@ public:
     std::map<IndexCombination4, std::vector<ComplexType>>
     computeAll(bool clearTerms = false, FreqVec2 const& freqs = {}, MPI_Comm const& comm = MPI_COMM_WORLD);
 
+    /// Compute all prepared elements \f$\chi^{(3)}_{ijkl}\f$ and precompute their values on a frequency grid.
+    /// \param[in] clearTerms If true, computed \ref ThreePointSusceptibilityPart's of all elements will be destroyed
+    ///                       immediately after filling the precomputed value cache.
+    /// \param[in] grid Grid of fermionic Matsubara frequency duplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \return Precomputed values of each element stored in the dense matrix layout of \p grid.
+    /// \pre \ref prepareAll() has been called.
+    std::map<IndexCombination4, std::vector<ComplexType>>
+    computeAll(bool clearTerms, FreqGrid2 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD);
+
 protected:
     friend class IndexContainer4<ThreePointSusceptibility, ThreePointSusceptibilityContainer>;
 
@@ -104,6 +120,12 @@ protected:
     DensityMatrix const& DM;
     /// A set of creation/annihilation operators \f$c^\dagger\f$/\f$c\f$.
     FieldOperatorContainer const& Operators;
+
+private:
+    // Implementation details.
+    template <typename Freqs>
+    std::map<IndexCombination4, std::vector<ComplexType>>
+    computeAllImpl(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm);
 };
 
 ///@}
@@ -490,6 +490,11 @@ public:
     /// Compute the terms contributing to this part.
     void compute();
 
+    /// Return the estimated cost of \ref compute(). It is the cost of the sparse product \f$B = B_1 B_2\f$
+    /// plus the expected number of generated multiterms, assuming uniformly distributed non-zero elements
+    /// of the operator blocks.
+    double estimateCost() const;
+
     /// Purge all terms.
     void clear();
 
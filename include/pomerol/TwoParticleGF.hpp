@@ -18,6 +18,8 @@
 
 #include "ComputableObject.hpp"
 #include "DensityMatrix.hpp"
+#include "DistributedVector.hpp"
+#include "FrequencyGrids.hpp"
 #include "Hamiltonian.hpp"
 #include "Misc.hpp"
 #include "MonomialOperator.hpp"
@@ -27,6 +29,7 @@
 
 #include "mpi_dispatcher/misc.hpp"
 
+#include <algorithm>
 #include <cstddef>
 #include <numeric>
 #include <tuple>
@@ -82,6 +85,11 @@ class TwoParticleGF : public Thermal, public ComputableObject {
 protected:
     /// A flag that marks an identically vanishing Green's function.
     bool Vanishing = true;
+    /// \brief A flag that marks terms stored only on the processes that have computed them.
+    ///
+    /// It is set by \ref compute() with \p clear = false, if \ref DistributedTerms is set or
+    /// if the terms of all parts do not fit into \ref MemoryBudget.
+    bool TermsDistributed = false;
 
     /// Extract the operator part standing at a specified position in a given permutation of the list
     /// \f$\{c_i,c_j,c^\dagger_k,c^\dagger_l\}\f$.
@@ -108,11 +116,93 @@ protected:
     /// \param[in] LeftIndex The left invariant subspace index.
     BlockNumber getRightIndex(std::size_t PermutationNumber, std::size_t OperatorPosition, BlockNumber LeftIndex) const;
 
+    /// Compute the parts in parallel and fill the precomputed values using a given function.
+    /// \tparam FillFunc Type of the function object that adds values of a part to a data vector.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] NumFreqs Number of precomputed values.
+    /// \param[in] Fill Function object called as Fill(part, First, data) that adds values of the part at positions
+    ///                 First, First + 1, ... to elements of data.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[out] Slices If not null, the values are reduce-scattered into this distributed vector and
+    ///                    an empty list is returned.
+    template <typename FillFunc>
+    std::vector<ComplexType> computeParts(bool clear,
+                                          std::size_t NumFreqs,
+                                          FillFunc const& Fill,
+                                          MPI_Comm const& comm,
+                                          DistributedVector* Slices = nullptr);
+
+    /// Compute parts of several Green's functions in parallel, computing parts that share the invariant subspaces
+    /// and the permutation together, and fill the precomputed values using a given function.
+    /// \tparam FillFunc Type of the function object that adds values of a part to a data vector.
+    /// \param[in] GFs List of Green's functions to compute.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] NumFreqs Number of precomputed values.
+    /// \param[in] Fill Function object called as Fill(part, First, data) that adds values of the part at positions
+    ///                 First, First + 1, ... to elements of data.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    template <typename FillFunc>
+    static std::vector<std::vector<ComplexType>> computePartsFused(std::vector<TwoParticleGF*> const& GFs,
+                                                                   bool clear,
+                                                                   std::size_t NumFreqs,
+                                                                   FillFunc const& Fill,
+                                                                   MPI_Comm const& comm);
+
+    /// Compute the parts in parallel, fill the precomputed values at an irreducible subset of Matsubara
+    /// frequency triplets and restore the rest of the values using the frequency symmetries.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] indices List of Matsubara index triplets \f$(n_1,n_2,n_3)\f$.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    std::vector<ComplexType>
+    computeIrreducible(bool clear, std::vector<MatsubaraTriplet> const& indices, MPI_Comm const& comm);
+
+    /// Sum values of the parts whose terms are stored on this process and, if the terms are distributed,
+    /// over all processes.
+    /// \tparam FillFunc Type of the function object that adds values of a part to a data vector.
+    /// \param[in] NumFreqs Number of values.
+    /// \param[in] Fill Function object called as Fill(part, First, data) that adds values of the part at positions
+    ///                 First, First + 1, ... to elements of data.
+    /// \param[in] comm MPI communicator used in the computation.
+    template <typename FillFunc>
+    std::vector<ComplexType> evaluateParts(std::size_t NumFreqs, FillFunc const& Fill, MPI_Comm const& comm) const;
+
 public:
     /// Lehmann representation: Maximal distance between energy poles to be consider coinciding.
     RealType PoleResolution = 1e-8;
     /// Lehmann representation: Maximal magnitude of a term coefficient to be considered negligible.
     RealType CoefficientTolerance = 1e-16;
+    /// \brief Evaluate the Green's function only at an irreducible subset of the requested Matsubara frequencies.
+    ///
+    /// The following relations are used to restore the remaining values.
+    /// - \f$\chi_{iikl}(\omega_{n_2},\omega_{n_1};\omega_{n_3}) =
+    ///   -\chi_{iikl}(\omega_{n_1},\omega_{n_2};\omega_{n_3})\f$.
+    /// - \f$\chi_{ijkk}(\omega_{n_1},\omega_{n_2};\omega_{n_1}+\omega_{n_2}-\omega_{n_3}) =
+    ///   -\chi_{ijkk}(\omega_{n_1},\omega_{n_2};\omega_{n_3})\f$.
+    /// - \f$\chi_{ijkl}(-\omega_{n_1},-\omega_{n_2};-\omega_{n_3}) =
+    ///   \chi_{ijkl}(\omega_{n_1},\omega_{n_2};\omega_{n_3})^*\f$ if the Hamiltonian and the operators are real.
+    ///
+    /// Only used by \ref compute() when all requested frequencies belong to the fermionic Matsubara grid.
+    bool UseFrequencySymmetries = false;
+    /// \brief Keep the terms of each part only on the process that has computed it.
+    ///
+    /// By default, \ref compute() with \p clear = false broadcasts terms of all parts to all processes.
+    /// If this flag is set, the terms are distributed over the processes instead, so that the memory needed per
+    /// process decreases with the number of processes. Values must then be obtained by the collective method
+    /// \ref evaluate(), while operator() throws \ref StatusMismatch unless all parts are stored on the calling
+    /// process.
+    bool DistributedTerms = false;
+    /// \brief Approximate amount of memory (in bytes) that one process may use to compute this Green's function.
+    ///
+    /// If nonzero, values of each part are evaluated in chunks of frequencies small enough for the temporary
+    /// evaluation storage, the computed terms and the precomputed values to fit into the budget. If in addition
+    /// \ref compute() is called with \p clear = false and the terms of all parts would not fit into the budget of
+    /// one process, the terms are kept distributed in the same way as with \ref DistributedTerms set (the flag
+    /// itself is not changed, see \ref areTermsDistributed()). The precomputed values themselves are always
+    /// stored in full, so the budget must be large enough to hold them.
+    std::size_t MemoryBudget = 0;
 
     /// Constructor.
     /// \param[in] S Information about invariant subspaces of the Hamiltonian.
@@ -143,12 +233,104 @@ public:
     std::vector<ComplexType>
     compute(bool clear = false, FreqVec3 const& freqs = {}, MPI_Comm const& comm = MPI_COMM_WORLD);
 
+    /// Compute the parts in parallel and fill the internal cache of precomputed values on a frequency grid.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] grid Grid of Matsubara frequency triplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \return Precomputed values stored in the dense tensor layout of \p grid.
+    /// \pre \ref prepare() has been called.
+    std::vector<ComplexType> compute(bool clear, FreqGrid3 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Compute the parts in parallel and distribute the precomputed values over the processes.
+    ///
+    /// Unlike \ref compute(), which sums contributions of all processes into a full copy of the values on each
+    /// process, this method combines the contributions by a reduce-scatter operation. Each process receives only
+    /// a contiguous slice of the values, which it can store directly, or the slices can be assembled on one
+    /// process by \ref DistributedVector::gather(). \ref UseFrequencySymmetries is not used by this method.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] freqs List of frequency triplets \f$(\omega_{n_1},\omega_{n_2},\omega_{n_3})\f$.
+    /// \param[in] comm MPI communicator used to parallelize the computation and to distribute the values.
+    /// \return Precomputed values distributed over \p comm.
+    /// \pre \ref prepare() has been called.
+    DistributedVector computeDistributed(bool clear, FreqVec3 const& freqs, MPI_Comm const& comm = MPI_COMM_WORLD);
+    /// Compute the parts in parallel and distribute the precomputed values on a frequency grid over the processes.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] grid Grid of Matsubara frequency triplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation and to distribute the values.
+    /// \return Precomputed values stored in the dense tensor layout of \p grid and distributed over \p comm.
+    /// \pre \ref prepare() has been called.
+    /// \see \ref computeDistributed(bool, FreqVec3 const&, MPI_Comm const&)
+    DistributedVector computeDistributed(bool clear, FreqGrid3 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Compute several Green's functions at once and fill their precomputed value caches.
+    ///
+    /// Parts of different Green's functions that connect the same invariant subspaces in the same order
+    /// are computed together by \ref TwoParticleGFPart::computeFused(), so that the operator blocks and
+    /// the intermediate states are traversed once for all such parts. This is beneficial when many components
+    /// \f$\chi_{ijkl}\f$ share the same block structure, e.g. in multi-orbital models. Parts of Green's functions
+    /// with different density matrices or pole resolutions are always computed separately.
+    /// \param[in] GFs List of Green's functions to compute.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] freqs List of frequency triplets \f$(\omega_{n_1},\omega_{n_2},\omega_{n_3})\f$.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \return Lists of precomputed values, one per element of \p GFs.
+    /// \pre \ref prepare() has been called for all elements of \p GFs.
+    static std::vector<std::vector<ComplexType>> computeFused(std::vector<TwoParticleGF*> const& GFs,
+                                                              bool clear = false,
+                                                              FreqVec3 const& freqs = {},
+                                                              MPI_Comm const& comm = MPI_COMM_WORLD);
+    /// Compute several Green's functions at once and fill their precomputed value caches on a frequency grid.
+    /// \param[in] GFs List of Green's functions to compute.
+    /// \param[in] clear If true, computed \ref TwoParticleGFPart's will be destroyed immediately after
+    ///                  filling the precomputed value cache.
+    /// \param[in] grid Grid of Matsubara frequency triplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \return Precomputed values stored in the dense tensor layout of \p grid, one list per element of \p GFs.
+    /// \pre \ref prepare() has been called for all elements of \p GFs.
+    /// \see \ref computeFused(std::vector<TwoParticleGF*> const&, bool, FreqVec3 const&, MPI_Comm const&)
+    static std::vector<std::vector<ComplexType>> computeFused(std::vector<TwoParticleGF*> const& GFs,
+                                                              bool clear,
+                                                              FreqGrid3 const& grid,
+                                                              MPI_Comm const& comm = MPI_COMM_WORLD);
+
+    /// \brief Evaluate the Green's function at a list of frequency triplets using the computed terms.
+    ///
+    /// If \ref DistributedTerms is set, each process evaluates the parts it has computed, and the values are
+    /// summed over \p comm. This is a collective operation in that case.
+    /// \param[in] freqs List of frequency triplets \f$(\omega_{n_1},\omega_{n_2},\omega_{n_3})\f$.
+    /// \param[in] comm MPI communicator used in \ref compute().
+    /// \return A list of values.
+    /// \pre \ref compute() has been called with \p clear = false.
+    std::vector<ComplexType> evaluate(FreqVec3 const& freqs, MPI_Comm const& comm = MPI_COMM_WORLD) const;
+    /// Evaluate the Green's function at a list of Matsubara frequency triplets using the computed terms.
+    /// \param[in] indices List of Matsubara index triplets \f$(n_1,n_2,n_3)\f$.
+    /// \param[in] comm MPI communicator used in \ref compute().
+    /// \return A list of values.
+    /// \pre \ref compute() has been called with \p clear = false.
+    /// \see \ref evaluate(FreqVec3 const&, MPI_Comm const&) const
+    std::vector<ComplexType> evaluate(std::vector<MatsubaraTriplet> const& indices,
+                                      MPI_Comm const& comm = MPI_COMM_WORLD) const;
+
+    /// Convert terms of all parts into the structure-of-arrays layout for faster evaluation.
+    /// \pre \ref compute() has been called with \p clear = false.
+    /// \see \ref TwoParticleGFPart::freeze()
+    void freeze();
+
+    /// Return the number of bytes occupied by the terms of the parts stored on this process.
+    std::size_t getMemoryUsage() const;
+
     /// Returns the single particle index of one of the operators \f$c_i,c_j,c^\dagger_k,c^\dagger_l\f$.
     /// \param[in] Position Position of the requested operator, 0--3.
     ParticleIndex getIndex(std::size_t Position) const;
 
     /// Return the value of the two-particle Green's function calculated at a given complex frequency triplet.
     /// This method ignores the precomputed value cache.
+    /// It throws \ref StatusMismatch if the terms are distributed (\ref areTermsDistributed()) and some parts
+    /// are stored on other processes. Use the collective method \ref evaluate() in that case.
     /// \param[in] z1 First frequency \f$z_1\f$.
     /// \param[in] z2 Second frequency \f$z_2\f$.
     /// \param[in] z3 Third frequency \f$z_3\f$.
@@ -164,6 +346,11 @@ public:
 
     /// Is this Green's function identically zero?
     bool isVanishing() const { return Vanishing; }
+
+    /// Are the terms stored only on the processes that have computed them?
+    /// This is the case after \ref compute() with \p clear = false if \ref DistributedTerms is set or if the terms
+    /// exceed \ref MemoryBudget. Values must then be obtained by the collective method \ref evaluate().
+    bool areTermsDistributed() const { return TermsDistributed; }
 };
 
 ///@}
@@ -172,6 +359,11 @@ inline ComplexType TwoParticleGF::operator()(ComplexType z1, ComplexType z2, Com
     if(Vanishing)
         return 0;
     else {
+        if(TermsDistributed && std::any_of(parts.begin(), parts.end(), [](TwoParticleGFPart const& p) {
+               return p.getStatus() != TwoParticleGFPart::Computed;
+           }))
+            throw StatusMismatch("TwoParticleGF: Terms of some parts are stored on other processes, "
+                                 "use evaluate() or Vertex4::values() instead of operator()");
         return std::accumulate(parts.begin(),
                                parts.end(),
                                ComplexType(0),
@@ -29,6 +29,7 @@
 
 #include "mpi_dispatcher/misc.hpp"
 
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <set>
@@ -54,6 +55,20 @@ public:
     RealType PoleResolution = 1e-8;
     /// Lehmann representation: Maximal magnitude of a term coefficient to be considered negligible.
     RealType CoefficientTolerance = 1e-16;
+    /// Compute parts of different elements that share the invariant subspaces and the permutation together.
+    /// If true, \ref computeAll() ignores its \p split argument and uses \ref TwoParticleGF::computeFused().
+    bool FuseComponents = false;
+    /// Evaluate elements only at irreducible subsets of the requested Matsubara frequencies.
+    /// \see \ref TwoParticleGF::UseFrequencySymmetries
+    bool UseFrequencySymmetries = false;
+    /// Keep the terms of each part only on the process that has computed it.
+    /// \see \ref TwoParticleGF::DistributedTerms
+    bool DistributedTerms = false;
+    /// Approximate amount of memory (in bytes) that one process may use to compute each element.
+    /// When \ref computeAll() splits the elements between processes, terms of the elements are also broadcast
+    /// only as long as the terms of all elements and the precomputed values fit into the budget.
+    /// \see \ref TwoParticleGF::MemoryBudget
+    std::size_t MemoryBudget = 0;
 
     /// Constructor.
     /// \tparam IndexTypes Types of indices carried by the creation and annihilation operators.
@@ -85,13 +100,24 @@ public:
     /// \param[in] freqs List of frequency triplets \f$(\omega_{n_1},\omega_{n_2},\omega_{n_3})\f$
     ///                  for value pre-computation.
     /// \param[in] comm MPI communicator used to parallelize the computation.
-    /// \param[in] split Enable MPI parallelization.
+    /// \param[in] split Enable MPI parallelization. Ignored if \ref FuseComponents is true.
     /// \pre \ref prepareAll() has been called.
     std::map<IndexCombination4, std::vector<ComplexType>> computeAll(bool clearTerms = false,
                                                                      FreqVec3 const& freqs = {},
                                                                      MPI_Comm const& comm = MPI_COMM_WORLD,
                                                                      bool split = true);
 
+    /// Compute all prepared elements \f$\chi_{ijkl}\f$ and precompute their values on a frequency grid.
+    /// \param[in] clearTerms If true, computed \ref TwoParticleGFPart's of all elements will be destroyed
+    ///                       immediately after filling the precomputed value cache.
+    /// \param[in] grid Grid of Matsubara frequency triplets.
+    /// \param[in] comm MPI communicator used to parallelize the computation.
+    /// \param[in] split Enable MPI parallelization. Ignored if \ref FuseComponents is true.
+    /// \return Precomputed values of each element stored in the dense tensor layout of \p grid.
+    /// \pre \ref prepareAll() has been called.
+    std::map<IndexCombination4, std::vector<ComplexType>>
+    computeAll(bool clearTerms, FreqGrid3 const& grid, MPI_Comm const& comm = MPI_COMM_WORLD, bool split = true);
+
 protected:
     friend class IndexContainer4<TwoParticleGF, TwoParticleGFContainer>;
 
@@ -111,10 +137,15 @@ protected:
 
 private:
     // Implementation details.
+    template <typename Freqs>
+    std::map<IndexCombination4, std::vector<ComplexType>>
+    computeAll_nosplit(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm);
+    template <typename Freqs>
     std::map<IndexCombination4, std::vector<ComplexType>>
-    computeAll_nosplit(bool clearTerms, FreqVec3 const& freqs = {}, MPI_Comm const& comm = MPI_COMM_WORLD);
+    computeAll_split(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm);
+    template <typename Freqs>
     std::map<IndexCombination4, std::vector<ComplexType>>
-    computeAll_split(bool clearTerms, FreqVec3 const& freqs = {}, MPI_Comm const& comm = MPI_COMM_WORLD);
+    computeAll_fused(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm);
 };
 
 ///@}
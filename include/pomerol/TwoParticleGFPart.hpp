@@ -18,6 +18,7 @@
 
 #include "ComputableObject.hpp"
 #include "DensityMatrixPart.hpp"
+#include "FrequencyGrids.hpp"
 #include "HamiltonianPart.hpp"
 #include "Misc.hpp"
 #include "MonomialOperatorPart.hpp"
@@ -32,6 +33,9 @@
 #include <array>
 #include <complex>
 #include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace Pomerol {
 
@@ -307,6 +311,41 @@ public:
         static MPI_Datatype mpi_datatype();
     };
 
+    /// \brief Lehmann terms of one kind stored in the structure-of-arrays layout.
+    ///
+    /// The resonance flag is not stored, as all terms in one instance of this structure are of the same kind.
+    struct TermArrays {
+        /// Real parts of coefficients \f$C\f$ (of \f$R\f$ for resonant terms).
+        std::vector<RealType> CoeffRe;
+        /// Imaginary parts of coefficients \f$C\f$ (of \f$R\f$ for resonant terms).
+        std::vector<RealType> CoeffIm;
+        /// Real parts of coefficients \f$N\f$ (resonant terms only).
+        std::vector<RealType> NonResCoeffRe;
+        /// Imaginary parts of coefficients \f$N\f$ (resonant terms only).
+        std::vector<RealType> NonResCoeffIm;
+        /// Poles \f$P_1\f$.
+        std::vector<RealType> P1;
+        /// Poles \f$P_2\f$.
+        std::vector<RealType> P2;
+        /// Poles \f$P_3\f$.
+        std::vector<RealType> P3;
+
+        /// Number of stored terms.
+        std::size_t size() const { return P1.size(); }
+    };
+
+    /// \brief All Lehmann terms of a part in the structure-of-arrays layout, grouped by kind.
+    struct FrozenTerms {
+        /// Non-resonant terms with \ref NonResonantTerm::isz4 == false.
+        TermArrays NonResonantZ2;
+        /// Non-resonant terms with \ref NonResonantTerm::isz4 == true.
+        TermArrays NonResonantZ4;
+        /// Resonant terms with \ref ResonantTerm::isz1z2 == true.
+        TermArrays ResonantZ1Z2;
+        /// Resonant terms with \ref ResonantTerm::isz1z2 == false.
+        TermArrays ResonantZ2Z3;
+    };
+
 private:
     /// Part of the field operator \f$\hat O_1\f$.
     MonomialOperatorPart const& O1;
@@ -343,6 +382,23 @@ private:
     /// List of all resonant terms contributing to this part.
     TermList<ResonantTerm> ResonantTerms;
 
+    /// Is the structure-of-arrays copy of the terms \ref Frozen up to date?
+    bool IsFrozen = false;
+    /// Copy of the terms in the structure-of-arrays layout, filled by \ref freeze().
+    FrozenTerms Frozen;
+
+    /// Implementation of \ref accumulateMatsubaraValues() for any random-access list of index triplets.
+    template <typename MatsubaraIndices>
+    void accumulateMatsubaraValuesImpl(MatsubaraIndices const& indices,
+                                       std::vector<ComplexType>& data,
+                                       FrozenTerms const* Terms) const;
+
+    /// Apply \ref Permutation to a triplet of complex frequencies \f$(z_1, z_2, z_3)\f$.
+    std::array<ComplexType, 3> permuteFrequencies(ComplexType z1, ComplexType z2, ComplexType z3) const {
+        std::array<ComplexType, 3> Frequencies = {z1, z2, -z3};
+        return {Frequencies[Permutation.perm[0]], Frequencies[Permutation.perm[1]], Frequencies[Permutation.perm[2]]};
+    }
+
     /// Adds a multi-term that has the following form:
     /// \f[
     /// \frac{1}{(z_1-P_1)(z_3-P_3)}
@@ -371,6 +427,8 @@ private:
     /// In fact this is a slightly rewritten form of an equation for \f$\phi\f$ from
     /// <em>H. Hafermann et al 2009 EPL 85 27007</em>.
     ///
+    /// \param[out] NRTerms List to add the non-resonant terms to.
+    /// \param[out] RTerms List to add the resonant terms to.
     /// \param[in] Coeff Common prefactor \f$C\f$ for coefficients \f$C_2\f$, \f$C_4\f$,
     ///              \f$R_{12}\f$, \f$N_{12}\f$, \f$R_{23}\f$, \f$N_{23}\f$.
     /// \param[in] beta Inverse temperature.
@@ -382,7 +440,9 @@ private:
     /// \param[in] Wj The second weight \f$w_j\f$.
     /// \param[in] Wk The third weight \f$w_k\f$.
     /// \param[in] Wl The fourth weight \f$w_l\f$.
-    void addMultiterm(ComplexType Coeff,
+    void addMultiterm(TermList<NonResonantTerm>& NRTerms,
+                      TermList<ResonantTerm>& RTerms,
+                      ComplexType Coeff,
                       RealType beta,
                       RealType Ei,
                       RealType Ej,
@@ -391,15 +451,15 @@ private:
                       RealType Wi,
                       RealType Wj,
                       RealType Wk,
-                      RealType Wl);
+                      RealType Wl) const;
 
     /// Lehmann representation: Maximal distance between energy poles to be consider coinciding.
     RealType PoleResolution;
     /// Lehmann representation: Maximal magnitude of a term coefficient to be considered negligible.
     RealType CoefficientTolerance;
 
-    // compute() implementation details.
-    template <bool Complex> void computeImpl();
+    // computeFused() implementation details.
+    template <bool Complex> static void computeFusedImpl(std::vector<TwoParticleGFPart*> const& Parts);
 
 public:
     /// Constructor.
@@ -439,9 +499,100 @@ public:
     /// Compute the terms contributing to this part.
     void compute();
 
+    /// \brief Compute the terms contributing to several parts in one pass.
+    ///
+    /// The parts must be pairwise fusible (see \ref isFusibleWith()), i.e. they belong to different
+    /// components of a two-particle Green's function but share the invariant subspaces, the blocks of
+    /// the density matrix, the permutation and the pole resolution.
+    /// The loops over the intermediate states are run once for all parts using the union of sparsity patterns
+    /// of their operator blocks, and the generated terms are added to the term lists of the respective parts.
+    /// Parts that have already been computed are skipped.
+    /// \param[in] Parts List of parts to compute.
+    static void computeFused(std::vector<TwoParticleGFPart*> const& Parts);
+
+    /// Can this part be computed together with another part by \ref computeFused()?
+    /// \param[in] Part The other part.
+    bool isFusibleWith(TwoParticleGFPart const& Part) const;
+
+    /// Return the estimated cost of \ref compute(). It is the number of visited \f$(1,3)\f$ index pairs
+    /// plus the expected number of generated multiterms, assuming uniformly distributed non-zero elements
+    /// of the operator blocks,
+    /// \f[
+    ///  N_1 N_3 + \frac{{\rm nnz}(O_1) {\rm nnz}(O_2) {\rm nnz}(O_3) {\rm nnz}(CX_4)}{N_1 N_2 N_3 N_4}.
+    /// \f]
+    double estimateCost() const;
+
     /// Purge all terms.
     void clear();
 
+    /// Return the number of bytes occupied by the computed terms, including their copy made by \ref freeze().
+    std::size_t getMemoryUsage() const;
+
+    /// Estimated number of bytes of temporary storage per frequency triplet needed by
+    /// \ref accumulateMatsubaraValues(), not including the data vector.
+    static constexpr std::size_t EvaluationMemoryPerFrequency = 6 * sizeof(long) + 2 * sizeof(std::pair<long, long>);
+
+    /// \brief Make a copy of the computed terms in the structure-of-arrays layout.
+    ///
+    /// After this call, \ref accumulateValues() uses vectorizable evaluation kernels operating on contiguous
+    /// arrays of coefficients and poles without making a temporary copy. Evaluation at a single frequency triplet by
+    /// \ref operator()() still sums the term lists. The copy is discarded by \ref clear().
+    /// \pre \ref compute() has been called.
+    void freeze();
+    /// Has \ref freeze() been called?
+    bool isFrozen() const { return IsFrozen; }
+    /// \brief Convert the term lists into the structure-of-arrays layout.
+    ///
+    /// Unlike \ref freeze(), this method returns the copy. It can be passed to several calls of
+    /// \ref accumulateValues() and \ref accumulateMatsubaraValues() on an unfrozen part, so that
+    /// each of them does not have to make its own temporary copy.
+    /// \pre \ref compute() has been called.
+    FrozenTerms makeFrozenTerms() const;
+
+    /// \brief Add values of this part at multiple frequency triplets to a data vector.
+    ///
+    /// The frequency triplets are processed in tiles, and each Lehmann term is evaluated for all triplets in a tile
+    /// at once. If \ref freeze() has not been called and \p Terms is null, a temporary structure-of-arrays copy of
+    /// the terms is made.
+    /// \param[in] freqs List of frequency triplets \f$(z_1, z_2, z_3)\f$.
+    /// \param[in,out] data Values of this part are added to elements of this vector.
+    /// \param[in] Terms Structure-of-arrays copy of the terms returned by \ref makeFrozenTerms(),
+    ///                  used if this part is not frozen.
+    /// \pre \ref compute() has been called, \p data has the same size as \p freqs.
+    void accumulateValues(std::vector<std::tuple<ComplexType, ComplexType, ComplexType>> const& freqs,
+                          std::vector<ComplexType>& data,
+                          FrozenTerms const* Terms = nullptr) const;
+
+    /// \brief Add values of this part at multiple triplets of fermionic Matsubara frequencies to a data vector.
+    ///
+    /// The frequencies \f$z_1, z_2, z_3\f$ entering the Lehmann terms, as well as their combinations
+    /// \f$z_1+z_2+z_3\f$, \f$z_1+z_2\f$ and \f$z_2+z_3\f$, are Matsubara frequencies taking only a few distinct
+    /// values on a regular frequency grid. This method precomputes tables of the factors \f$1/(i\omega_n-P)\f$
+    /// for all distinct poles \f$P\f$ and for all Matsubara indices \f$n\f$ within the range of the grid,
+    /// so that each term is evaluated as a product of table entries without complex divisions.
+    /// \param[in] indices List of Matsubara index triplets \f$(n_1, n_2, n_3)\f$.
+    /// \param[in,out] data Values of this part are added to elements of this vector.
+    /// \param[in] Terms Structure-of-arrays copy of the terms returned by \ref makeFrozenTerms(),
+    ///                  used if this part is not frozen.
+    /// \pre \ref compute() has been called, \p data has the same size as \p indices.
+    void accumulateMatsubaraValues(std::vector<MatsubaraTriplet> const& indices,
+                                   std::vector<ComplexType>& data,
+                                   FrozenTerms const* Terms = nullptr) const;
+    /// Add values of this part on a structured grid of Matsubara frequency triplets to a data vector.
+    /// \param[in] grid Grid of frequency triplets.
+    /// \param[in,out] data Values of this part at the grid points \p First, \p First + 1, ... are added to
+    ///                    elements of this vector in the layout of \p grid.
+    /// \param[in] First Position of the first grid point in the dense tensor layout of \p grid.
+    /// \param[in] Terms Structure-of-arrays copy of the terms returned by \ref makeFrozenTerms(),
+    ///                  used if this part is not frozen.
+    /// \pre \ref compute() has been called, \p First + size of \p data does not exceed the size of \p grid.
+    /// \see \ref accumulateMatsubaraValues(std::vector<MatsubaraTriplet> const&, std::vector<ComplexType>&,
+    ///      FrozenTerms const*) const
+    void accumulateMatsubaraValues(FreqGrid3 const& grid,
+                                   std::vector<ComplexType>& data,
+                                   std::size_t First = 0,
+                                   FrozenTerms const* Terms = nullptr) const;
+
     /// Substitute complex frequencies \f$z_1, z_2, z_3\f$ into this part.
     /// \param[in] z1 First frequency \f$z_1\f$.
     /// \param[in] z2 Second frequency \f$z_2\f$.
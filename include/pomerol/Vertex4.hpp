@@ -23,6 +23,8 @@
 #include "Thermal.hpp"
 #include "TwoParticleGF.hpp"
 
+#include <vector>
+
 namespace Pomerol {
 
 /// \addtogroup 2PGF
@@ -62,6 +64,32 @@ class Vertex4 : public Thermal, public ComputableObject {
 
     friend class MatsubaraContainer4<Vertex4>;
 
+    /// Return the contribution of the disconnected part \f$-\chi^0_{ijkl}\f$ at a given Matsubara frequency triplet.
+    /// \param[in] MatsubaraNumber1 Index of the first Matsubara frequency \f$n_1\f$.
+    /// \param[in] MatsubaraNumber2 Index of the second Matsubara frequency \f$n_2\f$.
+    /// \param[in] MatsubaraNumber3 Index of the third Matsubara frequency \f$n_3\f$.
+    ComplexType disconnectedValue(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const;
+
+    /// Return values of \f$\chi_{ijkl}\f$ at a list of Matsubara frequency triplets computed by the batched
+    /// evaluation. Unless the terms of \f$\chi_{ijkl}\f$ are distributed, each process of \p comm evaluates
+    /// a contiguous slice of the list, and the slices are then shared among all processes.
+    /// \param[in] Indices List of Matsubara index triplets \f$(n_1,n_2,n_3)\f$.
+    /// \param[in] comm MPI communicator used to compute \f$\chi_{ijkl}\f$ or nullptr.
+    ///                 In the latter case, the whole list is evaluated by the calling process.
+    std::vector<ComplexType> chiValues(std::vector<MatsubaraTriplet> const& Indices, MPI_Comm const* comm) const;
+
+    /// Populate the internal cache of precomputed values, optionally taking values of \f$\chi_{ijkl}\f$
+    /// from a frequency grid.
+    /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
+    ///            \f$\omega_{n_1}\f$ and \f$\omega_{n_2}\f$ for which values are precomputed and stored.
+    /// \param[in] Grid Grid of Matsubara frequency triplets or nullptr.
+    /// \param[in] ChiValues Values of \f$\chi_{ijkl}\f$ on \p Grid or nullptr.
+    /// \param[in] comm MPI communicator used to compute \f$\chi_{ijkl}\f$ or nullptr.
+    void fillStorage(long NumberOfMatsubaras,
+                     FreqGrid3 const* Grid,
+                     std::vector<ComplexType> const* ChiValues,
+                     MPI_Comm const* comm);
+
 public:
     /// Constructor.
     /// \param[in] Chi Fermionic two-particle Matsubara Green's function \f$\chi_{ijkl}\f$
@@ -75,12 +103,48 @@ public:
             GreensFunction const& G14,
             GreensFunction const& G23);
 
-    /// Populate the internal cache of precomputed values.
+    /// \brief Populate the internal cache of precomputed values.
+    ///
+    /// All values of \f$\chi_{ijkl}\f$ are requested in one batch and computed by
+    /// \ref TwoParticleGF::evaluate() on the calling process.
+    /// The cache is filled and the disconnected part is added by OpenMP threads in parallel.
+    /// It throws \ref ComputableObject::StatusMismatch if the terms of \f$\chi_{ijkl}\f$ are distributed
+    /// (\ref TwoParticleGF::areTermsDistributed()); use \ref compute(long, MPI_Comm const&) in that case.
     /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
     ///            \f$\omega_{n_1}\f$ and \f$\omega_{n_2}\f$ for which values are precomputed and stored.
     void compute(long NumberOfMatsubaras = 0);
 
+    /// \brief Populate the internal cache of precomputed values using multiple processes.
+    ///
+    /// All values of \f$\chi_{ijkl}\f$ are requested in one batch and computed by
+    /// \ref TwoParticleGF::evaluate(). The batch is split between processes of \p comm, or, if the terms of
+    /// \f$\chi_{ijkl}\f$ are distributed (\ref TwoParticleGF::areTermsDistributed()), evaluated collectively.
+    /// The cache is filled and the disconnected part is added by OpenMP threads in parallel.
+    /// This method must be called by all processes of \p comm.
+    /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
+    ///            \f$\omega_{n_1}\f$ and \f$\omega_{n_2}\f$ for which values are precomputed and stored.
+    /// \param[in] comm MPI communicator used to compute \f$\chi_{ijkl}\f$.
+    void compute(long NumberOfMatsubaras, MPI_Comm const& comm);
+
+    /// \brief Populate the internal cache of precomputed values reusing precomputed values of \f$\chi_{ijkl}\f$.
+    ///
+    /// Values of \f$\chi_{ijkl}\f$ at frequency triplets belonging to \p Grid are taken from \p ChiValues,
+    /// e.g. the result of \ref TwoParticleGF::compute(bool, FreqGrid3 const&, MPI_Comm const&).
+    /// The remaining values are computed as in \ref compute(long, MPI_Comm const&).
+    /// A grid in the PP channel with the bosonic range \f$[-2N+1, 2N)\f$ and the fermionic ranges
+    /// \f$[-N, N)\f$, where \f$N\f$ is \p NumberOfMatsubaras, covers all precomputed values.
+    /// \param[in] NumberOfMatsubaras Number of positive fermionic Matsubara frequencies
+    ///            \f$\omega_{n_1}\f$ and \f$\omega_{n_2}\f$ for which values are precomputed and stored.
+    /// \param[in] Grid Grid of Matsubara frequency triplets.
+    /// \param[in] ChiValues Values of \f$\chi_{ijkl}\f$ stored in the dense tensor layout of \p Grid.
+    /// \param[in] comm MPI communicator used to compute \f$\chi_{ijkl}\f$.
+    void compute(long NumberOfMatsubaras,
+                 FreqGrid3 const& Grid,
+                 std::vector<ComplexType> const& ChiValues,
+                 MPI_Comm const& comm = MPI_COMM_WORLD);
+
     /// Return the value of the vertex calculated a given Matsubara frequency triplet.
+    /// Values missing from the internal cache of precomputed values are calculated by \ref value().
     /// \param[in] MatsubaraNumber1 Index of the first Matsubara frequency
     ///                             \f$n_1\f$ (\f$\omega_{n_1}=\pi(2n_1+1)/\beta\f$).
     /// \param[in] MatsubaraNumber2 Index of the second Matsubara frequency
@@ -90,7 +154,10 @@ public:
     ComplexType operator()(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const;
 
     /// Return the value of vertex calculated a given Matsubara frequency triplet.
-    /// This method ignores the internal cache of precomputed values.
+    /// This method ignores the internal cache of precomputed values. It throws
+    /// \ref ComputableObject::StatusMismatch if the terms of \f$\chi_{ijkl}\f$ are distributed
+    /// (\ref TwoParticleGF::areTermsDistributed()) and some of them are stored on other processes;
+    /// use \ref values() in that case.
     /// \param[in] MatsubaraNumber1 Index of the first Matsubara frequency
     ///                             \f$n_1\f$ (\f$\omega_{n_1}=\pi(2n_1+1)/\beta\f$).
     /// \param[in] MatsubaraNumber2 Index of the second Matsubara frequency
@@ -98,6 +165,15 @@ public:
     /// \param[in] MatsubaraNumber3 Index of the third Matsubara frequency
     ///                             \f$n_3\f$ (\f$\omega_{n_3}=\pi(2n_3+1)/\beta\f$).
     ComplexType value(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const;
+
+    /// Return values of the vertex calculated at a list of Matsubara frequency triplets.
+    /// This method ignores the internal cache of precomputed values. It is a collective operation,
+    /// which splits the list between processes of \p comm or, if the terms of \f$\chi_{ijkl}\f$ are
+    /// distributed (\ref TwoParticleGF::areTermsDistributed()), evaluates \f$\chi_{ijkl}\f$ collectively.
+    /// \param[in] Indices List of Matsubara index triplets \f$(n_1,n_2,n_3)\f$.
+    /// \param[in] comm MPI communicator used to compute \f$\chi_{ijkl}\f$.
+    std::vector<ComplexType> values(std::vector<MatsubaraTriplet> const& Indices,
+                                    MPI_Comm const& comm = MPI_COMM_WORLD) const;
 };
 
 ///@}
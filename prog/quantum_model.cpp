@@ -19,6 +19,7 @@
 #include <gftools.hpp>
 
 #include <algorithm>
+#include <cmath>
 #include <complex>
 #include <stdexcept>
 #include <tuple>
@@ -82,7 +83,6 @@ void quantum_model::parse_args(int argc, char const* const argv[]) {
 
 void quantum_model::compute() {
 
-    using gftools::tools::is_float_equal;
     using gftools::grid_object;
     using gftools::fmatsubara_grid;
     using gftools::bmatsubara_grid;
@@ -217,21 +217,22 @@ void quantum_model::compute() {
 
             G4.prepare();
             MPI_Barrier(comm);
-            std::vector<std::tuple<ComplexType, ComplexType, ComplexType>> freqs_2pgf;
             fmatsubara_grid fgrid(wf_min, wf_max, beta, true);
             bmatsubara_grid bgrid(wb_min, wb_max, beta, true);
-            freqs_2pgf.reserve(fgrid.size() * fgrid.size() * bgrid.size());
-            for(auto W : bgrid.values()) {
-                for(auto w3 : fgrid.values()) {
-                    for(auto w2 : fgrid.values()) {
-                        ComplexType w1 = W + w3;
-                        freqs_2pgf.emplace_back(w1, w2, w3);
-                    }
-                }
-            }
-            mpi_cout << "2PGF : " << freqs_2pgf.size() << " freqs to evaluate\n";
-
-            std::vector<ComplexType> chi_freq_data = G4.compute(true, freqs_2pgf, comm);
+            // Ranges of Matsubara indices covered by the grids
+            auto matsubara_range = [beta](ComplexType first_value, std::size_t size, bool bosonic) {
+                long first = std::lround((std::imag(first_value) * beta / M_PI - (bosonic ? 0 : 1)) / 2);
+                return MatsubaraRange(first, first + static_cast<long>(size));
+            };
+            MatsubaraRange nu_range = fgrid.size() ? matsubara_range(fgrid.values()[0], fgrid.size(), false)
+                                                   : MatsubaraRange(0, 0);
+            MatsubaraRange W_range = bgrid.size() ? matsubara_range(bgrid.values()[0], bgrid.size(), true)
+                                                  : MatsubaraRange(0, 0);
+            // (w1, w2, w3) = (W + w3, w2, w3)
+            FreqGrid3 grid_2pgf(PH, W_range, nu_range, nu_range);
+            mpi_cout << "2PGF : " << grid_2pgf.size() << " freqs to evaluate\n";
+
+            std::vector<ComplexType> chi_freq_data = G4.compute(true, grid_2pgf, comm);
 
             // dump 2PGF into files - loop through 2pgf components
             if(!rank) {
@@ -247,8 +248,6 @@ void quantum_model::compute() {
                             std::complex<double> val = chi_freq_data[w_ind];
                             full_vertex[W][w3.index()][w2.index()] = val;
                             full_vertex_1freq[w3.index()][w2.index()] = val;
-                            if(!is_float_equal(std::get<0>(freqs_2pgf[w_ind]), W.value() + w3.value()))
-                                throw std::logic_error("2PGF freq mismatch");
                             ++w_ind;
                         }
                     }
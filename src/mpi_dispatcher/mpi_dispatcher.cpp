@@ -126,14 +126,76 @@ void MPIMaster::order_worker(WorkerId worker, JobId job) {
     MPI_Irecv(nullptr, 0, MPI_INT, worker, pMPI::Pending, Comm, &wait_statuses[WorkerIndices[worker]]);
 }
 
+void MPIMaster::set_affinity(std::map<JobId, WorkerId> const& affinity, bool strict) {
+    AffineJobStacks.clear();
+    // In the strict mode, the common stack keeps only the jobs without a preferred worker
+    std::stack<JobId> CommonJobs;
+    for(int i = Ntasks - 1; i >= 0; --i) {
+        auto it = affinity.find(task_numbers[i]);
+        if(it != affinity.end() && WorkerIndices.count(it->second))
+            AffineJobStacks[it->second].emplace(task_numbers[i]);
+        else
+            CommonJobs.emplace(task_numbers[i]);
+    }
+    if(strict)
+        JobStack.swap(CommonJobs);
+}
+
+// Pick the next job for a worker. Jobs that have already been ordered are
+// lazily removed from the tops of the stacks.
+bool MPIMaster::next_job_(WorkerId worker, JobId& job) {
+    auto it = AffineJobStacks.find(worker);
+    if(it != AffineJobStacks.end()) {
+        auto& stack = it->second;
+        while(!stack.empty() && DispatchMap.count(stack.top()))
+            stack.pop();
+        if(!stack.empty()) {
+            job = stack.top();
+            stack.pop();
+            return true;
+        }
+    }
+
+    while(!JobStack.empty() && DispatchMap.count(JobStack.top()))
+        JobStack.pop();
+    if(JobStack.empty())
+        return false;
+    job = JobStack.top();
+    JobStack.pop();
+    return true;
+}
+
+// Are there jobs that have not been ordered yet?
+bool MPIMaster::has_jobs_() {
+    while(!JobStack.empty() && DispatchMap.count(JobStack.top()))
+        JobStack.pop();
+    if(!JobStack.empty())
+        return true;
+    for(auto& Stack : AffineJobStacks) {
+        auto& stack = Stack.second;
+        while(!stack.empty() && DispatchMap.count(stack.top()))
+            stack.pop();
+        if(!stack.empty())
+            return true;
+    }
+    return false;
+}
+
 void MPIMaster::order() {
-    while(!WorkerStack.empty() && !JobStack.empty()) {
-        WorkerId const& worker = WorkerStack.top();
-        JobId const& job = JobStack.top();
-        order_worker(worker, job);
+    // With strict affinity, the jobs left may be meant for some of the pending workers only,
+    // so the workers that cannot be given a job stay pending
+    std::stack<WorkerId> Idle;
+    JobId job;
+    while(!WorkerStack.empty()) {
+        WorkerId worker = WorkerStack.top();
         WorkerStack.pop();
-        JobStack.pop();
+        if(next_job_(worker, job))
+            order_worker(worker, job);
+        else
+            Idle.push(worker);
     }
+    for(; !Idle.empty(); Idle.pop())
+        WorkerStack.push(Idle.top());
 }
 
 void MPIMaster::check_workers() {
@@ -147,7 +209,7 @@ void MPIMaster::check_workers() {
             WorkerStack.push(worker_pool[i]);
         }
     }
-    if(JobStack.empty() && WorkerStack.size() >= Nprocs) {
+    if(!has_jobs_() && WorkerStack.size() >= Nprocs) {
         for(std::size_t i = 0; i < Nprocs; ++i) {
             if(!workers_finish[i]) {
                 MPI_Send(nullptr, 0, MPI_INT, worker_pool[i], pMPI::Finish, Comm);
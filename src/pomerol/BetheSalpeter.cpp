@@ -0,0 +1,258 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file src/pomerol/BetheSalpeter.cpp
+/// \brief Generalized susceptibilities and channel-irreducible vertices from the Bethe-Salpeter equation
+/// (implementation).
+
+#include "pomerol/BetheSalpeter.hpp"
+
+#include <Eigen/LU>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+
+namespace Pomerol {
+
+BetheSalpeter::BetheSalpeter(Channel channel,
+                             std::vector<IndexCombination2> const& Pairs,
+                             MatsubaraRange const& W,
+                             MatsubaraRange const& Nu)
+    : channel(channel), Pairs(Pairs), W(W), Nu(Nu), LocalW(W.Begin, W.Begin) {
+    for(auto const& p : Pairs) {
+        for(auto const& q : Pairs) {
+            switch(channel) {
+            case PP: Combinations.emplace_back(p.Index1, p.Index2, q.Index1, q.Index2); break;
+            case xPH: Combinations.emplace_back(p.Index1, q.Index1, q.Index2, p.Index2); break;
+            default: Combinations.emplace_back(p.Index1, q.Index1, p.Index2, q.Index2);
+            }
+        }
+    }
+}
+
+MatsubaraRange BetheSalpeter::getBosonicSlice(int Rank, int Size) const {
+    long NumW = static_cast<long>(W.size());
+    return MatsubaraRange(W.Begin + NumW * Rank / Size, W.Begin + NumW * (Rank + 1) / Size);
+}
+
+void BetheSalpeter::compute(std::map<IndexCombination4, std::vector<ComplexType>> const& ChiValues,
+                            GFContainer& G,
+                            MPI_Comm const& comm) {
+    if(getStatus() >= Computed)
+        return;
+
+    Comm = comm;
+    LocalW = getBosonicSlice(pMPI::rank(comm), pMPI::size(comm));
+
+    FreqGrid3 Grid = getGrid();
+    std::size_t First = Grid.index(static_cast<std::size_t>(LocalW.Begin - W.Begin), 0, 0);
+    std::size_t LocalSize = LocalW.size() * Nu.size() * Nu.size();
+
+    // Bosonic frequencies are the slowest running index of the grid, so the local values are contiguous
+    std::vector<std::vector<ComplexType>> LocalChi;
+    for(auto const& ic : Combinations) {
+        auto It = ChiValues.find(ic);
+        if(It == ChiValues.end() || It->second.size() != Grid.size())
+            throw std::invalid_argument("BetheSalpeter: Values of a needed element are missing or have wrong size");
+        LocalChi.emplace_back(It->second.begin() + static_cast<std::ptrdiff_t>(First),
+                              It->second.begin() + static_cast<std::ptrdiff_t>(First + LocalSize));
+    }
+
+    solve(LocalChi, G);
+}
+
+void BetheSalpeter::compute(TwoParticleGFContainer& Chi, GFContainer& G, MPI_Comm const& comm) {
+    if(getStatus() >= Computed)
+        return;
+
+    int comm_rank = pMPI::rank(comm);
+    int comm_size = pMPI::size(comm);
+
+    Comm = comm;
+    LocalW = getBosonicSlice(comm_rank, comm_size);
+
+    std::vector<std::vector<ComplexType>> LocalChi;
+    for(auto const& ic : Combinations) {
+        auto& Element = Chi(ic);
+        TwoParticleGF const& GF = *Element.pElement;
+        Permutation4 const& Perm = Element.FrequenciesPermutation;
+
+        // Matsubara indices of the stored element on the bosonic frequencies owned by a given process
+        auto makeIndices = [&](int Rank) {
+            FreqGrid3 SliceGrid(channel, getBosonicSlice(Rank, comm_size), Nu, Nu);
+            std::vector<MatsubaraTriplet> Indices(SliceGrid.size());
+            for(std::size_t k = 0; k < SliceGrid.size(); ++k) {
+                MatsubaraTriplet n = SliceGrid[k];
+                std::array<long, 4> n4 = {n[0], n[1], n[2], n[0] + n[1] - n[2]};
+                Indices[k] = {n4[Perm.perm[0]], n4[Perm.perm[1]], n4[Perm.perm[2]]};
+            }
+            return Indices;
+        };
+
+        std::vector<ComplexType> Values;
+        if(GF.areTermsDistributed()) {
+            // Evaluation is collective, so all processes take part in evaluation for each slice
+            for(int Rank = 0; Rank < comm_size; ++Rank) {
+                std::vector<ComplexType> SliceValues = GF.evaluate(makeIndices(Rank), comm);
+                if(Rank == comm_rank)
+                    Values = std::move(SliceValues);
+            }
+        } else
+            Values = GF.evaluate(makeIndices(comm_rank), comm);
+
+        for(auto& V : Values)
+            V *= RealType(Perm.sign);
+        LocalChi.emplace_back(std::move(Values));
+    }
+
+    solve(LocalChi, G);
+}
+
+void BetheSalpeter::solve(std::vector<std::vector<ComplexType>> const& LocalChi, GFContainer& G) {
+    std::size_t NumPairs = Pairs.size();
+    std::size_t NumNu = Nu.size();
+    std::size_t D = getMatrixSize();
+    long NumLocalW = static_cast<long>(LocalW.size());
+    RealType beta = G.beta;
+
+    Susceptibility.assign(LocalW.size() * D * D, 0);
+    Bubble.assign(LocalW.size() * NumNu * NumPairs * NumPairs, 0);
+    Vertex.assign(LocalW.size() * D * D, 0);
+
+    // Assemble X and the diagonal blocks of X^0
+    FreqGrid3 LocalGrid(channel, LocalW, Nu, Nu);
+    for(std::size_t p = 0; p < NumPairs; ++p) {
+        for(std::size_t q = 0; q < NumPairs; ++q) {
+            IndexCombination4 const& ic = Combinations[p * NumPairs + q];
+            std::vector<ComplexType> const& ChiValues = LocalChi[p * NumPairs + q];
+            GreensFunction const& G13 = G(ic.Index1, ic.Index3);
+            GreensFunction const& G24 = G(ic.Index2, ic.Index4);
+            GreensFunction const& G14 = G(ic.Index1, ic.Index4);
+            GreensFunction const& G23 = G(ic.Index2, ic.Index3);
+
+            for(std::size_t k = 0; k < LocalGrid.size(); ++k) {
+                MatsubaraTriplet n = LocalGrid[k];
+                std::size_t iW = k / (NumNu * NumNu);
+                std::size_t iNu = (k / NumNu) % NumNu;
+                std::size_t iNuPrime = k % NumNu;
+
+                // Two terms of the disconnected part
+                ComplexType Term13 = n[0] == n[2] ? -beta * G13(n[0]) * G24(n[1]) : ComplexType(0);
+                ComplexType Term14 = n[1] == n[2] ? beta * G14(n[0]) * G23(n[1]) : ComplexType(0);
+                ComplexType BubbleTerm = channel == PH ? Term14 : Term13;
+                ComplexType OtherTerm = channel == PH ? Term13 : Term14;
+
+                std::size_t I = p * NumNu + iNu;
+                std::size_t J = q * NumNu + iNuPrime;
+                Susceptibility[(iW * D + I) * D + J] = ChiValues[k] - OtherTerm;
+                if(iNu == iNuPrime)
+                    Bubble[((iW * NumNu + iNu) * NumPairs + p) * NumPairs + q] = BubbleTerm;
+            }
+        }
+    }
+
+    // Gamma = (X^0)^{-1} - X^{-1} at each bosonic frequency
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(long iWL = 0; iWL < NumLocalW; ++iWL) {
+        std::size_t iW = static_cast<std::size_t>(iWL);
+        Eigen::Map<ComplexMatrixType const> X(Susceptibility.data() + iW * D * D, D, D);
+        Eigen::Map<ComplexMatrixType> Gamma(Vertex.data() + iW * D * D, D, D);
+        Gamma = -X.partialPivLu().inverse();
+
+        for(std::size_t iNu = 0; iNu < NumNu; ++iNu) {
+            Eigen::Map<ComplexMatrixType const> X0Block(
+                Bubble.data() + (iW * NumNu + iNu) * NumPairs * NumPairs, NumPairs, NumPairs);
+            ComplexMatrixType X0BlockInv = X0Block.partialPivLu().inverse();
+            for(std::size_t p = 0; p < NumPairs; ++p) {
+                for(std::size_t q = 0; q < NumPairs; ++q)
+                    Gamma(p * NumNu + iNu, q * NumNu + iNu) += X0BlockInv(p, q);
+            }
+        }
+    }
+
+    setStatus(Computed);
+}
+
+ComplexMatrixType BetheSalpeter::getSusceptibility(long m) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("BetheSalpeter is not computed yet.");
+    if(!LocalW.contains(m))
+        throw std::out_of_range("BetheSalpeter: Bosonic frequency is not owned by this process");
+    std::size_t D = getMatrixSize();
+    std::size_t iW = static_cast<std::size_t>(m - LocalW.Begin);
+    return Eigen::Map<ComplexMatrixType const>(Susceptibility.data() + iW * D * D, D, D);
+}
+
+ComplexMatrixType BetheSalpeter::getBubble(long m) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("BetheSalpeter is not computed yet.");
+    if(!LocalW.contains(m))
+        throw std::out_of_range("BetheSalpeter: Bosonic frequency is not owned by this process");
+    std::size_t NumPairs = Pairs.size();
+    std::size_t NumNu = Nu.size();
+    std::size_t iW = static_cast<std::size_t>(m - LocalW.Begin);
+
+    ComplexMatrixType X0 = ComplexMatrixType::Zero(getMatrixSize(), getMatrixSize());
+    for(std::size_t iNu = 0; iNu < NumNu; ++iNu) {
+        for(std::size_t p = 0; p < NumPairs; ++p) {
+            for(std::size_t q = 0; q < NumPairs; ++q)
+                X0(p * NumNu + iNu, q * NumNu + iNu) = Bubble[((iW * NumNu + iNu) * NumPairs + p) * NumPairs + q];
+        }
+    }
+    return X0;
+}
+
+ComplexMatrixType BetheSalpeter::getVertex(long m) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("BetheSalpeter is not computed yet.");
+    if(!LocalW.contains(m))
+        throw std::out_of_range("BetheSalpeter: Bosonic frequency is not owned by this process");
+    std::size_t D = getMatrixSize();
+    std::size_t iW = static_cast<std::size_t>(m - LocalW.Begin);
+    return Eigen::Map<ComplexMatrixType const>(Vertex.data() + iW * D * D, D, D);
+}
+
+std::vector<ComplexType> BetheSalpeter::gather(std::vector<ComplexType> const& Data, int Root) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("BetheSalpeter is not computed yet.");
+
+    int comm_size = pMPI::size(Comm);
+    bool is_root = pMPI::rank(Comm) == Root;
+    std::size_t D = getMatrixSize();
+
+    std::vector<ComplexType> AllData;
+    std::vector<int> counts, displs;
+    if(is_root) {
+        AllData.resize(W.size() * D * D);
+        counts.resize(comm_size);
+        displs.resize(comm_size);
+        for(int r = 0; r < comm_size; ++r) {
+            MatsubaraRange Slice = getBosonicSlice(r, comm_size);
+            displs[r] = static_cast<int>(static_cast<std::size_t>(Slice.Begin - W.Begin) * D * D);
+            counts[r] = static_cast<int>(Slice.size() * D * D);
+        }
+    }
+    MPI_Gatherv(Data.data(),
+                static_cast<int>(Data.size()),
+                POMEROL_MPI_DOUBLE_COMPLEX,
+                AllData.data(),
+                counts.data(),
+                displs.data(),
+                POMEROL_MPI_DOUBLE_COMPLEX,
+                Root,
+                Comm);
+    return AllData;
+}
+
+} // namespace Pomerol
@@ -15,10 +15,12 @@
 
 #include "pomerol/DensityMatrixPart.hpp"
 
+#include <algorithm>
+
 namespace Pomerol {
 
 DensityMatrixPart::DensityMatrixPart(HamiltonianPart const& H, RealType beta, RealType GroundEnergy)
-    : Thermal(beta), H(H), GroundEnergy(GroundEnergy), weights(H.getSize()) {}
+    : Thermal(beta), H(H), GroundEnergy(GroundEnergy), weights(H.getNumberOfEigenValues()) {}
 
 RealType DensityMatrixPart::computeUnnormalized() {
     weights = exp(-beta * (H.getEigenValues().array() - GroundEnergy));
@@ -28,6 +30,15 @@ RealType DensityMatrixPart::computeUnnormalized() {
 void DensityMatrixPart::normalize(RealType Z) {
     weights /= Z;
     Z_part /= Z;
+
+    // Suffix maxima of the weights. Eigenvalues are sorted in the ascending order,
+    // so this is usually the same as weights, but it does not rely on the ordering.
+    MaxWeights.resize(weights.size());
+    RealType MaxWeight = 0;
+    for(Eigen::Index s = weights.size() - 1; s >= 0; --s) {
+        MaxWeight = std::max(MaxWeight, weights(s));
+        MaxWeights(s) = MaxWeight;
+    }
 }
 
 RealType DensityMatrixPart::getAverageEnergy() const {
@@ -35,9 +46,18 @@ RealType DensityMatrixPart::getAverageEnergy() const {
 }
 
 RealType DensityMatrixPart::getWeight(InnerQuantumState s) const {
+    // Eigenstates beyond the computed part of the spectrum have negligible weights
+    if(s >= static_cast<InnerQuantumState>(weights.size()))
+        return 0;
     return weights(static_cast<Eigen::Index>(s));
 }
 
+RealType DensityMatrixPart::getMaxWeight(InnerQuantumState s) const {
+    if(s >= static_cast<InnerQuantumState>(MaxWeights.size()))
+        return 0;
+    return MaxWeights(static_cast<Eigen::Index>(s));
+}
+
 void DensityMatrixPart::truncate(RealType Tolerance) {
     Retained = false;
     InnerQuantumState partSize = weights.size();
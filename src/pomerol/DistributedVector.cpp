@@ -0,0 +1,95 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file src/pomerol/DistributedVector.cpp
+/// \brief A vector of complex values distributed over processes of an MPI communicator (implementation).
+
+#include "pomerol/DistributedVector.hpp"
+
+namespace Pomerol {
+
+std::size_t DistributedVector::getOffset(int Rank) const {
+    return TotalSize * static_cast<std::size_t>(Rank) / static_cast<std::size_t>(pMPI::size(Comm));
+}
+
+void DistributedVector::resize(std::size_t NewTotalSize) {
+    TotalSize = NewTotalSize;
+    int comm_rank = pMPI::rank(Comm);
+    LocalData.assign(getOffset(comm_rank + 1) - getOffset(comm_rank), 0);
+}
+
+void DistributedVector::reduceScatter(std::vector<ComplexType>& Contributions) {
+    int comm_size = pMPI::size(Comm);
+    TotalSize = Contributions.size();
+
+    std::vector<int> counts(comm_size);
+    for(int r = 0; r < comm_size; ++r)
+        counts[r] = static_cast<int>(getOffset(r + 1) - getOffset(r));
+
+    LocalData.assign(counts[pMPI::rank(Comm)], 0);
+    MPI_Reduce_scatter(Contributions.data(),
+                       LocalData.data(),
+                       counts.data(),
+                       POMEROL_MPI_DOUBLE_COMPLEX,
+                       MPI_SUM,
+                       Comm);
+
+    Contributions.clear();
+    Contributions.shrink_to_fit();
+}
+
+std::vector<ComplexType> DistributedVector::gather(int Root) const {
+    int comm_size = pMPI::size(Comm);
+    bool is_root = pMPI::rank(Comm) == Root;
+
+    std::vector<ComplexType> Data;
+    std::vector<int> counts, displs;
+    if(is_root) {
+        Data.resize(TotalSize);
+        counts.resize(comm_size);
+        displs.resize(comm_size);
+        for(int r = 0; r < comm_size; ++r) {
+            displs[r] = static_cast<int>(getOffset(r));
+            counts[r] = static_cast<int>(getOffset(r + 1) - getOffset(r));
+        }
+    }
+    MPI_Gatherv(LocalData.data(),
+                static_cast<int>(LocalData.size()),
+                POMEROL_MPI_DOUBLE_COMPLEX,
+                Data.data(),
+                counts.data(),
+                displs.data(),
+                POMEROL_MPI_DOUBLE_COMPLEX,
+                Root,
+                Comm);
+    return Data;
+}
+
+std::vector<ComplexType> DistributedVector::allgather() const {
+    int comm_size = pMPI::size(Comm);
+
+    std::vector<ComplexType> Data(TotalSize);
+    std::vector<int> counts(comm_size), displs(comm_size);
+    for(int r = 0; r < comm_size; ++r) {
+        displs[r] = static_cast<int>(getOffset(r));
+        counts[r] = static_cast<int>(getOffset(r + 1) - getOffset(r));
+    }
+    MPI_Allgatherv(LocalData.data(),
+                   static_cast<int>(LocalData.size()),
+                   POMEROL_MPI_DOUBLE_COMPLEX,
+                   Data.data(),
+                   counts.data(),
+                   displs.data(),
+                   POMEROL_MPI_DOUBLE_COMPLEX,
+                   Comm);
+    return Data;
+}
+
+} // namespace Pomerol
@@ -56,11 +56,17 @@ void EnsembleAverage::compute() {
 // This function is called directly in prepare()
 template <bool Complex>
 ComplexType EnsembleAverage::computeImpl(MonomialOperatorPart const& Apart, DensityMatrixPart const& DMpart) {
-    // Blocks (submatrices) of A
-    RowMajorMatrixType<Complex> const& Amatrix = Apart.getRowMajorValue<Complex>();
-
     // Sum up <index1|A|index1> * weight(index1)
     ComplexType result_part = 0;
+    if(Apart.isDense()) {
+        auto const& Amatrix = Apart.getDenseValue<Complex>();
+        for(Eigen::Index Index = 0; Index < Amatrix.rows(); ++Index)
+            result_part += Amatrix(Index, Index) * DMpart.getWeight(Index);
+        return result_part;
+    }
+
+    // Blocks (submatrices) of A
+    RowMajorMatrixView<Complex> const Amatrix = Apart.getRowMajorView<Complex>();
     for(Eigen::Index Index = 0; Index < Amatrix.outerSize(); ++Index)
         result_part += Amatrix.coeff(Index, Index) * DMpart.getWeight(Index);
     return result_part;
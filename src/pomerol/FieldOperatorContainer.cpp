@@ -16,13 +16,31 @@
 #include "pomerol/FieldOperatorContainer.hpp"
 
 #include <stdexcept>
+#include <vector>
 
 namespace Pomerol {
 
-void FieldOperatorContainer::computeAll(RealType Tolerance) {
+void FieldOperatorContainer::computeAll(RealType Tolerance, MPI_Comm const& comm) {
+    // Parts of all creation operators are balanced together, as the operators can have very few parts each
+    std::vector<MonomialOperatorPart*> Parts;
     for(auto& cdag_p : mapCreationOperators) {
         auto& cdag = cdag_p.second;
-        cdag.compute(Tolerance);
+        cdag.checkPrepared();
+        if(cdag.getStatus() >= ComputableObject::Computed)
+            continue;
+        for(auto& part : cdag.parts) {
+            if(Lazy)
+                part.computeLazily(Tolerance, nullptr, false, DenseFillThreshold);
+            else
+                Parts.push_back(&part);
+        }
+    }
+    if(!Lazy)
+        MonomialOperator::computeParts(Parts, Tolerance, comm, DenseFillThreshold);
+
+    for(auto& cdag_p : mapCreationOperators) {
+        auto& cdag = cdag_p.second;
+        cdag.setStatus(ComputableObject::Computed);
 
         auto& c = mapAnnihilationOperators.find(cdag_p.first)->second;
 
@@ -30,12 +48,49 @@ void FieldOperatorContainer::computeAll(RealType Tolerance) {
         for(auto cdag_map_it = cdag_block_map.right.begin(); cdag_map_it != cdag_block_map.right.end(); ++cdag_map_it) {
             auto& cPart = c.getPartFromRightIndex(cdag_map_it->second);
             auto& cdagPart = cdag.getPartFromRightIndex(cdag_map_it->first);
-            cPart.setFromAdjoint(cdagPart);
+            if(!Lazy)
+                cPart.setFromAdjoint(cdagPart, SharedStorage);
+            else if(SharedStorage)
+                cPart.computeLazily(Tolerance, &cdagPart, true);
+            else
+                cPart.computeLazily(Tolerance, nullptr, false, DenseFillThreshold);
         }
         c.setStatus(ComputableObject::Computed);
     }
 }
 
+void FieldOperatorContainer::computeRequested(MPI_Comm const& comm) {
+    // Pending parts to be computed in parallel, and annihilation operator parts to be obtained from them
+    std::vector<MonomialOperatorPart*> Parts;
+    std::vector<MonomialOperatorPart*> AdjointParts;
+    for(auto& cdag_p : mapCreationOperators) {
+        auto& cdag = cdag_p.second;
+        auto& c = mapAnnihilationOperators.find(cdag_p.first)->second;
+        for(auto& cdagPart : cdag.parts) {
+            auto& cPart = c.getPartFromLeftIndex(cdagPart.getRightIndex());
+            bool cFromAdjoint = cPart.isRequested() && cPart.isPending() && cPart.LazyAdjoint;
+            if(cdagPart.isPending() && (cdagPart.isRequested() || cFromAdjoint))
+                Parts.push_back(&cdagPart);
+            if(cFromAdjoint)
+                AdjointParts.push_back(&cPart);
+            else if(cPart.isRequested() && cPart.isPending())
+                Parts.push_back(&cPart);
+        }
+    }
+
+    if(!Parts.empty()) {
+        // The parts are computed by one process each and broadcast, rather than on first access
+        for(MonomialOperatorPart* part : Parts)
+            part->Lazy = false;
+        // All parts share the tolerance and the fill ratio threshold passed to computeAll()
+        MonomialOperatorPart const& Part0 = *Parts.front();
+        MonomialOperator::computeParts(Parts, Part0.LazyTolerance, comm, Part0.LazyDenseFillThreshold);
+    }
+
+    for(MonomialOperatorPart* part : AdjointParts)
+        part->ensureComputed();
+}
+
 CreationOperator const& FieldOperatorContainer::getCreationOperator(ParticleIndex in) const {
     auto it = mapCreationOperators.find(in);
     if(it == mapCreationOperators.end())
@@ -53,10 +53,19 @@ GreensFunctionPart::GreensFunctionPart(MonomialOperatorPart const& F1,
       F2(F2),
       Terms(Term::Hash(PoleResolution), Term::KeyEqual(PoleResolution), Term::IsNegligible(CoefficientTolerance)),
       PoleResolution(PoleResolution),
-      CoefficientTolerance(CoefficientTolerance) {}
+      CoefficientTolerance(CoefficientTolerance) {
+    F1.request();
+    F2.request();
+}
 
 void GreensFunctionPart::compute() {
-    if(F1.isComplex() || F2.isComplex())
+    bool Complex = F1.isComplex() || F2.isComplex();
+    if(F1.isDense() && F2.isDense()) {
+        if(Complex)
+            computeDenseImpl<true>();
+        else
+            computeDenseImpl<false>();
+    } else if(Complex)
         computeImpl<true>();
     else
         computeImpl<false>();
@@ -65,17 +74,28 @@ void GreensFunctionPart::compute() {
 template <bool Complex> void GreensFunctionPart::computeImpl() {
     Terms.clear();
 
-    // Blocks (submatrices) of F1 and F2
-    RowMajorMatrixType<Complex> const& F1matrix = F1.template getRowMajorValue<Complex>();
-    ColMajorMatrixType<Complex> const& F2matrix = F2.template getColMajorValue<Complex>();
+    // Blocks (submatrices) of F1 and F2, temporarily converted to sparse matrices if stored densely
+    RowMajorMatrixType<Complex> F1storage;
+    ColMajorMatrixType<Complex> F2storage;
+    RowMajorMatrixView<Complex> const F1matrix = F1.template getRowMajorView<Complex>(F1storage);
+    ColMajorMatrixView<Complex> const F2matrix = F2.template getColMajorView<Complex>(F2storage);
     QuantumState outerSize = F1matrix.outerSize();
 
+    // |Residue| <= MaxElements * (weight of index1 + weight of index2)
+    RealType MaxElements = F1.getMaxAbsElement() * F2.getMaxAbsElement();
+    RealType MaxWeightInner = DMpartInner.getMaxWeight();
+
     // Iterate over all values of the outer index.
     // TODO: should be optimized - skip empty rows of F1matrix and empty columns of F2matrix.
     for(QuantumState index1 = 0; index1 < outerSize; ++index1) {
+        // All remaining residues are negligible
+        if(MaxElements * (DMpartOuter.getMaxWeight(index1) + MaxWeightInner) <= CoefficientTolerance)
+            break;
+        RealType WeightOuter = DMpartOuter.getWeight(index1);
+
         // <index1|F1|F1inner><F2inner|F2|index1>
-        typename RowMajorMatrixType<Complex>::InnerIterator F1inner(F1matrix, index1);
-        typename ColMajorMatrixType<Complex>::InnerIterator F2inner(F2matrix, index1);
+        typename RowMajorMatrixView<Complex>::InnerIterator F1inner(F1matrix, index1);
+        typename ColMajorMatrixView<Complex>::InnerIterator F2inner(F2matrix, index1);
 
         // While we are not at the last column of F1matrix or at the last row of F2matrix.
         while(F1inner && F2inner) {
@@ -84,8 +104,11 @@ template <bool Complex> void GreensFunctionPart::computeImpl() {
 
             // A meaningful matrix element
             if(F1_index2 == F2_index2) {
-                ComplexType Residue = F1inner.value() * F2inner.value() *
-                                      (DMpartOuter.getWeight(index1) + DMpartInner.getWeight(F1_index2));
+                // Residues for all remaining inner states are negligible
+                if(MaxElements * (WeightOuter + DMpartInner.getMaxWeight(F1_index2)) <= CoefficientTolerance)
+                    break;
+                ComplexType Residue =
+                    F1inner.value() * F2inner.value() * (WeightOuter + DMpartInner.getWeight(F1_index2));
                 if(std::abs(Residue) > CoefficientTolerance) // Is the residue relevant?
                 {
                     // Create a new term and append it to the list.
@@ -109,4 +132,40 @@ template <bool Complex> void GreensFunctionPart::computeImpl() {
     assert(Terms.check_terms());
 }
 
+// Both F1 and F2 are stored densely
+template <bool Complex> void GreensFunctionPart::computeDenseImpl() {
+    Terms.clear();
+
+    // Products <index1|F1|index2><index2|F2|index1> in a row-major outer x inner matrix,
+    // so that index2 runs over contiguous memory
+    MatrixType<Complex> const Products =
+        F1.template getDenseValue<Complex>().cwiseProduct(F2.template getDenseValue<Complex>().transpose());
+    QuantumState outerSize = Products.rows();
+    QuantumState innerSize = Products.cols();
+
+    // |Residue| <= MaxElements * (weight of index1 + weight of index2)
+    RealType MaxElements = F1.getMaxAbsElement() * F2.getMaxAbsElement();
+    RealType MaxWeightInner = DMpartInner.getMaxWeight();
+
+    for(QuantumState index1 = 0; index1 < outerSize; ++index1) {
+        // All remaining residues are negligible
+        if(MaxElements * (DMpartOuter.getMaxWeight(index1) + MaxWeightInner) <= CoefficientTolerance)
+            break;
+        RealType WeightOuter = DMpartOuter.getWeight(index1);
+
+        for(QuantumState index2 = 0; index2 < innerSize; ++index2) {
+            // Residues for all remaining inner states are negligible
+            if(MaxElements * (WeightOuter + DMpartInner.getMaxWeight(index2)) <= CoefficientTolerance)
+                break;
+            ComplexType Residue = Products(index1, index2) * (WeightOuter + DMpartInner.getWeight(index2));
+            if(std::abs(Residue) > CoefficientTolerance) {
+                RealType Pole = HpartInner.getEigenValue(index2) - HpartOuter.getEigenValue(index1);
+                Terms.add_term(Term(Residue, Pole));
+            }
+        }
+    }
+
+    assert(Terms.check_terms());
+}
+
 } // namespace Pomerol
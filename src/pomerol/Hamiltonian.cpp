@@ -17,14 +17,26 @@
 
 #include "mpi_dispatcher/mpi_skel.hpp"
 
+#include <cmath>
 #include <cstddef>
 #include <map>
+#include <memory>
 #include <stdexcept>
 
 namespace Pomerol {
 
+Hamiltonian::~Hamiltonian() {
+    // The MPI window must be freed before the eigenvector matrices attached to it,
+    // as other processes may still be accessing them.
+    for(auto& part : parts)
+        part.Window.reset();
+}
+
 // cppcheck-suppress unusedPrivateFunction
-template <bool C> void Hamiltonian::prepareImpl(LOperatorTypeRC<C> const& HOp, MPI_Comm const& comm) {
+template <bool C>
+void Hamiltonian::prepareImpl(LOperatorTypeRC<C> const& HOp,
+                              MPI_Comm const& comm,
+                              HamiltonianPart::StorageEnum Storage) {
     BlockNumber NumberOfBlocks = S.getNumberOfBlocks();
     int comm_rank = pMPI::rank(comm);
     if(!comm_rank)
@@ -32,7 +44,7 @@ template <bool C> void Hamiltonian::prepareImpl(LOperatorTypeRC<C> const& HOp, M
 
     parts.reserve(NumberOfBlocks);
     for(BlockNumber CurrentBlock = 0; CurrentBlock < NumberOfBlocks; ++CurrentBlock) {
-        parts.emplace_back(HOp, S, CurrentBlock);
+        parts.emplace_back(HOp, S, CurrentBlock, Storage);
     }
 
     pMPI::mpi_skel<pMPI::PrepareWrap<HamiltonianPart>> skel;
@@ -47,31 +59,98 @@ template <bool C> void Hamiltonian::prepareImpl(LOperatorTypeRC<C> const& HOp, M
 
     for(int p = 0; p < static_cast<int>(parts.size()); ++p) {
         auto& part = parts[p];
-        if(comm_rank == job_map[p]) {
+        int owner = job_map[p];
+        if(comm_rank == owner) {
             if(part.getStatus() != HamiltonianPart::Prepared) {
                 ERROR("Worker" << comm_rank << " didn't calculate part" << p);
                 throw std::logic_error("Worker didn't calculate this part.");
             }
+        }
+
+        switch(Storage) {
+        case HamiltonianPart::DenseStorage: {
+            if(comm_rank != owner)
+                part.initHMatrix<C>();
             auto& H = part.getMatrix<C>();
-            MPI_Bcast(H.data(), H.size(), H_dt, comm_rank, comm);
-        } else {
-            part.initHMatrix<C>();
-            auto& H = part.getMatrix<C>();
-            MPI_Bcast(H.data(), H.rows() * H.cols(), H_dt, job_map[p], comm);
-            part.setStatus(HamiltonianPart::Prepared);
+            MPI_Bcast(H.data(), static_cast<int>(H.size()), H_dt, owner, comm);
+        } break;
+        case HamiltonianPart::SparseStorage: {
+            if(comm_rank != owner) {
+                auto BlockSize = static_cast<Eigen::Index>(part.getSize());
+                part.HSparseMatrix = std::make_shared<RowMajorMatrixType<C>>(BlockSize, BlockSize);
+            }
+            auto& H = *std::static_pointer_cast<RowMajorMatrixType<C>>(part.HSparseMatrix);
+            long nnz = H.nonZeros();
+            MPI_Bcast(&nnz, 1, MPI_LONG, owner, comm);
+            if(comm_rank != owner)
+                H.resizeNonZeros(nnz);
+            MPI_Bcast(H.outerIndexPtr(), static_cast<int>(H.outerSize() + 1), MPI_INT, owner, comm);
+            MPI_Bcast(H.innerIndexPtr(), static_cast<int>(nnz), MPI_INT, owner, comm);
+            MPI_Bcast(H.valuePtr(), static_cast<int>(nnz), H_dt, owner, comm);
+        } break;
+        case HamiltonianPart::MatrixFreeStorage: {
+            if(comm_rank != owner) {
+                part.initMapper();
+                part.Diagonal.resize(part.getSize());
+            }
+            MPI_Bcast(part.Diagonal.data(), static_cast<int>(part.Diagonal.size()), MPI_DOUBLE, owner, comm);
+        } break;
         }
+
+        if(comm_rank != owner)
+            part.setStatus(HamiltonianPart::Prepared);
     }
 }
 
-template void Hamiltonian::prepareImpl<true>(LOperatorTypeRC<true> const&, MPI_Comm const&);
-template void Hamiltonian::prepareImpl<false>(LOperatorTypeRC<false> const&, MPI_Comm const&);
+template void
+Hamiltonian::prepareImpl<true>(LOperatorTypeRC<true> const&, MPI_Comm const&, HamiltonianPart::StorageEnum);
+template void
+Hamiltonian::prepareImpl<false>(LOperatorTypeRC<false> const&, MPI_Comm const&, HamiltonianPart::StorageEnum);
+
+// An MPI adapter that fully or partially diagonalizes a Hamiltonian part
+struct ComputeWrapHPart {
+    ComputeWrapHPart(HamiltonianPart& part,
+                     InnerQuantumState NumEigenvalues,
+                     RealType Cutoff,
+                     RealType Tolerance,
+                     bool EigenvaluesOnly,
+                     pMPI::CostType complexity = 1)
+        : complexity(complexity),
+          part(part),
+          NumEigenvalues(NumEigenvalues),
+          Cutoff(Cutoff),
+          Tolerance(Tolerance),
+          EigenvaluesOnly(EigenvaluesOnly) {}
 
-template <bool C> void Hamiltonian::computeImpl(MPI_Comm const& comm) {
+    void run() {
+        if(NumEigenvalues == 0 && Cutoff == HUGE_VAL)
+            part.compute(EigenvaluesOnly);
+        else
+            part.computeLowest(NumEigenvalues, Cutoff, Tolerance);
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
+    pMPI::CostType const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+private:
+    HamiltonianPart& part; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    InnerQuantumState NumEigenvalues;
+    RealType Cutoff;
+    RealType Tolerance;
+    bool EigenvaluesOnly;
+};
+
+template <bool C>
+void Hamiltonian::computeImpl(InnerQuantumState NumEigenvalues,
+                              RealType Cutoff,
+                              RealType Tolerance,
+                              bool EigenvaluesOnly,
+                              MPI_Comm const& comm) {
     // Create a "skeleton" class with pointers to part that can call a compute method
-    pMPI::mpi_skel<pMPI::ComputeWrap<HamiltonianPart>> skel;
+    pMPI::mpi_skel<ComputeWrapHPart> skel;
     skel.parts.reserve(parts.size());
     for(auto& part : parts) {
-        skel.parts.emplace_back(part, static_cast<int>(part.getSize()));
+        skel.parts.emplace_back(part, NumEigenvalues, Cutoff, Tolerance, EigenvaluesOnly, part.estimateCost());
     }
     std::map<pMPI::JobId, pMPI::WorkerId> job_map = skel.run(comm, true);
     int comm_rank = pMPI::rank(comm);
@@ -81,41 +160,139 @@ template <bool C> void Hamiltonian::computeImpl(MPI_Comm const& comm) {
     MPI_Datatype H_dt = C ? POMEROL_MPI_DOUBLE_COMPLEX : MPI_DOUBLE;
     for(int p = 0; p < static_cast<int>(parts.size()); ++p) {
         auto& part = parts[p];
-        auto& H = part.getMatrix<C>();
+        part.Owner = job_map[p];
         if(comm_rank == job_map[p]) {
             if(part.getStatus() != HamiltonianPart::Computed) {
                 ERROR("Worker" << comm_rank << " didn't calculate part" << p);
                 throw std::logic_error("Worker didn't calculate this part.");
             }
-            MPI_Bcast(H.data(), H.size(), H_dt, comm_rank, comm);
+            // Number of computed eigenpairs can be smaller than the block size
+            long n_eigen = part.Eigenvalues.size();
+            MPI_Bcast(&n_eigen, 1, MPI_LONG, comm_rank, comm);
+            if(!DistributedEigenvectors && !EigenvaluesOnly) {
+                auto& H = part.getMatrix<C>();
+                MPI_Bcast(H.data(), H.size(), H_dt, comm_rank, comm);
+            }
             MPI_Bcast(part.Eigenvalues.data(), static_cast<int>(part.Eigenvalues.size()), MPI_DOUBLE, comm_rank, comm);
         } else {
-            part.Eigenvalues.resize(H.rows());
-            MPI_Bcast(H.data(), H.size(), H_dt, job_map[p], comm);
+            long n_eigen;
+            MPI_Bcast(&n_eigen, 1, MPI_LONG, job_map[p], comm);
+            part.releaseStorage();
+            part.LazyEigenvectors = EigenvaluesOnly;
+            if(DistributedEigenvectors || EigenvaluesOnly) {
+                part.HMatrix.reset();
+            } else {
+                part.HMatrix = std::make_shared<MatrixType<C>>(part.getSize(), n_eigen);
+                auto& H = part.getMatrix<C>();
+                MPI_Bcast(H.data(), H.size(), H_dt, job_map[p], comm);
+            }
+            part.Eigenvalues.resize(n_eigen);
             MPI_Bcast(part.Eigenvalues.data(), static_cast<int>(part.Eigenvalues.size()), MPI_DOUBLE, job_map[p], comm);
             part.setStatus(HamiltonianPart::Computed);
         }
     }
 }
 
-void Hamiltonian::compute(MPI_Comm const& comm) {
+// Attach locally stored eigenvector matrices to a dynamic MPI window and
+// let all processes know where to find them
+template <bool C> void Hamiltonian::exposeEigenvectors(MPI_Comm const& comm) {
+    int comm_rank = pMPI::rank(comm);
+
+    // Detach from a previously created window, if any
+    for(auto& part : parts)
+        part.Window.reset();
+
+    auto Window = std::shared_ptr<MPI_Win>(new MPI_Win(MPI_WIN_NULL), [](MPI_Win* win) {
+        int finalized;
+        MPI_Finalized(&finalized);
+        if(!finalized && *win != MPI_WIN_NULL)
+            MPI_Win_free(win);
+        delete win;
+    });
+    MPI_Win_create_dynamic(MPI_INFO_NULL, comm, Window.get());
+
+    for(auto& part : parts) {
+        MPI_Aint Address = 0;
+        if(comm_rank == part.Owner && part.HMatrix) {
+            auto& H = part.getMatrix<C>();
+            if(H.size() > 0) {
+                MPI_Win_attach(*Window, H.data(), static_cast<MPI_Aint>(H.size() * sizeof(MelemType<C>)));
+                MPI_Get_address(H.data(), &Address);
+            }
+        }
+        MPI_Bcast(&Address, 1, MPI_AINT, part.Owner, comm);
+        part.RemoteAddress = Address;
+        part.Window = Window;
+    }
+}
+
+void Hamiltonian::compute(MPI_Comm const& comm, bool EigenvaluesOnly) {
+    if(getStatus() >= Computed)
+        return;
+
+    if(Complex)
+        computeImpl<true>(0, HUGE_VAL, 0, EigenvaluesOnly, comm);
+    else
+        computeImpl<false>(0, HUGE_VAL, 0, EigenvaluesOnly, comm);
+
+    computeGroundEnergy();
+
+    if(DistributedEigenvectors) {
+        if(Complex)
+            exposeEigenvectors<true>(comm);
+        else
+            exposeEigenvectors<false>(comm);
+    }
+
+    setStatus(Computed);
+}
+
+void Hamiltonian::computeLowest(InnerQuantumState NumEigenvalues,
+                                RealType Cutoff,
+                                RealType Tolerance,
+                                MPI_Comm const& comm) {
     if(getStatus() >= Computed)
         return;
 
     if(Complex)
-        computeImpl<true>(comm);
+        computeImpl<true>(NumEigenvalues, Cutoff, Tolerance, false, comm);
     else
-        computeImpl<false>(comm);
+        computeImpl<false>(NumEigenvalues, Cutoff, Tolerance, false, comm);
 
     computeGroundEnergy();
 
+    // Parts have been truncated w.r.t. their own lowest eigenvalues,
+    // now truncate them w.r.t. the ground state energy.
+    if(Cutoff != HUGE_VAL) {
+        for(auto& part : parts)
+            part.reduce(GroundEnergy + Cutoff);
+    }
+
+    if(DistributedEigenvectors) {
+        if(Complex)
+            exposeEigenvectors<true>(comm);
+        else
+            exposeEigenvectors<false>(comm);
+    }
+
     setStatus(Computed);
 }
 
-void Hamiltonian::reduce(RealType Cutoff) {
+void Hamiltonian::reduce(RealType Cutoff, MPI_Comm const& comm) {
     INFO("Performing EV cutoff at " << Cutoff << " level");
+    // Eigenvector matrices are going to be reallocated, so they must be detached from the MPI window first
+    for(auto& part : parts)
+        part.Window.reset();
+
     for(auto& part : parts)
         part.reduce(GroundEnergy + Cutoff);
+
+    if(DistributedEigenvectors) {
+        if(Complex)
+            exposeEigenvectors<true>(comm);
+        else
+            exposeEigenvectors<false>(comm);
+    }
 }
 
 InnerQuantumState Hamiltonian::getBlockSize(BlockNumber Block) const {
@@ -138,7 +315,10 @@ RealVectorType const& Hamiltonian::getEigenValues(BlockNumber Block) const {
 }
 
 RealVectorType Hamiltonian::getEigenValues() const {
-    RealVectorType out(S.getNumberOfStates());
+    long total_size = 0;
+    for(auto const& part : parts)
+        total_size += part.getEigenValues().size();
+    RealVectorType out(total_size);
     long copied_size = 0;
     for(auto const& part : parts) {
         auto const& ev = part.getEigenValues();
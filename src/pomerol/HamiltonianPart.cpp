@@ -18,15 +18,20 @@
 // clang-format off
 #include <libcommute/loperator/state_vector_eigen3.hpp>
 #include <libcommute/loperator/mapped_basis_view.hpp>
+#include <libcommute/loperator/sparse_state_vector.hpp>
 // clang-format on
 
 #include <Eigen/Eigenvalues>
 
+#include <algorithm>
 #include <cassert>
 #include <complex>
 #include <limits>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace Pomerol {
 
@@ -54,6 +59,15 @@ void HamiltonianPart::prepare() {
 }
 
 template <bool C> void HamiltonianPart::prepareImpl() {
+    switch(Storage) {
+    case SparseStorage: prepareSparseImpl<C>(); return;
+    case MatrixFreeStorage:
+        initMapper();
+        Diagonal = getDiagonal<C>();
+        return;
+    default: break;
+    }
+
     initHMatrix<C>();
 
     auto const& HOp_ = *static_cast<LOperatorTypeRC<C> const*>(HOp);
@@ -75,21 +89,192 @@ template <bool C> void HamiltonianPart::prepareImpl() {
     assert((HMatrix_.adjoint() - HMatrix_).array().abs().maxCoeff() < 100 * std::numeric_limits<RealType>::epsilon());
 }
 
-void HamiltonianPart::compute() {
+// Call f(row, col, value) for every non-zero matrix element of this block.
+// Columns are processed in parallel, so f must be safe to call concurrently for distinct columns.
+template <bool C, typename F> void HamiltonianPart::foreachElement(F&& f) const {
+    auto const& HOp_ = *static_cast<LOperatorTypeRC<C> const*>(HOp);
+    auto const& FockStates = S.getFockStates(Block);
+    QuantumState FullDim = S.getNumberOfStates();
+
+    std::unordered_map<QuantumState, Eigen::Index> InnerStates;
+    InnerStates.reserve(FockStates.size());
+    for(std::size_t st = 0; st < FockStates.size(); ++st)
+        InnerStates.emplace(FockStates[st], st);
+
+    auto BlockSize = static_cast<Eigen::Index>(FockStates.size());
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for(Eigen::Index st = 0; st < BlockSize; ++st) {
+        libcommute::sparse_state_vector<MelemType<C>> ket(FullDim);
+        libcommute::sparse_state_vector<MelemType<C>> bra(FullDim);
+        ket[FockStates[st]] = 1.0;
+        HOp_(ket, bra);
+        foreach(bra, [&](QuantumState n, MelemType<C> const& a) { f(InnerStates.at(n), st, a); });
+    }
+}
+
+template <bool C> void HamiltonianPart::prepareSparseImpl() {
+    auto BlockSize = static_cast<Eigen::Index>(S.getBlockSize(Block));
+
+    // Non-zero elements are collected column by column and then assembled into a CSR matrix
+    using ElementType = std::pair<Eigen::Index, MelemType<C>>;
+    std::vector<std::vector<ElementType>> Columns(BlockSize);
+    foreachElement<C>([&Columns](Eigen::Index row, Eigen::Index col, MelemType<C> const& a) {
+        if(a != MelemType<C>(0))
+            Columns[col].emplace_back(row, a);
+    });
+
+    std::vector<Eigen::Triplet<MelemType<C>>> Triplets;
+    std::size_t NNZ = 0;
+    for(auto const& Col : Columns)
+        NNZ += Col.size();
+    Triplets.reserve(NNZ);
+    for(Eigen::Index col = 0; col < BlockSize; ++col) {
+        for(auto const& el : Columns[col])
+            Triplets.emplace_back(el.first, col, el.second);
+        std::vector<ElementType>().swap(Columns[col]);
+    }
+
+    auto HSparseMatrix_ = std::make_shared<RowMajorMatrixType<C>>(BlockSize, BlockSize);
+    HSparseMatrix_->setFromTriplets(Triplets.begin(), Triplets.end());
+    HSparseMatrix_->makeCompressed();
+    HSparseMatrix = HSparseMatrix_;
+}
+
+template <bool C> RealVectorType HamiltonianPart::getDiagonal() const {
+    switch(Storage) {
+    case DenseStorage: return getMatrix<C>().diagonal().real();
+    case SparseStorage: return getSparseMatrix<C>().diagonal().real();
+    default: break;
+    }
+    if(Diagonal.size() == static_cast<Eigen::Index>(getSize()))
+        return Diagonal;
+
+    RealVectorType D = RealVectorType::Zero(getSize());
+    foreachElement<C>([&D](Eigen::Index row, Eigen::Index col, MelemType<C> const& a) {
+        if(row == col)
+            D(row) = std::real(a);
+    });
+    return D;
+}
+
+template <bool C> void HamiltonianPart::apply(DavidsonBlockType<C> const& X, DavidsonBlockType<C>& Y) const {
+    if(getStatus() != Prepared)
+        throw StatusMismatch("HamiltonianPart can be applied to vectors only in the prepared state.");
+
+    switch(Storage) {
+    case DenseStorage: Y.noalias() = getMatrix<C>() * X; return;
+    case SparseStorage: Y.noalias() = getSparseMatrix<C>() * X; return;
+    default: break;
+    }
+
+    auto const& HOp_ = *static_cast<LOperatorTypeRC<C> const*>(HOp);
+    auto const& mapper = *std::static_pointer_cast<libcommute::basis_mapper const>(Mapper);
+
+    Y.resize(X.rows(), X.cols());
+    auto NumVectors = X.cols();
+#ifdef POMEROL_USE_OPENMP
+    int NumThreads = omp_get_max_threads();
+#else
+    int NumThreads = 1;
+#endif
+
+    if(NumVectors >= NumThreads) {
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(Eigen::Index v = 0; v < NumVectors; ++v) {
+            auto ket_view = mapper.make_const_view(X.col(v));
+            auto bra_view = mapper.make_view(Y.col(v));
+            HOp_(ket_view, bra_view);
+        }
+        return;
+    }
+
+    // There are fewer vectors than threads. Each thread applies the operator to the components of a vector
+    // in its own range of basis states, and the partial results are then summed over the threads row by row.
+    using VectorType = Eigen::Matrix<MelemType<C>, Eigen::Dynamic, 1>;
+    Eigen::Index Size = X.rows();
+    std::vector<VectorType> Partial(static_cast<std::size_t>(NumThreads));
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel num_threads(NumThreads)
+#endif
+    {
+#ifdef POMEROL_USE_OPENMP
+        int Thread = omp_get_thread_num();
+        int TeamSize = omp_get_num_threads();
+#else
+        int Thread = 0;
+        int TeamSize = 1;
+#endif
+        Eigen::Index First = Size * Thread / TeamSize;
+        Eigen::Index Last = Size * (Thread + 1) / TeamSize;
+        VectorType Ket = VectorType::Zero(Size);
+        VectorType& Bra = Partial[Thread];
+        Bra.resize(Size);
+        for(Eigen::Index v = 0; v < NumVectors; ++v) {
+            Ket.segment(First, Last - First) = X.col(v).segment(First, Last - First);
+            auto ket_view = mapper.make_const_view(Ket);
+            auto bra_view = mapper.make_view(Bra);
+            HOp_(ket_view, bra_view);
+#ifdef POMEROL_USE_OPENMP
+#pragma omp barrier
+#endif
+            auto YSegment = Y.col(v).segment(First, Last - First);
+            YSegment = Partial[0].segment(First, Last - First);
+            for(int t = 1; t < TeamSize; ++t)
+                YSegment += Partial[t].segment(First, Last - First);
+#ifdef POMEROL_USE_OPENMP
+#pragma omp barrier
+#endif
+        }
+    }
+}
+template void HamiltonianPart::apply<true>(DavidsonBlockType<true> const&, DavidsonBlockType<true>&) const;
+template void HamiltonianPart::apply<false>(DavidsonBlockType<false> const&, DavidsonBlockType<false>&) const;
+
+// Convert the sparse or the matrix-free representation into a dense matrix
+template <bool C> void HamiltonianPart::makeDense() {
+    if(Storage == DenseStorage || HMatrix)
+        return;
+
+    if(Storage == SparseStorage) {
+        HMatrix = std::make_shared<MatrixType<C>>(getSparseMatrix<C>());
+    } else {
+        auto BlockSize = getSize();
+        auto HMatrix_ = std::make_shared<MatrixType<C>>(MatrixType<C>::Zero(BlockSize, BlockSize));
+        foreachElement<C>(
+            [&HMatrix_](Eigen::Index row, Eigen::Index col, MelemType<C> const& a) { (*HMatrix_)(row, col) = a; });
+        HMatrix = HMatrix_;
+    }
+}
+
+void HamiltonianPart::compute(bool EigenvaluesOnly) {
     if(getStatus() >= Computed)
         return;
 
     if(isComplex())
-        computeImpl<true>();
+        computeImpl<true>(EigenvaluesOnly);
     else
-        computeImpl<false>();
+        computeImpl<false>(EigenvaluesOnly);
 
     setStatus(Computed);
 }
 
-template <bool C> void HamiltonianPart::computeImpl() {
+template <bool C> void HamiltonianPart::computeImpl(bool EigenvaluesOnly) {
+    makeDense<C>();
+    releaseStorage();
+
     auto& HMatrix_ = getMatrix<C>();
-    if(HMatrix_.rows() == 1) {
+    if(EigenvaluesOnly) {
+        // Householder tridiagonalization followed by the implicit QR iteration without accumulation
+        // of the transformations
+        Eigen::SelfAdjointEigenSolver<MatrixType<C>> Solver(HMatrix_, Eigen::EigenvaluesOnly);
+        Eigenvalues = Solver.eigenvalues();
+        HMatrix.reset();
+        LazyEigenvectors = true;
+    } else if(HMatrix_.rows() == 1) {
         assert(std::abs(HMatrix_(0, 0) - std::real(HMatrix_(0, 0))) < std::numeric_limits<RealType>::epsilon());
         Eigenvalues.resize(1);
         Eigenvalues << std::real(HMatrix_(0, 0));
@@ -101,9 +286,92 @@ template <bool C> void HamiltonianPart::computeImpl() {
     }
 }
 
+void HamiltonianPart::computeLowest(InnerQuantumState NumEigenvalues, RealType Cutoff, RealType Tolerance) {
+    if(getStatus() >= Computed)
+        return;
+
+    if(isComplex())
+        computeLowestImpl<true>(NumEigenvalues, Cutoff, Tolerance);
+    else
+        computeLowestImpl<false>(NumEigenvalues, Cutoff, Tolerance);
+
+    setStatus(Computed);
+}
+
+template <bool C>
+void HamiltonianPart::computeLowestImpl(InnerQuantumState NumEigenvalues, RealType Cutoff, RealType Tolerance) {
+    // Number of eigenpairs to start with when only the energy cutoff is given
+    constexpr Eigen::Index InitialNumEigenvalues = 16;
+    // Maximal number of Davidson iterations
+    constexpr unsigned int MaxIterations = 1000;
+
+    auto BlockSize = static_cast<Eigen::Index>(getSize());
+    Eigen::Index MaxNumEigenvalues =
+        NumEigenvalues ? std::min(static_cast<Eigen::Index>(NumEigenvalues), BlockSize) : BlockSize;
+
+    Eigen::Index NEV = NumEigenvalues ? MaxNumEigenvalues : std::min(InitialNumEigenvalues, MaxNumEigenvalues);
+    RealVectorType Diagonal_ = getDiagonal<C>();
+    auto HOp_ = [this](DavidsonBlockType<C> const& X, DavidsonBlockType<C>& Y) { apply<C>(X, Y); };
+
+    while(true) {
+        // The dense solver is faster when a sizable fraction of the spectrum is requested
+        if(4 * NEV >= BlockSize) {
+            computeImpl<C>(false);
+            break;
+        }
+
+        MatrixType<C> Eigenvectors;
+        davidsonLowest<C>(HOp_, Diagonal_, NEV, Tolerance, MaxIterations, Eigenvalues, Eigenvectors);
+        // Request more eigenpairs if some of the missing ones can still be below the cutoff
+        if(NEV == MaxNumEigenvalues || Eigenvalues(NEV - 1) > Eigenvalues(0) + Cutoff) {
+            HMatrix = std::make_shared<MatrixType<C>>(std::move(Eigenvectors));
+            releaseStorage();
+            break;
+        }
+        NEV = std::min(2 * NEV, MaxNumEigenvalues);
+    }
+
+    Eigen::Index counter = 0;
+    for(; counter < std::min(Eigenvalues.size(), MaxNumEigenvalues) && Eigenvalues[counter] <= Eigenvalues(0) + Cutoff;
+        ++counter)
+        ;
+    truncateImpl<C>(counter);
+}
+
+template <bool C> void HamiltonianPart::truncateImpl(Eigen::Index NumEigenvalues) {
+    Eigenvalues.conservativeResize(NumEigenvalues);
+    // Eigenvectors are stored on another process
+    if(!HMatrix)
+        return;
+    auto& HMatrix_ = getMatrix<C>();
+    HMatrix_ = HMatrix_.leftCols(NumEigenvalues).eval();
+}
+
+void HamiltonianPart::initMapper() {
+    Mapper = std::make_shared<libcommute::basis_mapper>(S.getFockStates(Block));
+}
+
+void HamiltonianPart::releaseStorage() {
+    HSparseMatrix.reset();
+    Mapper.reset();
+    Diagonal.resize(0);
+}
+
+template <bool C> RowMajorMatrixType<C> const& HamiltonianPart::getSparseMatrix() const {
+    if(C != isComplex())
+        throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    if(!HSparseMatrix)
+        throw std::runtime_error("Sparse matrix is not available");
+    return *std::static_pointer_cast<RowMajorMatrixType<C> const>(HSparseMatrix);
+}
+template RowMajorMatrixType<true> const& HamiltonianPart::getSparseMatrix<true>() const;
+template RowMajorMatrixType<false> const& HamiltonianPart::getSparseMatrix<false>() const;
+
 template <bool C> MatrixType<C> const& HamiltonianPart::getMatrix() const {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    if(!HMatrix)
+        throw std::runtime_error("Dense matrix is not available");
     return *std::static_pointer_cast<MatrixType<C> const>(HMatrix);
 }
 template MatrixType<true> const& HamiltonianPart::getMatrix<true>() const;
@@ -112,6 +380,8 @@ template MatrixType<false> const& HamiltonianPart::getMatrix<false>() const;
 template <bool C> MatrixType<C>& HamiltonianPart::getMatrix() {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    if(!HMatrix)
+        throw std::runtime_error("Dense matrix is not available");
     return *std::static_pointer_cast<MatrixType<C>>(HMatrix);
 }
 template MatrixType<true>& HamiltonianPart::getMatrix<true>();
@@ -136,9 +406,64 @@ InnerQuantumState HamiltonianPart::getSize() const {
     return S.getBlockSize(Block);
 }
 
+InnerQuantumState HamiltonianPart::getNumberOfEigenValues() const {
+    checkComputed();
+    return static_cast<InnerQuantumState>(Eigenvalues.size());
+}
+
+// Rebuild the matrix of this block and compute the eigenvectors
+template <bool C> void HamiltonianPart::computeEigenvectorsImpl() const {
+    auto BlockSize = getSize();
+    MatrixType<C> HMatrix_ = MatrixType<C>::Zero(BlockSize, BlockSize);
+    foreachElement<C>([&HMatrix_](Eigen::Index row, Eigen::Index col, MelemType<C> const& a) { HMatrix_(row, col) = a; });
+
+    Eigen::SelfAdjointEigenSolver<MatrixType<C>> Solver(HMatrix_, Eigen::ComputeEigenvectors);
+    // Some of the eigenvalues may have been discarded by reduce()
+    HMatrix = std::make_shared<MatrixType<C>>(Solver.eigenvectors().leftCols(Eigenvalues.size()));
+}
+
+template <bool C> std::shared_ptr<MatrixType<C> const> HamiltonianPart::fetchMatrix() const {
+    checkComputed();
+    if(C != isComplex())
+        throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    if(LazyEigenvectors) {
+        std::shared_ptr<MatrixType<C> const> Result;
+#ifdef POMEROL_USE_OPENMP
+#pragma omp critical(HamiltonianPartLazyEigenvectors)
+#endif
+        {
+            if(!HMatrix)
+                computeEigenvectorsImpl<C>();
+            Result = std::static_pointer_cast<MatrixType<C> const>(HMatrix);
+        }
+        return Result;
+    }
+    if(HMatrix)
+        return std::static_pointer_cast<MatrixType<C> const>(HMatrix);
+    if(!Window)
+        throw std::runtime_error("Eigenvectors of this block are not available");
+
+    auto Fetched = std::make_shared<MatrixType<C>>(getSize(), Eigenvalues.size());
+    MPI_Datatype H_dt = C ? POMEROL_MPI_DOUBLE_COMPLEX : MPI_DOUBLE;
+
+    // MPI_Get() accepts an int element count, so large matrices are fetched in chunks
+    constexpr Eigen::Index ChunkSize = std::numeric_limits<int>::max();
+    MPI_Win_lock(MPI_LOCK_SHARED, Owner, 0, *Window);
+    for(Eigen::Index Offset = 0; Offset < Fetched->size(); Offset += ChunkSize) {
+        int Count = static_cast<int>(std::min(ChunkSize, Fetched->size() - Offset));
+        MPI_Aint Displacement = RemoteAddress + static_cast<MPI_Aint>(Offset * sizeof(MelemType<C>));
+        MPI_Get(Fetched->data() + Offset, Count, H_dt, Owner, Displacement, Count, H_dt, *Window);
+    }
+    MPI_Win_unlock(Owner, *Window);
+
+    return Fetched;
+}
+template std::shared_ptr<MatrixType<true> const> HamiltonianPart::fetchMatrix<true>() const;
+template std::shared_ptr<MatrixType<false> const> HamiltonianPart::fetchMatrix<false>() const;
+
 template <bool C> VectorType<C> HamiltonianPart::getEigenState(InnerQuantumState state) const {
     checkComputed();
-    return getMatrix<C>().col(state);
+    return fetchMatrix<C>()->col(state);
 }
 template VectorType<true> HamiltonianPart::getEigenState<true>(InnerQuantumState) const;
 template VectorType<false> HamiltonianPart::getEigenState<false>(InnerQuantumState) const;
@@ -158,14 +483,10 @@ bool HamiltonianPart::reduce(RealType Cutoff) {
 
     if(counter) {
         INFO(Eigenvalues.head(counter) << "\n_________");
-        Eigenvalues = Eigenvalues.head(counter);
-        if(isComplex()) {
-            auto& HMatrix_ = getMatrix<true>();
-            HMatrix_ = HMatrix_.topLeftCorner(counter, counter);
-        } else {
-            auto& HMatrix_ = getMatrix<false>();
-            HMatrix_ = HMatrix_.topLeftCorner(counter, counter);
-        }
+        if(isComplex())
+            truncateImpl<true>(counter);
+        else
+            truncateImpl<false>(counter);
         return true;
     } else
         return false;
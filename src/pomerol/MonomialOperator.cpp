@@ -15,7 +15,10 @@
 
 #include "pomerol/MonomialOperator.hpp"
 
+#include "mpi_dispatcher/mpi_skel.hpp"
+
 #include <cstdlib>
+#include <map>
 
 namespace Pomerol {
 
@@ -30,17 +33,61 @@ MonomialOperator::BlocksBimap const& MonomialOperator::getBlockMapping() const {
     return LeftRightBlocks;
 }
 
+// An MPI adapter that computes matrix elements of a monomial operator part
+struct ComputeWrapMOPart {
+    ComputeWrapMOPart(MonomialOperatorPart& part,
+                      RealType Tolerance,
+                      RealType DenseFillThreshold,
+                      pMPI::CostType complexity = 1)
+        : complexity(complexity), part(part), Tolerance(Tolerance), DenseFillThreshold(DenseFillThreshold) {}
+
+    void run() { part.compute(Tolerance, DenseFillThreshold); }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
+    pMPI::CostType const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+private:
+    MonomialOperatorPart& part; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    RealType Tolerance;
+    RealType DenseFillThreshold;
+};
+
+void MonomialOperator::computeParts(std::vector<MonomialOperatorPart*> const& Parts,
+                                    RealType Tolerance,
+                                    MPI_Comm const& comm,
+                                    RealType DenseFillThreshold) {
+    pMPI::mpi_skel<ComputeWrapMOPart> skel;
+    skel.parts.reserve(Parts.size());
+    for(int p = 0; p < static_cast<int>(Parts.size()); ++p) {
+        MonomialOperatorPart& part = *Parts[p];
+        skel.parts.emplace_back(part, Tolerance, DenseFillThreshold, part.estimateCost());
+        // With distributed eigenvectors, compute the part on the process storing the larger of the two
+        // eigenvector matrices, so that only the smaller one has to be fetched
+        if(part.HFrom.hasDistributedEigenvectors()) {
+            double SizeFrom = static_cast<double>(part.HFrom.getSize()) * part.HFrom.getNumberOfEigenValues();
+            double SizeTo = static_cast<double>(part.HTo.getSize()) * part.HTo.getNumberOfEigenValues();
+            skel.affinity[p] = SizeTo > SizeFrom ? part.HTo.getOwner() : part.HFrom.getOwner();
+        }
+    }
+    skel.strict_affinity = true;
+    std::map<pMPI::JobId, pMPI::WorkerId> job_map = skel.run(comm, false);
+
+    for(int p = 0; p < static_cast<int>(Parts.size()); ++p) {
+        Parts[p]->Owner = job_map[p];
+        Parts[p]->broadcast(comm, job_map[p]);
+    }
+}
+
 void MonomialOperator::compute(RealType Tolerance, MPI_Comm const& comm) {
     checkPrepared();
     if(getStatus() >= Computed)
         return;
 
-    std::size_t Size = parts.size();
-    for(std::size_t BlockIn = 0; BlockIn < Size; BlockIn++) {
-        INFO_NONEWLINE((int)((1.0 * BlockIn / Size) * 100) << "  " << std::flush);
-        parts[BlockIn].compute(Tolerance);
-    };
-    std::cout << '\n';
+    std::vector<MonomialOperatorPart*> Parts;
+    Parts.reserve(parts.size());
+    for(auto& part : parts)
+        Parts.push_back(&part);
+    computeParts(Parts, Tolerance, comm);
 
     setStatus(Computed);
 }
@@ -16,36 +16,37 @@
 
 #include "pomerol/MonomialOperatorPart.hpp"
 
-// clang-format off
-#include <libcommute/loperator/state_vector_eigen3.hpp>
-#include <libcommute/loperator/mapped_basis_view.hpp>
-// clang-format on
+#include <libcommute/loperator/sparse_state_vector.hpp>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
 #include <cstddef>
 #include <iostream>
 #include <stdexcept>
+#include <unordered_map>
 #include <vector>
 
 namespace Pomerol {
 
-void MonomialOperatorPart::compute(RealType Tolerance) {
+void MonomialOperatorPart::compute(RealType Tolerance, RealType DenseFillThreshold) {
     if(getStatus() >= Computed)
         return;
 
     if(MOpComplex && HFrom.isComplex())
-        computeImpl<true, true>(Tolerance);
+        computeImpl<true, true>(Tolerance, DenseFillThreshold);
     else if(MOpComplex && !HFrom.isComplex())
-        computeImpl<true, false>(Tolerance);
+        computeImpl<true, false>(Tolerance, DenseFillThreshold);
     else if(!MOpComplex && HFrom.isComplex())
-        computeImpl<false, true>(Tolerance);
+        computeImpl<false, true>(Tolerance, DenseFillThreshold);
     else
-        computeImpl<false, false>(Tolerance);
+        computeImpl<false, false>(Tolerance, DenseFillThreshold);
 
     setStatus(Computed);
 }
 
-template <bool MOpC, bool HC> void MonomialOperatorPart::computeImpl(RealType Tolerance) {
+template <bool MOpC, bool HC> void MonomialOperatorPart::computeImpl(RealType Tolerance, RealType DenseFillThreshold) {
     constexpr bool C = MOpC || HC;
 
     BlockNumber to = HTo.getBlockNumber();
@@ -57,24 +58,49 @@ template <bool MOpC, bool HC> void MonomialOperatorPart::computeImpl(RealType To
     /* Rotation is done in the following way:
     * O_{nm} = \sum_{lk} U^{+}_{nl} O_{lk} U_{km} = \sum_{lk} U^{*}_{ln}O_{lk}U_{km},
     * where the actual sum starts from k state. Big letters denote global states, smaller - InnerQuantumStates.
-    * We use the fact each column of O_{lk} has only one nonzero elements.
+    * A monomial maps each basis state k to at most one basis state l, so O_{lk} is a permutation matrix with
+    * weights (signs for fermions). It is found once, and O U is formed by gathering rows of U.
+    * U can be a rectangular matrix if only some of the eigenvectors have been computed.
+    * U is fetched from another MPI process if the Hamiltonian is stored in the distributed mode.
     * */
-    MatrixType<C> OURight(toStates.size(), fromStates.size());
+    auto const& MOp_ = *static_cast<LOperatorTypeRC<MOpC> const*>(MOp);
+    QuantumState FullDim = S.getNumberOfStates();
 
-    auto fromMapper = libcommute::basis_mapper(fromStates);
-    auto toMapper = libcommute::basis_mapper(toStates);
+    std::unordered_map<QuantumState, Eigen::Index> toInnerStates;
+    toInnerStates.reserve(toStates.size());
+    for(std::size_t st = 0; st < toStates.size(); ++st)
+        toInnerStates.emplace(toStates[st], st);
 
-    auto const& U = HFrom.getMatrix<HC>();
+    // Target state l and weight O_{lk} for each state k of the right subspace (-1 if O_{lk} vanishes for all l)
+    auto NumFromStates = static_cast<Eigen::Index>(fromStates.size());
+    std::vector<Eigen::Index> Targets(fromStates.size(), -1);
+    std::vector<MelemType<MOpC>> Weights(fromStates.size(), 0);
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for(Eigen::Index st = 0; st < NumFromStates; ++st) {
+        libcommute::sparse_state_vector<MelemType<MOpC>> ket(FullDim);
+        libcommute::sparse_state_vector<MelemType<MOpC>> bra(FullDim);
+        ket[fromStates[st]] = 1.0;
+        MOp_(ket, bra);
+        foreach(bra, [&](QuantumState n, MelemType<MOpC> const& a) {
+            assert(Targets[st] == -1);
+            Targets[st] = toInnerStates.at(n);
+            Weights[st] = a;
+        });
+    }
 
-    auto const& MOp_ = *static_cast<LOperatorTypeRC<MOpC> const*>(MOp);
+    auto UFrom = HFrom.fetchMatrix<HC>();
+    auto const& U = *UFrom;
 
-    for(InnerQuantumState st = 0; st < fromStates.size(); ++st) {
-        auto fromView = fromMapper.make_const_view(U.col(st));
-        auto toView = toMapper.make_view(OURight.col(st));
-        MOp_(fromView, toView);
+    MatrixType<C> OURight = MatrixType<C>::Zero(toStates.size(), U.cols());
+    for(Eigen::Index st = 0; st < NumFromStates; ++st) {
+        if(Targets[st] >= 0)
+            OURight.row(Targets[st]) += MelemType<C>(Weights[st]) * U.row(st).template cast<MelemType<C>>();
     }
 
-    auto const& ULeft = HTo.getMatrix<HC>().adjoint();
+    auto UTo = HTo.fetchMatrix<HC>();
+    auto const& ULeft = UTo->adjoint();
 
 // Workaround for Eigen issue 1224
 // https://gitlab.com/libeigen/eigen/-/issues/1224
@@ -82,16 +108,89 @@ template <bool MOpC, bool HC> void MonomialOperatorPart::computeImpl(RealType To
 // Affected versions are some betas of 3.3 but not the 3.3 release
 // cppcheck-suppress syntaxError
 #if EIGEN_VERSION_AT_LEAST(3, 2, 90) && EIGEN_MAJOR_VERSION < 3
-    elementsRowMajor = std::make_shared<RowMajorMatrixType<C>>(MatrixType<C>(ULeft * OURight).sparseView(Tolerance));
+    auto RowMajor = std::make_shared<RowMajorMatrixType<C>>(MatrixType<C>(ULeft * OURight).sparseView(Tolerance));
 #else
-    elementsRowMajor = std::make_shared<RowMajorMatrixType<C>>((ULeft * OURight).sparseView(Tolerance));
+    auto RowMajor = std::make_shared<RowMajorMatrixType<C>>((ULeft * OURight).sparseView(Tolerance));
 #endif
 
-    elementsColMajor = std::make_shared<ColMajorMatrixType<C>>(
-        *std::static_pointer_cast<RowMajorMatrixType<C> const>(elementsRowMajor));
+    // Well-filled blocks are stored densely, keeping only the non-negligible elements
+    auto Size = static_cast<RealType>(RowMajor->rows()) * static_cast<RealType>(RowMajor->cols());
+    if(Size > 0 && static_cast<RealType>(RowMajor->nonZeros()) > DenseFillThreshold * Size) {
+        elementsDense = std::make_shared<MatrixType<C>>(RowMajor->toDense());
+        Dense = true;
+    } else {
+        elementsRowMajor = RowMajor;
+        elementsColMajor = std::make_shared<ColMajorMatrixType<C>>(*RowMajor);
+    }
+}
+
+double MonomialOperatorPart::estimateCost() const {
+    double NLeft = std::max<double>(HTo.getNumberOfEigenValues(), 1);
+    double NRight = std::max<double>(HFrom.getNumberOfEigenValues(), 1);
+    return NLeft * static_cast<double>(HTo.getSize()) * NRight;
+}
+
+void MonomialOperatorPart::broadcast(MPI_Comm const& comm, int root) {
+    if(isComplex())
+        broadcastImpl<true>(comm, root);
+    else
+        broadcastImpl<false>(comm, root);
+}
+
+template <bool C> void MonomialOperatorPart::broadcastImpl(MPI_Comm const& comm, int root) {
+    bool is_root = pMPI::rank(comm) == root;
+    if(is_root && getStatus() < Computed)
+        throw StatusMismatch("MonomialOperatorPart: Cannot broadcast an uncomputed part.");
+    if(SharedWithAdjoint)
+        throw std::runtime_error("MonomialOperatorPart: Cannot broadcast a part sharing matrices with its adjoint.");
+
+    MPI_Datatype M_dt = C ? POMEROL_MPI_DOUBLE_COMPLEX : MPI_DOUBLE;
+
+    // Dimensions of the matrix, the number of non-zero elements of the row-major matrix
+    // and whether the matrix is stored densely
+    std::array<long, 4> Sizes = {0, 0, 0, 0};
+    if(is_root) {
+        if(Dense) {
+            auto const& M = getDenseValue<C>();
+            Sizes = {static_cast<long>(M.rows()), static_cast<long>(M.cols()), 0, 1};
+        } else {
+            auto& M = getRowMajorValue<C>();
+            M.makeCompressed();
+            Sizes = {static_cast<long>(M.rows()), static_cast<long>(M.cols()), static_cast<long>(M.nonZeros()), 0};
+        }
+    }
+    MPI_Bcast(Sizes.data(), 4, MPI_LONG, root, comm);
+
+    if(Sizes[3]) {
+        if(!is_root) {
+            elementsDense = std::make_shared<MatrixType<C>>(Sizes[0], Sizes[1]);
+            Dense = true;
+        }
+        auto& M = *std::static_pointer_cast<MatrixType<C>>(elementsDense);
+        MPI_Bcast(M.data(), static_cast<int>(M.size()), M_dt, root, comm);
+        if(!is_root)
+            setStatus(Computed);
+        return;
+    }
+
+    if(!is_root) {
+        auto M = std::make_shared<RowMajorMatrixType<C>>(Sizes[0], Sizes[1]);
+        M->resizeNonZeros(Sizes[2]);
+        elementsRowMajor = M;
+    }
+
+    auto& M = getRowMajorValue<C>();
+    MPI_Bcast(M.outerIndexPtr(), static_cast<int>(M.outerSize() + 1), MPI_INT, root, comm);
+    MPI_Bcast(M.innerIndexPtr(), static_cast<int>(Sizes[2]), MPI_INT, root, comm);
+    MPI_Bcast(M.valuePtr(), static_cast<int>(Sizes[2]), M_dt, root, comm);
+
+    if(!is_root) {
+        elementsColMajor = std::make_shared<ColMajorMatrixType<C>>(M);
+        setStatus(Computed);
+    }
 }
 
-void MonomialOperatorPart::setFromAdjoint(MonomialOperatorPart const& part) {
+void MonomialOperatorPart::setFromAdjoint(MonomialOperatorPart const& part, bool Share) {
     assert(isComplex() == part.isComplex());
     assert(getLeftIndex() == part.getRightIndex());
     assert(getRightIndex() == part.getLeftIndex());
@@ -99,20 +198,195 @@ void MonomialOperatorPart::setFromAdjoint(MonomialOperatorPart const& part) {
     if(getStatus() >= Computed)
         return;
 
-    if(isComplex()) {
-        elementsRowMajor = std::make_shared<RowMajorMatrixType<true>>(part.getColMajorValue<true>().adjoint());
-        elementsColMajor = std::make_shared<ColMajorMatrixType<true>>(part.getRowMajorValue<true>().adjoint());
+    part.ensureComputed();
+    if(part.Dense) {
+        if(isComplex())
+            elementsDense = std::make_shared<MatrixType<true>>(part.getDenseValue<true>().adjoint());
+        else
+            elementsDense = std::make_shared<MatrixType<false>>(part.getDenseValue<false>().adjoint());
+        Dense = true;
+    } else if(Share && !part.SharedWithAdjoint) {
+        // The row-major storage of the adjoint matrix is the column-major storage of 'part' and vice versa
+        elementsRowMajor = part.elementsColMajor;
+        elementsColMajor = part.elementsRowMajor;
+        SharedWithAdjoint = true;
+        if(isComplex()) {
+            auto conjValues = [](MelemType<true> const* Values, Eigen::Index NNZ) {
+                std::vector<ComplexType> ConjValues(static_cast<std::size_t>(NNZ));
+                for(std::size_t n = 0; n < ConjValues.size(); ++n)
+                    ConjValues[n] = std::conj(Values[n]);
+                return ConjValues;
+            };
+            auto const& RowMajor = part.getRowMajorValue<true>();
+            auto const& ColMajor = part.getColMajorValue<true>();
+            ConjValuesColMajor = conjValues(RowMajor.valuePtr(), RowMajor.nonZeros());
+            ConjValuesRowMajor = conjValues(ColMajor.valuePtr(), ColMajor.nonZeros());
+        }
+    } else if(isComplex()) {
+        elementsRowMajor = std::make_shared<RowMajorMatrixType<true>>(part.getColMajorView<true>().adjoint());
+        elementsColMajor = std::make_shared<ColMajorMatrixType<true>>(part.getRowMajorView<true>().adjoint());
     } else {
-        elementsRowMajor = std::make_shared<RowMajorMatrixType<false>>(part.getColMajorValue<false>().adjoint());
-        elementsColMajor = std::make_shared<ColMajorMatrixType<false>>(part.getRowMajorValue<false>().adjoint());
+        elementsRowMajor = std::make_shared<RowMajorMatrixType<false>>(part.getColMajorView<false>().adjoint());
+        elementsColMajor = std::make_shared<ColMajorMatrixType<false>>(part.getRowMajorView<false>().adjoint());
     }
 
     setStatus(Computed);
 }
 
+void MonomialOperatorPart::computeLazily(RealType Tolerance,
+                                         MonomialOperatorPart const* Adjoint,
+                                         bool Share,
+                                         RealType DenseFillThreshold) {
+    if(getStatus() >= Computed)
+        return;
+
+    assert(!Adjoint || (getLeftIndex() == Adjoint->getRightIndex() && getRightIndex() == Adjoint->getLeftIndex()));
+    Lazy = true;
+    LazyTolerance = Tolerance;
+    LazyDenseFillThreshold = DenseFillThreshold;
+    LazyAdjoint = Adjoint;
+    LazyShare = Share;
+}
+
+void MonomialOperatorPart::ensureComputed() const {
+    if(!isPending())
+        return;
+
+    // Computation on first access does not change the observable state of the part
+    auto& self = const_cast<MonomialOperatorPart&>(*this);
+    if(LazyAdjoint)
+        self.setFromAdjoint(*LazyAdjoint, LazyShare);
+    else
+        self.compute(LazyTolerance, LazyDenseFillThreshold);
+}
+
+Eigen::Index MonomialOperatorPart::getNonZeros() const {
+    ensureComputed();
+    if(Dense) {
+        return isComplex() ? (getDenseValue<true>().array() != ComplexType(0)).count() :
+                             (getDenseValue<false>().array() != RealType(0)).count();
+    }
+    if(!elementsRowMajor)
+        return 0;
+    return isComplex() ? getRowMajorView<true>().nonZeros() : getRowMajorView<false>().nonZeros();
+}
+
+double MonomialOperatorPart::estimateNonZeros() const {
+    if(isPending())
+        return static_cast<double>(HTo.getNumberOfEigenValues()) * static_cast<double>(HFrom.getNumberOfEigenValues());
+    return static_cast<double>(getNonZeros());
+}
+
+namespace {
+
+template <bool C> RealType maxAbsElement(RowMajorMatrixView<C> const& M) {
+    RealType MaxAbs = 0;
+    for(Eigen::Index row = 0; row < M.outerSize(); ++row) {
+        for(typename RowMajorMatrixView<C>::InnerIterator it(M, row); it; ++it)
+            MaxAbs = std::max(MaxAbs, RealType(std::abs(it.value())));
+    }
+    return MaxAbs;
+}
+
+template <bool C> RealType maxAbsElement(MatrixType<C> const& M) {
+    return M.size() > 0 ? RealType(M.cwiseAbs().maxCoeff()) : RealType(0);
+}
+
+// Values of a matrix shared with the adjoint part: real values are used as they are,
+// while complex values must be replaced with their conjugates
+template <typename MatrixType> RealType const* sharedValues(MatrixType const& M, std::vector<ComplexType> const&) {
+    return M.valuePtr();
+}
+template <int Options>
+ComplexType const* sharedValues(Eigen::SparseMatrix<ComplexType, Options, int> const&,
+                                std::vector<ComplexType> const& ConjValues) {
+    return ConjValues.data();
+}
+
+// Build a read-only view of a matrix or of its transpose stored in the other order
+template <typename ViewType, typename MatrixType>
+ViewType makeView(MatrixType const& M, bool Transpose, typename MatrixType::Scalar const* Values) {
+    return ViewType(Transpose ? M.cols() : M.rows(),
+                    Transpose ? M.rows() : M.cols(),
+                    M.nonZeros(),
+                    M.outerIndexPtr(),
+                    M.innerIndexPtr(),
+                    Values,
+                    M.innerNonZeroPtr());
+}
+
+} // namespace
+
+RealType MonomialOperatorPart::getMaxAbsElement() const {
+    ensureComputed();
+    if(Dense) {
+        return isComplex() ? maxAbsElement<true>(getDenseValue<true>()) : maxAbsElement<false>(getDenseValue<false>());
+    }
+    if(!elementsRowMajor)
+        return 0;
+    return isComplex() ? maxAbsElement<true>(getRowMajorView<true>()) :
+                         maxAbsElement<false>(getRowMajorView<false>());
+}
+
+template <bool C> RowMajorMatrixView<C> MonomialOperatorPart::getRowMajorView() const {
+    if(C != isComplex())
+        throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
+    if(!SharedWithAdjoint) {
+        auto const& M = *std::static_pointer_cast<RowMajorMatrixType<C> const>(elementsRowMajor);
+        return makeView<RowMajorMatrixView<C>>(M, false, M.valuePtr());
+    }
+    auto const& M = *std::static_pointer_cast<ColMajorMatrixType<C> const>(elementsRowMajor);
+    return makeView<RowMajorMatrixView<C>>(M, true, sharedValues(M, ConjValuesRowMajor));
+}
+template RowMajorMatrixView<true> MonomialOperatorPart::getRowMajorView<true>() const;
+template RowMajorMatrixView<false> MonomialOperatorPart::getRowMajorView<false>() const;
+
+template <bool C> RowMajorMatrixView<C> MonomialOperatorPart::getRowMajorView(RowMajorMatrixType<C>& Storage) const {
+    if(!isDense())
+        return getRowMajorView<C>();
+    Storage = getDenseValue<C>().sparseView();
+    return makeView<RowMajorMatrixView<C>>(Storage, false, Storage.valuePtr());
+}
+template RowMajorMatrixView<true> MonomialOperatorPart::getRowMajorView<true>(RowMajorMatrixType<true>&) const;
+template RowMajorMatrixView<false> MonomialOperatorPart::getRowMajorView<false>(RowMajorMatrixType<false>&) const;
+
+template <bool C> ColMajorMatrixView<C> MonomialOperatorPart::getColMajorView() const {
+    if(C != isComplex())
+        throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
+    if(!SharedWithAdjoint) {
+        auto const& M = *std::static_pointer_cast<ColMajorMatrixType<C> const>(elementsColMajor);
+        return makeView<ColMajorMatrixView<C>>(M, false, M.valuePtr());
+    }
+    auto const& M = *std::static_pointer_cast<RowMajorMatrixType<C> const>(elementsColMajor);
+    return makeView<ColMajorMatrixView<C>>(M, true, sharedValues(M, ConjValuesColMajor));
+}
+template ColMajorMatrixView<true> MonomialOperatorPart::getColMajorView<true>() const;
+template ColMajorMatrixView<false> MonomialOperatorPart::getColMajorView<false>() const;
+
+template <bool C> ColMajorMatrixView<C> MonomialOperatorPart::getColMajorView(ColMajorMatrixType<C>& Storage) const {
+    if(!isDense())
+        return getColMajorView<C>();
+    Storage = getDenseValue<C>().sparseView();
+    return makeView<ColMajorMatrixView<C>>(Storage, false, Storage.valuePtr());
+}
+template ColMajorMatrixView<true> MonomialOperatorPart::getColMajorView<true>(ColMajorMatrixType<true>&) const;
+template ColMajorMatrixView<false> MonomialOperatorPart::getColMajorView<false>(ColMajorMatrixType<false>&) const;
+
 template <bool C> ColMajorMatrixType<C>& MonomialOperatorPart::getColMajorValue() {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(SharedWithAdjoint)
+        throw std::runtime_error("MonomialOperatorPart: Matrices are shared with the adjoint part, use "
+                                 "getColMajorView().");
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
     return *std::static_pointer_cast<ColMajorMatrixType<C>>(elementsColMajor);
 }
 template ColMajorMatrixType<true>& MonomialOperatorPart::getColMajorValue<true>();
@@ -121,6 +395,12 @@ template ColMajorMatrixType<false>& MonomialOperatorPart::getColMajorValue<false
 template <bool C> ColMajorMatrixType<C> const& MonomialOperatorPart::getColMajorValue() const {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(SharedWithAdjoint)
+        throw std::runtime_error("MonomialOperatorPart: Matrices are shared with the adjoint part, use "
+                                 "getColMajorView().");
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
     return *std::static_pointer_cast<ColMajorMatrixType<C> const>(elementsColMajor);
 }
 template ColMajorMatrixType<true> const& MonomialOperatorPart::getColMajorValue<true>() const;
@@ -129,6 +409,12 @@ template ColMajorMatrixType<false> const& MonomialOperatorPart::getColMajorValue
 template <bool C> RowMajorMatrixType<C>& MonomialOperatorPart::getRowMajorValue() {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(SharedWithAdjoint)
+        throw std::runtime_error("MonomialOperatorPart: Matrices are shared with the adjoint part, use "
+                                 "getRowMajorView().");
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
     return *std::static_pointer_cast<RowMajorMatrixType<C>>(elementsRowMajor);
 }
 template RowMajorMatrixType<true>& MonomialOperatorPart::getRowMajorValue<true>();
@@ -137,18 +423,36 @@ template RowMajorMatrixType<false>& MonomialOperatorPart::getRowMajorValue<false
 template <bool C> RowMajorMatrixType<C> const& MonomialOperatorPart::getRowMajorValue() const {
     if(C != isComplex())
         throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(SharedWithAdjoint)
+        throw std::runtime_error("MonomialOperatorPart: Matrices are shared with the adjoint part, use "
+                                 "getRowMajorView().");
+    if(Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored densely, use getDenseValue().");
     return *std::static_pointer_cast<RowMajorMatrixType<C> const>(elementsRowMajor);
 }
 template RowMajorMatrixType<true> const& MonomialOperatorPart::getRowMajorValue<true>() const;
 template RowMajorMatrixType<false> const& MonomialOperatorPart::getRowMajorValue<false>() const;
 
+template <bool C> MatrixType<C> const& MonomialOperatorPart::getDenseValue() const {
+    if(C != isComplex())
+        throw std::runtime_error("Stored matrix type mismatch (real/complex)");
+    ensureComputed();
+    if(!Dense)
+        throw std::runtime_error("MonomialOperatorPart: Matrix is stored sparsely.");
+    return *std::static_pointer_cast<MatrixType<C> const>(elementsDense);
+}
+template MatrixType<true> const& MonomialOperatorPart::getDenseValue<true>() const;
+template MatrixType<false> const& MonomialOperatorPart::getDenseValue<false>() const;
+
 template <bool C> void MonomialOperatorPart::streamOutputImpl(std::ostream& os) const {
     BlockNumber to = HTo.getBlockNumber();
     BlockNumber from = HFrom.getBlockNumber();
-    auto const& mat = getColMajorValue<C>();
+    ColMajorMatrixType<C> Storage;
+    auto const mat = getColMajorView<C>(Storage);
 
-    for(std::size_t P = 0; P < mat.outerSize(); ++P) {
-        for(typename ColMajorMatrixType<C>::InnerIterator it(mat, P); it; ++it) {
+    for(Eigen::Index P = 0; P < mat.outerSize(); ++P) {
+        for(typename ColMajorMatrixView<C>::InnerIterator it(mat, P); it; ++it) {
             QuantumState N = S.getFockState(to, it.row());
             QuantumState M = S.getFockState(from, it.col());
             os << N << " " << M << " : " << it.value() << '\n';
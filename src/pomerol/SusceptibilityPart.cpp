@@ -57,36 +57,65 @@ SusceptibilityPart::SusceptibilityPart(MonomialOperatorPart const& A,
       B(B),
       Terms(Term::Hash(PoleResolution), Term::KeyEqual(PoleResolution), Term::IsNegligible(CoefficientTolerance)),
       PoleResolution(PoleResolution),
-      CoefficientTolerance(CoefficientTolerance) {}
+      CoefficientTolerance(CoefficientTolerance) {
+    A.request();
+    B.request();
+}
 
 void SusceptibilityPart::compute() {
+    bool Dense = A.isDense() && B.isDense();
     if(A.isComplex()) {
         if(B.isComplex())
-            computeImpl<true, true>();
+            Dense ? computeDenseImpl<true, true>() : computeImpl<true, true>();
         else
-            computeImpl<true, false>();
+            Dense ? computeDenseImpl<true, false>() : computeImpl<true, false>();
     } else {
         if(B.isComplex())
-            computeImpl<false, true>();
+            Dense ? computeDenseImpl<false, true>() : computeImpl<false, true>();
         else
-            computeImpl<false, false>();
+            Dense ? computeDenseImpl<false, false>() : computeImpl<false, false>();
     }
 }
 
+bool SusceptibilityPart::mayHaveZeroPoles() const {
+    RealVectorType const& EnergiesInner = HpartInner.getEigenValues();
+    RealVectorType const& EnergiesOuter = HpartOuter.getEigenValues();
+    if(EnergiesInner.size() == 0 || EnergiesOuter.size() == 0)
+        return false;
+    return EnergiesInner.minCoeff() - EnergiesOuter.maxCoeff() < PoleResolution &&
+           EnergiesOuter.minCoeff() - EnergiesInner.maxCoeff() < PoleResolution;
+}
+
 template <bool AComplex, bool BComplex> void SusceptibilityPart::computeImpl() {
     Terms.clear();
 
-    // Blocks (submatrices) of A and B
-    RowMajorMatrixType<AComplex> const& Amatrix = A.getRowMajorValue<AComplex>();
-    ColMajorMatrixType<BComplex> const& Bmatrix = B.getColMajorValue<BComplex>();
+    // Blocks (submatrices) of A and B, temporarily converted to sparse matrices if stored densely
+    RowMajorMatrixType<AComplex> Astorage;
+    ColMajorMatrixType<BComplex> Bstorage;
+    RowMajorMatrixView<AComplex> const Amatrix = A.getRowMajorView<AComplex>(Astorage);
+    ColMajorMatrixView<BComplex> const Bmatrix = B.getColMajorView<BComplex>(Bstorage);
     QuantumState outerSize = Amatrix.outerSize();
 
+    // Magnitudes of the residues are bounded by MaxElements * (weight of index1 + weight of index2).
+    // Contributions to ZeroPoleWeight are accumulated regardless of their magnitude, so the loops
+    // can stop early only if there are no poles at zero energy.
+    RealType MaxElements = A.getMaxAbsElement() * B.getMaxAbsElement();
+    RealType MaxWeightInner = DMpartInner.getMaxWeight();
+    bool ZeroPoles = mayHaveZeroPoles();
+
     // Iterate over all values of the outer index.
     // TODO: should be optimized - skip empty rows of Amatrix and empty columns of Bmatrix.
     for(QuantumState index1 = 0; index1 < outerSize; ++index1) {
+        // All remaining residues are negligible
+        bool OuterNegligible =
+            MaxElements * (DMpartOuter.getMaxWeight(index1) + MaxWeightInner) <= CoefficientTolerance;
+        if(OuterNegligible && !ZeroPoles)
+            break;
+        RealType WeightOuter = DMpartOuter.getWeight(index1);
+
         // <index1|A|Ainner><Binner|B|index1>
-        typename RowMajorMatrixType<AComplex>::InnerIterator Ainner(Amatrix, index1);
-        typename ColMajorMatrixType<BComplex>::InnerIterator Binner(Bmatrix, index1);
+        typename RowMajorMatrixView<AComplex>::InnerIterator Ainner(Amatrix, index1);
+        typename ColMajorMatrixView<BComplex>::InnerIterator Binner(Bmatrix, index1);
 
         // While we are not at the last column of Amatrix or at the last row of Bmatrix.
         while(Ainner && Binner) {
@@ -95,14 +124,20 @@ template <bool AComplex, bool BComplex> void SusceptibilityPart::computeImpl() {
 
             // A meaningful matrix element
             if(A_index2 == B_index2) {
+                // Residues of all remaining inner states are negligible
+                bool Negligible =
+                    OuterNegligible ||
+                    MaxElements * (WeightOuter + DMpartInner.getMaxWeight(A_index2)) <= CoefficientTolerance;
+                if(Negligible && !ZeroPoles)
+                    break;
                 RealType Pole = HpartInner.getEigenValue(A_index2) - HpartOuter.getEigenValue(index1);
                 if(std::abs(Pole) < PoleResolution) {
                     // BOSON: pole at zero energy
-                    ZeroPoleWeight += Ainner.value() * Binner.value() * DMpartOuter.getWeight(index1);
-                } else {
+                    ZeroPoleWeight += Ainner.value() * Binner.value() * WeightOuter;
+                } else if(!Negligible) {
                     // BOSON: minus sign before the second term
                     ComplexType Residue = Ainner.value() * Binner.value() *
-                                          (DMpartOuter.getWeight(index1) - DMpartInner.getWeight(A_index2));
+                                          (WeightOuter - DMpartInner.getWeight(A_index2));
                     if(std::abs(Residue) > CoefficientTolerance) // Is the residue relevant?
                     {
                         // Create a new term and append it to the list.
@@ -126,4 +161,57 @@ template <bool AComplex, bool BComplex> void SusceptibilityPart::computeImpl() {
     assert(Terms.check_terms());
 }
 
+// Both A and B are stored densely
+template <bool AComplex, bool BComplex> void SusceptibilityPart::computeDenseImpl() {
+    Terms.clear();
+
+    // Products <index1|A|index2><index2|B|index1> in a row-major outer x inner matrix,
+    // so that index2 runs over contiguous memory
+    using ProductType = MelemType<AComplex || BComplex>;
+    MatrixType<AComplex || BComplex> const Products =
+        A.getDenseValue<AComplex>().template cast<ProductType>().cwiseProduct(
+            B.getDenseValue<BComplex>().transpose().template cast<ProductType>());
+    QuantumState outerSize = Products.rows();
+    QuantumState innerSize = Products.cols();
+
+    // Magnitudes of the residues are bounded by MaxElements * (weight of index1 + weight of index2).
+    // Contributions to ZeroPoleWeight are accumulated regardless of their magnitude, so the loops
+    // can stop early only if there are no poles at zero energy.
+    RealType MaxElements = A.getMaxAbsElement() * B.getMaxAbsElement();
+    RealType MaxWeightInner = DMpartInner.getMaxWeight();
+    bool ZeroPoles = mayHaveZeroPoles();
+
+    for(QuantumState index1 = 0; index1 < outerSize; ++index1) {
+        // All remaining residues are negligible
+        bool OuterNegligible =
+            MaxElements * (DMpartOuter.getMaxWeight(index1) + MaxWeightInner) <= CoefficientTolerance;
+        if(OuterNegligible && !ZeroPoles)
+            break;
+        RealType WeightOuter = DMpartOuter.getWeight(index1);
+
+        for(QuantumState index2 = 0; index2 < innerSize; ++index2) {
+            // Residues of all remaining inner states are negligible
+            bool Negligible = OuterNegligible ||
+                              MaxElements * (WeightOuter + DMpartInner.getMaxWeight(index2)) <= CoefficientTolerance;
+            if(Negligible && !ZeroPoles)
+                break;
+            ProductType Product = Products(index1, index2);
+            if(Product == ProductType(0))
+                continue;
+            RealType Pole = HpartInner.getEigenValue(index2) - HpartOuter.getEigenValue(index1);
+            if(std::abs(Pole) < PoleResolution) {
+                // BOSON: pole at zero energy
+                ZeroPoleWeight += Product * WeightOuter;
+            } else if(!Negligible) {
+                // BOSON: minus sign before the second term
+                ComplexType Residue = Product * (WeightOuter - DMpartInner.getWeight(index2));
+                if(std::abs(Residue) > CoefficientTolerance)
+                    Terms.add_term(Term(Residue, Pole));
+            }
+        }
+    }
+
+    assert(Terms.check_terms());
+}
+
 } // namespace Pomerol
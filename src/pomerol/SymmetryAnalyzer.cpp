@@ -0,0 +1,166 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file src/pomerol/SymmetryAnalyzer.cpp
+/// \brief Detection of single-particle index permutations that leave the Hamiltonian invariant (implementation).
+
+#include "pomerol/SymmetryAnalyzer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace Pomerol {
+
+namespace {
+
+// Sort a list of indices by insertion and count the number of transpositions
+template <typename Compare> int sortWithSign(std::vector<ParticleIndex>& Indices, Compare const& Comp) {
+    int Sign = 1;
+    for(std::size_t i = 1; i < Indices.size(); ++i) {
+        for(std::size_t j = i; j > 0 && Comp(Indices[j], Indices[j - 1]); --j) {
+            std::swap(Indices[j], Indices[j - 1]);
+            Sign = -Sign;
+        }
+    }
+    return Sign;
+}
+
+// Apply a group generated by a set of permutations to an element and collect the orbit of the element
+template <typename T, typename Apply>
+std::set<T> makeOrbit(T const& Element,
+                      std::vector<SymmetryAnalyzer::IndexPermutation> const& Generators,
+                      Apply const& apply) {
+    std::set<T> Orbit = {Element};
+    std::vector<T> Queue = {Element};
+    while(!Queue.empty()) {
+        T Current = Queue.back();
+        Queue.pop_back();
+        for(auto const& P : Generators) {
+            T Image = apply(P, Current);
+            if(Orbit.insert(Image).second)
+                Queue.push_back(Image);
+        }
+    }
+    return Orbit;
+}
+
+} // namespace
+
+int SymmetryAnalyzer::normalOrder(Monomial& M) {
+    return sortWithSign(M.Creation, std::less<ParticleIndex>()) *
+           sortWithSign(M.Annihilation, std::greater<ParticleIndex>());
+}
+
+void SymmetryAnalyzer::findGenerators(std::map<Monomial, ComplexType> const& Terms, RealType Tolerance) {
+    // Monomials with non-negligible coefficients grouped by their largest index.
+    // A monomial can be checked as soon as images of all its indices are known.
+    std::vector<std::vector<std::pair<Monomial, ComplexType>>> TermsByMaxIndex(NumIndices);
+    // Signatures of indices: Sorted degrees and absolute values of coefficients of the monomials containing them.
+    // An index can only be mapped onto an index with the same signature.
+    std::vector<std::vector<std::pair<std::size_t, RealType>>> Signatures(NumIndices);
+    for(auto const& T : Terms) {
+        if(std::abs(T.second) <= Tolerance)
+            continue;
+        std::vector<ParticleIndex> Indices(T.first.Creation);
+        Indices.insert(Indices.end(), T.first.Annihilation.begin(), T.first.Annihilation.end());
+        if(Indices.empty())
+            continue;
+        TermsByMaxIndex[*std::max_element(Indices.begin(), Indices.end())].emplace_back(T);
+        for(ParticleIndex i : Indices)
+            Signatures[i].emplace_back(Indices.size(), std::abs(T.second));
+    }
+    for(auto& S : Signatures)
+        std::sort(S.begin(), S.end());
+
+    auto sameSignature = [&](ParticleIndex i, ParticleIndex j) {
+        auto const& Si = Signatures[i];
+        auto const& Sj = Signatures[j];
+        if(Si.size() != Sj.size())
+            return false;
+        for(std::size_t n = 0; n < Si.size(); ++n) {
+            if(Si[n].first != Sj[n].first || std::abs(Si[n].second - Sj[n].second) > Tolerance)
+                return false;
+        }
+        return true;
+    };
+
+    // Check that all monomials with the largest index k are mapped onto monomials with the same coefficients
+    auto checkIndex = [&](IndexPermutation const& P, ParticleIndex k) {
+        for(auto const& T : TermsByMaxIndex[k]) {
+            Monomial Image;
+            for(ParticleIndex i : T.first.Creation)
+                Image.Creation.push_back(P[i]);
+            for(ParticleIndex i : T.first.Annihilation)
+                Image.Annihilation.push_back(P[i]);
+            int Sign = normalOrder(Image);
+            auto It = Terms.find(Image);
+            if(It == Terms.end() || std::abs(It->second - RealType(Sign) * T.second) > Tolerance)
+                return false;
+        }
+        return true;
+    };
+
+    // Assign images to indices k, k+1, ... by backtracking
+    IndexPermutation P(NumIndices);
+    std::vector<bool> Used(NumIndices);
+    std::function<bool(ParticleIndex)> extend = [&](ParticleIndex k) {
+        if(k == NumIndices)
+            return true;
+        for(ParticleIndex j = 0; j < NumIndices; ++j) {
+            if(Used[j] || !sameSignature(k, j))
+                continue;
+            P[k] = j;
+            Used[j] = true;
+            if(checkIndex(P, k) && extend(k + 1))
+                return true;
+            Used[j] = false;
+        }
+        return false;
+    };
+
+    auto applyToIndex = [](IndexPermutation const& G, ParticleIndex i) { return G[i]; };
+
+    for(ParticleIndex k = NumIndices; k-- > 0;) {
+        // All generators found so far fix indices 0, ..., k-1
+        std::set<ParticleIndex> Orbit = makeOrbit(k, Generators, applyToIndex);
+        for(ParticleIndex j = k + 1; j < NumIndices; ++j) {
+            if(Orbit.count(j) || !sameSignature(k, j))
+                continue;
+            std::fill(Used.begin(), Used.end(), false);
+            for(ParticleIndex i = 0; i < k; ++i) {
+                P[i] = i;
+                Used[i] = true;
+            }
+            P[k] = j;
+            Used[j] = true;
+            if(checkIndex(P, k) && extend(k + 1)) {
+                Generators.push_back(P);
+                Orbit = makeOrbit(k, Generators, applyToIndex);
+            }
+        }
+    }
+}
+
+std::set<IndexCombination2> SymmetryAnalyzer::getOrbit(IndexCombination2 const& Indices) const {
+    return makeOrbit(Indices, Generators, [](IndexPermutation const& P, IndexCombination2 const& I) {
+        return IndexCombination2(P[I.Index1], P[I.Index2]);
+    });
+}
+
+std::set<IndexCombination4> SymmetryAnalyzer::getOrbit(IndexCombination4 const& Indices) const {
+    return makeOrbit(Indices, Generators, [](IndexPermutation const& P, IndexCombination4 const& I) {
+        return IndexCombination4(P[I.Index1], P[I.Index2], P[I.Index3], P[I.Index4]);
+    });
+}
+
+} // namespace Pomerol
@@ -16,8 +16,10 @@
 
 #include "mpi_dispatcher/mpi_skel.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cstddef>
 #include <ostream>
 #include <stdexcept>
 #include <tuple>
@@ -145,24 +147,24 @@ void ThreePointSusceptibility::prepare() {
 // 1) compute ThreePointSusceptibility terms;
 // 2) convert them to a Matsubara Container;
 // 3) purge terms
-struct ComputeAndClearWrap3PSusc {
-    ComputeAndClearWrap3PSusc(FreqVec2 const& freqs,
+template <typename FillFunc> struct ComputeAndClearWrap3PSusc {
+    ComputeAndClearWrap3PSusc(FillFunc const& fill_func,
                               std::vector<ComplexType>& data,
                               ThreePointSusceptibilityPart& p,
                               bool clear,
                               bool fill,
-                              int complexity = 1)
-        : complexity(complexity), freqs_(freqs), data_(data), p(p), clear_(clear), fill_(fill) {}
+                              pMPI::CostType complexity = 1)
+        : complexity(complexity), fill_func_(fill_func), data_(data), p(p), clear_(clear), fill_(fill) {}
 
     void run() {
         p.compute();
         if(fill_) {
-            std::size_t wsize = freqs_.size();
+            std::size_t wsize = data_.size();
 #ifdef POMEROL_USE_OPENMP
 #pragma omp parallel for
 #endif
             for(int w = 0; w < wsize; ++w) {
-                data_[w] += p(std::get<0>(freqs_[w]), std::get<1>(freqs_[w]));
+                data_[w] += fill_func_(p, w);
             }
 #ifdef POMEROL_USE_OPENMP
 #pragma omp barrier
@@ -173,17 +175,22 @@ struct ComputeAndClearWrap3PSusc {
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
-    int const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    pMPI::CostType const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
 
 private:
-    FreqVec2 const& freqs_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    FillFunc const& fill_func_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     std::vector<ComplexType>& data_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     ThreePointSusceptibilityPart& p; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     bool clear_;
     bool fill_;
 };
 
-std::vector<ComplexType> ThreePointSusceptibility::compute(bool clear, FreqVec2 const& freqs, MPI_Comm const& comm) {
+template <typename FillFunc>
+std::vector<ComplexType> ThreePointSusceptibility::computeParts(bool clear,
+                                                                std::size_t NumFreqs,
+                                                                FillFunc const& Value,
+                                                                MPI_Comm const& comm,
+                                                                DistributedVector* Slices) {
     if(getStatus() < Prepared)
         throw StatusMismatch("ThreePointSusceptibility is not prepared yet.");
 
@@ -193,27 +200,32 @@ std::vector<ComplexType> ThreePointSusceptibility::compute(bool clear, FreqVec2
 
     if(!Vanishing) {
         // Create a "skeleton" class with pointers to part that can call a compute method
-        pMPI::mpi_skel<ComputeAndClearWrap3PSusc> skel;
-        bool fill_container = !freqs.empty();
+        pMPI::mpi_skel<ComputeAndClearWrap3PSusc<FillFunc>> skel;
+        bool fill_container = NumFreqs > 0;
         skel.parts.reserve(parts.size());
-        m_data.resize(freqs.size(), 0.0);
+        m_data.resize(NumFreqs, 0.0);
         for(auto& part : parts) {
-            skel.parts.emplace_back(freqs, m_data, part, clear, fill_container, 1);
+            skel.parts.emplace_back(Value, m_data, part, clear, fill_container, part.estimateCost());
         }
         std::map<pMPI::JobId, pMPI::WorkerId> job_map = skel.run(comm, true); // actual running - very costly
 
+        TermsDistributed = !clear && DistributedTerms;
+
         // Start distributing data
         MPI_Barrier(comm);
 
-        MPI_Allreduce(MPI_IN_PLACE,
-                      m_data.data(),
-                      static_cast<int>(m_data.size()),
-                      POMEROL_MPI_DOUBLE_COMPLEX,
-                      MPI_SUM,
-                      comm);
+        if(Slices)
+            Slices->reduceScatter(m_data);
+        else
+            MPI_Allreduce(MPI_IN_PLACE,
+                          m_data.data(),
+                          static_cast<int>(m_data.size()),
+                          POMEROL_MPI_DOUBLE_COMPLEX,
+                          MPI_SUM,
+                          comm);
 
         // Optionally distribute terms to other processes
-        if(!clear) {
+        if(!clear && !TermsDistributed) {
             for(int p = 0; p < static_cast<int>(parts.size()); ++p) {
                 parts[p].NonResonantFFTerms.broadcast(comm, job_map[p]);
                 parts[p].NonResonantFBTerms.broadcast(comm, job_map[p]);
@@ -229,6 +241,122 @@ std::vector<ComplexType> ThreePointSusceptibility::compute(bool clear, FreqVec2
     return m_data;
 }
 
+std::vector<ComplexType> ThreePointSusceptibility::computeIrreducible(bool clear,
+                                                                      std::vector<MatsubaraDuplet> const& indices,
+                                                                      MPI_Comm const& comm) {
+    using Reduction = FrequencySymmetryReduction<MatsubaraDuplet>;
+    std::vector<Reduction::Relation> Relations;
+    // Exchange of the fermionic operators in the PP channel
+    if(channel == PP && CX1.getIndex() == CX3.getIndex())
+        Relations.push_back({[](MatsubaraDuplet const& n) { return MatsubaraDuplet{n[1], n[0]}; }, -1, false});
+    // Complex conjugation of real-valued operators and Hamiltonian
+    if(!CX1.isComplex() && !C2.isComplex() && !CX3.isComplex() && !C4.isComplex())
+        Relations.push_back(
+            {[](MatsubaraDuplet const& n) { return MatsubaraDuplet{-n[0] - 1, -n[1] - 1}; }, 1, true});
+
+    Reduction const R(indices, Relations);
+    auto const& irreducible = R.getIrreducible();
+    INFO("ThreePointSusceptibility(" << getIndex(0) << getIndex(1) << getIndex(2) << getIndex(3)
+                                     << "): " << irreducible.size() << " of " << indices.size()
+                                     << " frequency duplets are irreducible");
+
+    ComplexType const Spacing = MatsubaraSpacing;
+    auto Value = [&irreducible, Spacing](ThreePointSusceptibilityPart const& p, std::size_t w) {
+        MatsubaraDuplet const& n = irreducible[w];
+        return p(Spacing * RealType(2 * n[0] + 1), Spacing * RealType(2 * n[1] + 1));
+    };
+    std::vector<ComplexType> m_data = computeParts(clear, irreducible.size(), Value, comm);
+    return m_data.empty() ? m_data : R.expand(m_data);
+}
+
+std::vector<ComplexType> ThreePointSusceptibility::compute(bool clear, FreqVec2 const& freqs, MPI_Comm const& comm) {
+    if(UseFrequencySymmetries && !freqs.empty()) {
+        // Reduce the list only if all frequencies belong to the Matsubara grid
+        std::vector<MatsubaraDuplet> indices(freqs.size());
+        bool Matsubara = true;
+        for(std::size_t w = 0; w < freqs.size() && Matsubara; ++w) {
+            Matsubara = getMatsubaraIndex(std::get<0>(freqs[w]), beta, indices[w][0]) &&
+                        getMatsubaraIndex(std::get<1>(freqs[w]), beta, indices[w][1]);
+        }
+        if(Matsubara)
+            return computeIrreducible(clear, indices, comm);
+    }
+    auto Value = [&freqs](ThreePointSusceptibilityPart const& p, std::size_t w) {
+        return p(std::get<0>(freqs[w]), std::get<1>(freqs[w]));
+    };
+    return computeParts(clear, freqs.size(), Value, comm);
+}
+
+std::vector<ComplexType> ThreePointSusceptibility::compute(bool clear, FreqGrid2 const& grid, MPI_Comm const& comm) {
+    if(UseFrequencySymmetries && grid.size() > 0) {
+        std::vector<MatsubaraDuplet> indices(grid.size());
+        for(std::size_t w = 0; w < grid.size(); ++w)
+            indices[w] = grid[w];
+        return computeIrreducible(clear, indices, comm);
+    }
+    ComplexType const Spacing = MatsubaraSpacing;
+    auto Value = [&grid, Spacing](ThreePointSusceptibilityPart const& p, std::size_t w) {
+        MatsubaraDuplet n = grid[w];
+        return p(Spacing * RealType(2 * n[0] + 1), Spacing * RealType(2 * n[1] + 1));
+    };
+    return computeParts(clear, grid.size(), Value, comm);
+}
+
+DistributedVector
+ThreePointSusceptibility::computeDistributed(bool clear, FreqVec2 const& freqs, MPI_Comm const& comm) {
+    auto Value = [&freqs](ThreePointSusceptibilityPart const& p, std::size_t w) {
+        return p(std::get<0>(freqs[w]), std::get<1>(freqs[w]));
+    };
+    DistributedVector Slices(comm);
+    computeParts(clear, freqs.size(), Value, comm, &Slices);
+    return Slices;
+}
+
+DistributedVector
+ThreePointSusceptibility::computeDistributed(bool clear, FreqGrid2 const& grid, MPI_Comm const& comm) {
+    ComplexType const Spacing = MatsubaraSpacing;
+    auto Value = [&grid, Spacing](ThreePointSusceptibilityPart const& p, std::size_t w) {
+        MatsubaraDuplet n = grid[w];
+        return p(Spacing * RealType(2 * n[0] + 1), Spacing * RealType(2 * n[1] + 1));
+    };
+    DistributedVector Slices(comm);
+    computeParts(clear, grid.size(), Value, comm, &Slices);
+    return Slices;
+}
+
+std::vector<ComplexType> ThreePointSusceptibility::evaluate(FreqVec2 const& freqs, MPI_Comm const& comm) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("ThreePointSusceptibility is not computed yet.");
+
+    std::vector<ComplexType> data(freqs.size(), 0.0);
+    if(Vanishing)
+        return data;
+
+    if(!TermsDistributed && std::any_of(parts.begin(), parts.end(), [](ThreePointSusceptibilityPart const& p) {
+           return p.getStatus() != ThreePointSusceptibilityPart::Computed;
+       }))
+        throw StatusMismatch("ThreePointSusceptibility: Evaluating uncomputed parts. Did you purge all the terms "
+                             "when called compute()?");
+
+    // Only the parts computed by or broadcast to this process carry terms
+    for(auto const& part : parts) {
+        if(part.getStatus() != ThreePointSusceptibilityPart::Computed)
+            continue;
+        for(std::size_t w = 0; w < freqs.size(); ++w)
+            data[w] += part(std::get<0>(freqs[w]), std::get<1>(freqs[w]));
+    }
+
+    if(TermsDistributed)
+        MPI_Allreduce(MPI_IN_PLACE,
+                      data.data(),
+                      static_cast<int>(data.size()),
+                      POMEROL_MPI_DOUBLE_COMPLEX,
+                      MPI_SUM,
+                      comm);
+
+    return data;
+}
+
 ParticleIndex ThreePointSusceptibility::getIndex(std::size_t Position) const {
     switch(Position) {
     case 0: return CX1.getIndex();
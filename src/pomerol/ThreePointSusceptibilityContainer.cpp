@@ -22,12 +22,25 @@ void ThreePointSusceptibilityContainer::prepareAll(std::set<IndexCombination4> c
         auto& chi3 = static_cast<ThreePointSusceptibility&>(el.second);
         chi3.PoleResolution = PoleResolution;
         chi3.CoefficientTolerance = CoefficientTolerance;
+        chi3.UseFrequencySymmetries = UseFrequencySymmetries;
+        chi3.DistributedTerms = DistributedTerms;
         chi3.prepare();
     }
 }
 
 std::map<IndexCombination4, std::vector<ComplexType>>
 ThreePointSusceptibilityContainer::computeAll(bool clearTerms, FreqVec2 const& freqs, MPI_Comm const& comm) {
+    return computeAllImpl(clearTerms, freqs, comm);
+}
+
+std::map<IndexCombination4, std::vector<ComplexType>>
+ThreePointSusceptibilityContainer::computeAll(bool clearTerms, FreqGrid2 const& grid, MPI_Comm const& comm) {
+    return computeAllImpl(clearTerms, grid, comm);
+}
+
+template <typename Freqs>
+std::map<IndexCombination4, std::vector<ComplexType>>
+ThreePointSusceptibilityContainer::computeAllImpl(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm) {
     std::map<IndexCombination4, std::vector<ComplexType>> out;
     for(auto& el : ElementsMap) {
         INFO("Computing 3PSusceptibility for " << el.first);
@@ -15,7 +15,9 @@
 #include "pomerol/ThreePointSusceptibilityPart.hpp"
 #include "pomerol/ChaseIndices.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <mutex>
 
 // NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
@@ -228,7 +230,12 @@ ThreePointSusceptibilityPart::ThreePointSusceptibilityPart(MonomialOperatorPart
                     ResonantTerm::KeyEqual(PoleResolution),
                     ResonantTerm::IsNegligible(CoefficientTolerance)),
       PoleResolution(PoleResolution),
-      CoefficientTolerance(CoefficientTolerance) {}
+      CoefficientTolerance(CoefficientTolerance) {
+    F1.request();
+    F2.request();
+    B1.request();
+    B2.request();
+}
 
 void ThreePointSusceptibilityPart::compute() {
     if(getStatus() >= Computed)
@@ -240,6 +247,18 @@ void ThreePointSusceptibilityPart::compute() {
         computeImpl<false>();
 }
 
+double ThreePointSusceptibilityPart::estimateCost() const {
+    double N1 = std::max<double>(Hpart1.getNumberOfEigenValues(), 1);
+    double N2 = std::max<double>(Hpart2.getNumberOfEigenValues(), 1);
+    double N3 = std::max<double>(Hpart3.getNumberOfEigenValues(), 1);
+    // Size of the intermediate block in B = B_1 B_2
+    double NB = std::max<double>(B2.getNumberOfRows(), 1);
+    double NNZ_B1B2 = B1.estimateNonZeros() * B2.estimateNonZeros();
+    double NNZ_B = std::min(NNZ_B1B2 / NB, N1 * N3);
+    double NNZ = F1.estimateNonZeros() * F2.estimateNonZeros() * NNZ_B;
+    return N1 + NNZ_B1B2 / NB + NNZ / (N1 * N2 * N3);
+}
+
 template <bool Complex> void ThreePointSusceptibilityPart::computeImpl() {
     NonResonantFFTerms.clear();
     NonResonantFBTerms.clear();
@@ -248,27 +267,59 @@ template <bool Complex> void ThreePointSusceptibilityPart::computeImpl() {
     RealType beta = DMpart1.beta;
     RealType prefactor = ((channel == PH) == SwappedFermionOps) ? 1 : -1;
 
+    // Densely stored operator blocks are temporarily converted to sparse matrices
+    ColMajorMatrixType<Complex> B1storage, B2storage;
+    RowMajorMatrixType<Complex> F1storage, F2storage;
+
     // B = B_1 B_2
-    ColMajorMatrixType<Complex> Bmatrix = (B1.getColMajorValue<Complex>() * B2.getColMajorValue<Complex>()).pruned();
+    ColMajorMatrixType<Complex> Bmatrix =
+        (B1.getColMajorView<Complex>(B1storage) * B2.getColMajorView<Complex>(B2storage)).pruned();
+    B1storage = ColMajorMatrixType<Complex>();
+    B2storage = ColMajorMatrixType<Complex>();
 
     // <1| F1 |2> <2| F2 |3> <3| B |1>
-    RowMajorMatrixType<Complex> const& F1matrix = F1.getRowMajorValue<Complex>();
-    RowMajorMatrixType<Complex> const& F2matrix = F2.getRowMajorValue<Complex>();
+    RowMajorMatrixView<Complex> const F1matrix = F1.getRowMajorView<Complex>(F1storage);
+    RowMajorMatrixView<Complex> const F2matrix = F2.getRowMajorView<Complex>(F2storage);
+
+    // Magnitudes of all term coefficients are bounded by
+    // MaxElements * (weight of index1 + weight of index2 + weight of index3)
+    RealType MaxB = 0;
+    for(Eigen::Index k = 0; k < Bmatrix.outerSize(); ++k) {
+        for(typename ColMajorMatrixType<Complex>::InnerIterator it(Bmatrix, k); it; ++it)
+            MaxB = std::max(MaxB, RealType(std::abs(it.value())));
+    }
+    RealType MaxElements = F1.getMaxAbsElement() * F2.getMaxAbsElement() * MaxB * std::max(beta, RealType(1));
+    RealType MaxWeight2 = DMpart2.getMaxWeight();
+    RealType MaxWeight3 = DMpart3.getMaxWeight();
 
     InnerQuantumState index1Max = Bmatrix.outerSize();
     for(InnerQuantumState index1 = 0; index1 < index1Max; ++index1) {
+        // All remaining terms are negligible
+        if(MaxElements * (DMpart1.getMaxWeight(index1) + MaxWeight2 + MaxWeight3) <= CoefficientTolerance)
+            break;
+
         RealType E1 = Hpart1.getEigenValue(index1);
         RealType weight1 = DMpart1.getWeight(index1);
 
-        typename RowMajorMatrixType<Complex>::InnerIterator index2ket_iter(F1matrix, index1);
+        typename RowMajorMatrixView<Complex>::InnerIterator index2ket_iter(F1matrix, index1);
         for(; index2ket_iter; ++index2ket_iter) {
+            // Terms for all remaining states index2 are negligible
+            if(MaxElements * (weight1 + DMpart2.getMaxWeight(index2ket_iter.index()) + MaxWeight3) <=
+               CoefficientTolerance)
+                break;
+
             RealType E2 = Hpart2.getEigenValue(index2ket_iter.index());
             RealType weight2 = DMpart2.getWeight(index2ket_iter.index());
 
             typename ColMajorMatrixType<Complex>::InnerIterator index3bra_iter(Bmatrix, index1);
-            typename RowMajorMatrixType<Complex>::InnerIterator index3ket_iter(F2matrix, index2ket_iter.index());
+            typename RowMajorMatrixView<Complex>::InnerIterator index3ket_iter(F2matrix, index2ket_iter.index());
             while(index3bra_iter && index3ket_iter) {
-                if(chaseIndices<Complex>(index3ket_iter, index3bra_iter)) {
+                if(chaseIndices(index3ket_iter, index3bra_iter)) {
+                    // Terms for all remaining states index3 are negligible
+                    if(MaxElements * (weight1 + weight2 + DMpart3.getMaxWeight(index3ket_iter.index())) <=
+                       CoefficientTolerance)
+                        break;
+
                     RealType E3 = Hpart3.getEigenValue(index3ket_iter.index());
                     RealType weight3 = DMpart3.getWeight(index3ket_iter.index());
 
@@ -17,10 +17,16 @@
 
 #include "mpi_dispatcher/mpi_skel.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <map>
 #include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 namespace Pomerol {
 
@@ -93,6 +99,11 @@ void TwoParticleGF::prepare() {
                     if(!include_block_retained)
                         continue;
                 }
+                // Skip the part if no combination of statistical weights can exceed CoefficientTolerance
+                if(DM.getPart(LeftIndices[0]).getMaxWeight() + DM.getPart(LeftIndices[1]).getMaxWeight() +
+                       DM.getPart(LeftIndices[2]).getMaxWeight() + DM.getPart(LeftIndices[3]).getMaxWeight() <=
+                   CoefficientTolerance)
+                    continue;
                 parts.emplace_back(OperatorPartAtPosition(p, 0, LeftIndices[0]),
                                    OperatorPartAtPosition(p, 1, LeftIndices[1]),
                                    OperatorPartAtPosition(p, 2, LeftIndices[2]),
@@ -119,46 +130,161 @@ void TwoParticleGF::prepare() {
     setStatus(Prepared);
 }
 
+// Convert frequency triplets into triplets of fermionic Matsubara indices.
+// Returns an empty list if some of the frequencies do not belong to the fermionic Matsubara grid.
+static std::vector<MatsubaraTriplet> toMatsubaraIndices(FreqVec3 const& freqs, RealType beta) {
+    std::vector<MatsubaraTriplet> indices;
+    indices.reserve(freqs.size());
+    for(auto const& f : freqs) {
+        MatsubaraTriplet n;
+        if(!getMatsubaraIndex(std::get<0>(f), beta, n[0]) || !getMatsubaraIndex(std::get<1>(f), beta, n[1]) ||
+           !getMatsubaraIndex(std::get<2>(f), beta, n[2]))
+            return {};
+        indices.push_back(n);
+    }
+    return indices;
+}
+
+// Call a function with the sublist [First, First + Count) of a list, copying it only if it is a proper sublist.
+template <typename T, typename F>
+static void withSublist(std::vector<T> const& v, std::size_t First, std::size_t Count, F const& f) {
+    if(First == 0 && Count == v.size())
+        f(v);
+    else
+        f(std::vector<T>(v.begin() + static_cast<std::ptrdiff_t>(First),
+                         v.begin() + static_cast<std::ptrdiff_t>(First + Count)));
+}
+
+// A part and, optionally, a structure-of-arrays copy of its terms shared by several evaluations of the part
+struct PartTerms {
+    TwoParticleGFPart const& Part; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    TwoParticleGFPart::FrozenTerms const* Terms;
+
+    void accumulateValues(FreqVec3 const& freqs, std::vector<ComplexType>& data) const {
+        Part.accumulateValues(freqs, data, Terms);
+    }
+    void accumulateMatsubaraValues(std::vector<MatsubaraTriplet> const& indices, std::vector<ComplexType>& data) const {
+        Part.accumulateMatsubaraValues(indices, data, Terms);
+    }
+    void accumulateMatsubaraValues(FreqGrid3 const& grid, std::vector<ComplexType>& data, std::size_t First) const {
+        Part.accumulateMatsubaraValues(grid, data, First, Terms);
+    }
+};
+
+// Add values of a part at a sublist of frequency triplets to a chunk of data
+static void accumulateRange(PartTerms const& p,
+                            FreqVec3 const& freqs,
+                            std::vector<MatsubaraTriplet> const& indices,
+                            std::size_t First,
+                            std::vector<ComplexType>& data) {
+    if(indices.empty())
+        withSublist(freqs, First, data.size(), [&](FreqVec3 const& f) { p.accumulateValues(f, data); });
+    else
+        withSublist(indices, First, data.size(), [&](std::vector<MatsubaraTriplet> const& n) {
+            p.accumulateMatsubaraValues(n, data);
+        });
+}
+
+// Number of frequencies, at which values of a part are evaluated at once, given a memory budget and
+// the amount of memory already reserved by the terms and the precomputed values.
+static std::size_t getChunkSize(std::size_t MemoryBudget, std::size_t NumFreqs, std::size_t Reserved) {
+    if(MemoryBudget == 0)
+        return NumFreqs;
+    // Temporary storage of the part, a chunk of values and a copy of the frequencies
+    std::size_t const PerFrequency =
+        TwoParticleGFPart::EvaluationMemoryPerFrequency + sizeof(ComplexType) + sizeof(FreqTuple3);
+    // Very small chunks do not save much memory, but spoil the vectorized evaluation
+    std::size_t const MinChunkSize = 1024;
+    std::size_t Available = MemoryBudget > Reserved ? MemoryBudget - Reserved : 0;
+    return std::min(NumFreqs, std::max(MinChunkSize, Available / PerFrequency));
+}
+
+// Memory reserved by the terms of a part, including their temporary structure-of-arrays copy made during evaluation
+static std::size_t getTermsMemory(TwoParticleGFPart const& p) {
+    std::size_t Usage = p.getMemoryUsage();
+    return p.isFrozen() ? Usage : 2 * Usage;
+}
+
+// Add values of a part to a data vector evaluating them in chunks of at most ChunkSize frequencies
+template <typename FillFunc>
+static void
+fillInChunks(FillFunc const& Fill, TwoParticleGFPart const& p, std::vector<ComplexType>& data, std::size_t ChunkSize) {
+    if(ChunkSize >= data.size()) {
+        Fill(PartTerms{p, nullptr}, 0, data);
+        return;
+    }
+    // Convert the terms of an unfrozen part into the structure-of-arrays layout once for all chunks
+    TwoParticleGFPart::FrozenTerms Terms;
+    if(!p.isFrozen())
+        Terms = p.makeFrozenTerms();
+    PartTerms const Part{p, p.isFrozen() ? nullptr : &Terms};
+    std::vector<ComplexType> Chunk;
+    for(std::size_t First = 0; First < data.size(); First += ChunkSize) {
+        Chunk.assign(std::min(ChunkSize, data.size() - First), 0);
+        Fill(Part, First, Chunk);
+        for(std::size_t w = 0; w < Chunk.size(); ++w)
+            data[First + w] += Chunk[w];
+    }
+}
+
 // An mpi adapter to 1) compute 2pgf terms; 2) convert them to a Matsubara Container; 3) purge terms
-struct ComputeAndClearWrap2PGF {
-    ComputeAndClearWrap2PGF(FreqVec3 const& freqs,
+template <typename FillFunc> struct ComputeAndClearWrap2PGF {
+    ComputeAndClearWrap2PGF(FillFunc const& fill_func,
                             std::vector<ComplexType>& data,
                             TwoParticleGFPart& p,
                             bool clear,
                             bool fill,
-                            int complexity = 1)
-        : complexity(complexity), freqs_(freqs), data_(data), p(p), clear_(clear), fill_(fill) {}
+                            std::size_t memory_budget,
+                            std::size_t& retained,
+                            pMPI::CostType complexity = 1)
+        : complexity(complexity),
+          fill_func_(fill_func),
+          data_(data),
+          p(p),
+          clear_(clear),
+          fill_(fill),
+          memory_budget_(memory_budget),
+          retained_(retained) {}
 
     void run() {
         p.compute();
         if(fill_) {
-            std::size_t wsize = freqs_.size();
-#ifdef POMEROL_USE_OPENMP
-#pragma omp parallel for
-#endif
-            for(int w = 0; w < wsize; ++w) {
-                data_[w] += p(std::get<0>(freqs_[w]), std::get<1>(freqs_[w]), std::get<2>(freqs_[w]));
-            }
-#ifdef POMEROL_USE_OPENMP
-#pragma omp barrier
-#endif
+            std::size_t Reserved = retained_ + data_.size() * sizeof(ComplexType) + getTermsMemory(p);
+            fillInChunks(fill_func_, p, data_, getChunkSize(memory_budget_, data_.size(), Reserved));
         }
         if(clear_)
             p.clear();
+        else
+            retained_ += p.getMemoryUsage();
     }
 
     // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
-    int const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    pMPI::CostType const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
 
 private:
-    FreqVec3 const& freqs_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    FillFunc const& fill_func_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     std::vector<ComplexType>& data_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     TwoParticleGFPart& p; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
     bool clear_;
     bool fill_;
+    std::size_t memory_budget_;
+    std::size_t& retained_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
 };
 
-std::vector<ComplexType> TwoParticleGF::compute(bool clear, FreqVec3 const& freqs, MPI_Comm const& comm) {
+// Decide whether terms retained by all processes fit into the memory budget of one process
+static bool
+termsFitIntoBudget(std::size_t MemoryBudget, std::size_t OutputMemory, std::size_t Retained, MPI_Comm const& comm) {
+    auto TotalRetained = static_cast<unsigned long long>(Retained);
+    MPI_Allreduce(MPI_IN_PLACE, &TotalRetained, 1, MPI_UNSIGNED_LONG_LONG, MPI_SUM, comm);
+    return MemoryBudget == 0 || TotalRetained + OutputMemory <= MemoryBudget;
+}
+
+template <typename FillFunc>
+std::vector<ComplexType> TwoParticleGF::computeParts(bool clear,
+                                                     std::size_t NumFreqs,
+                                                     FillFunc const& Fill,
+                                                     MPI_Comm const& comm,
+                                                     DistributedVector* Slices) {
     if(getStatus() < Prepared)
         throw StatusMismatch("TwoParticleGF is not prepared yet.");
 
@@ -168,27 +294,46 @@ std::vector<ComplexType> TwoParticleGF::compute(bool clear, FreqVec3 const& freq
 
     if(!Vanishing) {
         // Create a "skeleton" class with pointers to part that can call a compute method
-        pMPI::mpi_skel<ComputeAndClearWrap2PGF> skel;
-        bool fill_container = !freqs.empty();
+        pMPI::mpi_skel<ComputeAndClearWrap2PGF<FillFunc>> skel;
+        bool fill_container = NumFreqs > 0;
         skel.parts.reserve(parts.size());
-        m_data.resize(freqs.size(), 0.0);
+        std::size_t OutputMemory = NumFreqs * sizeof(ComplexType);
+        if(MemoryBudget > 0 && OutputMemory > MemoryBudget && !pMPI::rank(comm))
+            ERROR("TwoParticleGF: Precomputed values alone need " << OutputMemory
+                                                                  << " bytes and exceed the memory budget");
+        m_data.resize(NumFreqs, 0.0);
+        // Memory occupied by the terms retained on this process
+        std::size_t Retained = 0;
         for(auto& part : parts) {
-            skel.parts.emplace_back(freqs, m_data, part, clear, fill_container, 1);
+            skel.parts.emplace_back(
+                Fill, m_data, part, clear, fill_container, MemoryBudget, Retained, part.estimateCost());
         }
         std::map<pMPI::JobId, pMPI::WorkerId> job_map = skel.run(comm, true); // actual running - very costly
 
+        TermsDistributed = !clear && DistributedTerms;
+        if(!clear && !DistributedTerms && !termsFitIntoBudget(MemoryBudget, OutputMemory, Retained, comm)) {
+            if(!pMPI::rank(comm))
+                INFO("TwoParticleGF(" << getIndex(0) << getIndex(1) << getIndex(2) << getIndex(3)
+                                      << "): Terms exceed the memory budget and will stay distributed, "
+                                      << "use evaluate() to obtain values");
+            TermsDistributed = true;
+        }
+
         // Start distributing data
         MPI_Barrier(comm);
 
-        MPI_Allreduce(MPI_IN_PLACE,
-                      m_data.data(),
-                      static_cast<int>(m_data.size()),
-                      POMEROL_MPI_DOUBLE_COMPLEX,
-                      MPI_SUM,
-                      comm);
+        if(Slices)
+            Slices->reduceScatter(m_data);
+        else
+            MPI_Allreduce(MPI_IN_PLACE,
+                          m_data.data(),
+                          static_cast<int>(m_data.size()),
+                          POMEROL_MPI_DOUBLE_COMPLEX,
+                          MPI_SUM,
+                          comm);
 
         // Optionally distribute terms to other processes
-        if(!clear) {
+        if(!clear && !TermsDistributed) {
             for(int p = 0; p < static_cast<int>(parts.size()); ++p) {
                 parts[p].NonResonantTerms.broadcast(comm, job_map[p]);
                 parts[p].ResonantTerms.broadcast(comm, job_map[p]);
@@ -203,6 +348,364 @@ std::vector<ComplexType> TwoParticleGF::compute(bool clear, FreqVec3 const& freq
     return m_data;
 }
 
+// An mpi adapter to compute terms of a group of fusible 2pgf parts at once, fill their values and purge the terms
+template <typename FillFunc> struct ComputeAndClearWrap2PGFFused {
+    ComputeAndClearWrap2PGFFused(FillFunc const& fill_func,
+                                 std::vector<std::vector<ComplexType>*> data,
+                                 std::vector<TwoParticleGFPart*> parts,
+                                 bool clear,
+                                 bool fill,
+                                 std::size_t memory_budget,
+                                 std::size_t output_memory,
+                                 std::size_t& retained,
+                                 pMPI::CostType complexity = 1)
+        : complexity(complexity),
+          fill_func_(fill_func),
+          data_(std::move(data)),
+          parts_(std::move(parts)),
+          clear_(clear),
+          fill_(fill),
+          memory_budget_(memory_budget),
+          output_memory_(output_memory),
+          retained_(retained) {}
+
+    void run() {
+        TwoParticleGFPart::computeFused(parts_);
+        // Terms of all parts in the group are held at the same time
+        std::size_t Reserved = retained_ + output_memory_;
+        for(TwoParticleGFPart const* p : parts_)
+            Reserved += getTermsMemory(*p);
+        for(std::size_t n = 0; n < parts_.size(); ++n) {
+            if(fill_) {
+                std::size_t NumFreqs = data_[n]->size();
+                fillInChunks(fill_func_, *parts_[n], *data_[n], getChunkSize(memory_budget_, NumFreqs, Reserved));
+            }
+            if(clear_) {
+                Reserved -= getTermsMemory(*parts_[n]);
+                parts_[n]->clear();
+            } else
+                retained_ += parts_[n]->getMemoryUsage();
+        }
+    }
+
+    // NOLINTNEXTLINE(cppcoreguidelines-non-private-member-variables-in-classes)
+    pMPI::CostType const complexity; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+
+private:
+    FillFunc const& fill_func_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    std::vector<std::vector<ComplexType>*> data_;
+    std::vector<TwoParticleGFPart*> parts_;
+    bool clear_;
+    bool fill_;
+    std::size_t memory_budget_;
+    std::size_t output_memory_;
+    std::size_t& retained_; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+};
+
+template <typename FillFunc>
+std::vector<std::vector<ComplexType>> TwoParticleGF::computePartsFused(std::vector<TwoParticleGF*> const& GFs,
+                                                                       bool clear,
+                                                                       std::size_t NumFreqs,
+                                                                       FillFunc const& Fill,
+                                                                       MPI_Comm const& comm) {
+    for(TwoParticleGF const* GF : GFs) {
+        if(GF->getStatus() < Prepared)
+            throw StatusMismatch("TwoParticleGF is not prepared yet.");
+    }
+
+    std::vector<std::vector<ComplexType>> m_data(GFs.size());
+
+    // Group fusible parts of all Green's functions. Parts of one group connect the same invariant subspaces
+    // in the same order, so the candidate groups are looked up by the 1st block and the permutation.
+    // Green's functions with different density matrices or pole resolutions are never fused.
+    using GroupKey = std::pair<HamiltonianPart const*, std::array<std::size_t, 3>>;
+    std::map<GroupKey, std::vector<std::size_t>> Candidates;
+    std::vector<std::vector<TwoParticleGFPart*>> Groups;
+    std::vector<std::vector<std::vector<ComplexType>*>> GroupData;
+    std::vector<std::vector<bool>> GroupDistributedTerms;
+    for(std::size_t g = 0; g < GFs.size(); ++g) {
+        TwoParticleGF& GF = *GFs[g];
+        if(GF.getStatus() >= Computed || GF.Vanishing)
+            continue;
+        m_data[g].resize(NumFreqs, 0.0);
+        for(auto& part : GF.parts) {
+            auto& GroupIndices = Candidates[GroupKey(&part.Hpart1, part.Permutation.perm)];
+            auto it = std::find_if(GroupIndices.begin(), GroupIndices.end(), [&](std::size_t Group) {
+                return part.isFusibleWith(*Groups[Group].front());
+            });
+            if(it == GroupIndices.end()) {
+                GroupIndices.push_back(Groups.size());
+                Groups.emplace_back();
+                GroupData.emplace_back();
+                GroupDistributedTerms.emplace_back();
+                it = GroupIndices.end() - 1;
+            }
+            Groups[*it].push_back(&part);
+            GroupData[*it].push_back(&m_data[g]);
+            GroupDistributedTerms[*it].push_back(!clear && GF.DistributedTerms);
+        }
+        GF.TermsDistributed = !clear && GF.DistributedTerms;
+    }
+
+    if(!Groups.empty()) {
+        // The smallest nonzero memory budget of the Green's functions applies to the whole computation
+        std::size_t MemoryBudget = 0;
+        std::size_t OutputMemory = 0;
+        for(std::size_t g = 0; g < GFs.size(); ++g) {
+            if(GFs[g]->MemoryBudget > 0 && (MemoryBudget == 0 || GFs[g]->MemoryBudget < MemoryBudget))
+                MemoryBudget = GFs[g]->MemoryBudget;
+            OutputMemory += m_data[g].size() * sizeof(ComplexType);
+        }
+        if(MemoryBudget > 0 && OutputMemory > MemoryBudget && !pMPI::rank(comm))
+            ERROR("TwoParticleGF: Precomputed values alone need " << OutputMemory
+                                                                  << " bytes and exceed the memory budget");
+
+        // Create a "skeleton" class with pointers to groups of parts that can call a compute method
+        pMPI::mpi_skel<ComputeAndClearWrap2PGFFused<FillFunc>> skel;
+        bool fill_container = NumFreqs > 0;
+        skel.parts.reserve(Groups.size());
+        // Memory occupied by the terms retained on this process
+        std::size_t Retained = 0;
+        for(std::size_t Group = 0; Group < Groups.size(); ++Group) {
+            double Cost = 0;
+            for(TwoParticleGFPart const* part : Groups[Group])
+                Cost += part->estimateCost();
+            skel.parts.emplace_back(Fill,
+                                    GroupData[Group],
+                                    Groups[Group],
+                                    clear,
+                                    fill_container,
+                                    MemoryBudget,
+                                    OutputMemory,
+                                    Retained,
+                                    Cost);
+        }
+        INFO("TwoParticleGF: " << Groups.size() << " groups of fused parts will be calculated");
+        std::map<pMPI::JobId, pMPI::WorkerId> job_map = skel.run(comm, true); // actual running - very costly
+
+        if(!clear && !termsFitIntoBudget(MemoryBudget, OutputMemory, Retained, comm)) {
+            if(!pMPI::rank(comm))
+                INFO("TwoParticleGF: Terms exceed the memory budget and will stay distributed, "
+                     << "use evaluate() to obtain values");
+            for(TwoParticleGF* GF : GFs) {
+                if(GF->getStatus() < Computed && !GF->Vanishing)
+                    GF->TermsDistributed = true;
+            }
+            for(auto& Flags : GroupDistributedTerms)
+                std::fill(Flags.begin(), Flags.end(), true);
+        }
+
+        // Start distributing data
+        MPI_Barrier(comm);
+
+        for(auto& data : m_data) {
+            if(data.empty())
+                continue;
+            MPI_Allreduce(MPI_IN_PLACE,
+                          data.data(),
+                          static_cast<int>(data.size()),
+                          POMEROL_MPI_DOUBLE_COMPLEX,
+                          MPI_SUM,
+                          comm);
+        }
+
+        // Optionally distribute terms to other processes
+        if(!clear) {
+            for(int Group = 0; Group < static_cast<int>(Groups.size()); ++Group) {
+                for(std::size_t n = 0; n < Groups[Group].size(); ++n) {
+                    if(GroupDistributedTerms[Group][n])
+                        continue;
+                    TwoParticleGFPart* part = Groups[Group][n];
+                    part->NonResonantTerms.broadcast(comm, job_map[Group]);
+                    part->ResonantTerms.broadcast(comm, job_map[Group]);
+                    part->setStatus(TwoParticleGFPart::Computed);
+                }
+            }
+            MPI_Barrier(comm);
+        }
+    }
+
+    for(TwoParticleGF* GF : GFs)
+        GF->setStatus(Computed);
+
+    return m_data;
+}
+
+std::vector<ComplexType> TwoParticleGF::computeIrreducible(bool clear,
+                                                           std::vector<MatsubaraTriplet> const& indices,
+                                                           MPI_Comm const& comm) {
+    using Reduction = FrequencySymmetryReduction<MatsubaraTriplet>;
+    std::vector<Reduction::Relation> Relations;
+    // Exchange of the annihilation operators
+    if(C1.getIndex() == C2.getIndex())
+        Relations.push_back({[](MatsubaraTriplet const& n) { return MatsubaraTriplet{n[1], n[0], n[2]}; }, -1, false});
+    // Exchange of the creation operators
+    if(CX3.getIndex() == CX4.getIndex())
+        Relations.push_back(
+            {[](MatsubaraTriplet const& n) { return MatsubaraTriplet{n[0], n[1], n[0] + n[1] - n[2]}; }, -1, false});
+    // Complex conjugation of real-valued operators and Hamiltonian
+    if(!C1.isComplex() && !C2.isComplex() && !CX3.isComplex() && !CX4.isComplex())
+        Relations.push_back(
+            {[](MatsubaraTriplet const& n) { return MatsubaraTriplet{-n[0] - 1, -n[1] - 1, -n[2] - 1}; }, 1, true});
+
+    Reduction const R(indices, Relations);
+    auto const& irreducible = R.getIrreducible();
+    INFO("TwoParticleGF(" << getIndex(0) << getIndex(1) << getIndex(2) << getIndex(3) << "): " << irreducible.size()
+                          << " of " << indices.size() << " frequency triplets are irreducible");
+
+    auto Fill = [&irreducible](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        withSublist(irreducible, First, data.size(), [&](std::vector<MatsubaraTriplet> const& n) {
+            p.accumulateMatsubaraValues(n, data);
+        });
+    };
+    std::vector<ComplexType> m_data = computeParts(clear, irreducible.size(), Fill, comm);
+    return m_data.empty() ? m_data : R.expand(m_data);
+}
+
+std::vector<ComplexType> TwoParticleGF::compute(bool clear, FreqVec3 const& freqs, MPI_Comm const& comm) {
+    // Use the factorized evaluation if all frequencies belong to the Matsubara grid
+    std::vector<MatsubaraTriplet> indices = toMatsubaraIndices(freqs, beta);
+    if(UseFrequencySymmetries && !indices.empty())
+        return computeIrreducible(clear, indices, comm);
+    auto Fill = [&freqs, &indices](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        accumulateRange(p, freqs, indices, First, data);
+    };
+    return computeParts(clear, freqs.size(), Fill, comm);
+}
+
+std::vector<ComplexType> TwoParticleGF::compute(bool clear, FreqGrid3 const& grid, MPI_Comm const& comm) {
+    if(UseFrequencySymmetries && grid.size() > 0) {
+        std::vector<MatsubaraTriplet> indices(grid.size());
+        for(std::size_t w = 0; w < grid.size(); ++w)
+            indices[w] = grid[w];
+        return computeIrreducible(clear, indices, comm);
+    }
+    auto Fill = [&grid](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        p.accumulateMatsubaraValues(grid, data, First);
+    };
+    return computeParts(clear, grid.size(), Fill, comm);
+}
+
+DistributedVector TwoParticleGF::computeDistributed(bool clear, FreqVec3 const& freqs, MPI_Comm const& comm) {
+    // Use the factorized evaluation if all frequencies belong to the Matsubara grid
+    std::vector<MatsubaraTriplet> indices = toMatsubaraIndices(freqs, beta);
+    auto Fill = [&freqs, &indices](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        accumulateRange(p, freqs, indices, First, data);
+    };
+    DistributedVector Slices(comm);
+    computeParts(clear, freqs.size(), Fill, comm, &Slices);
+    return Slices;
+}
+
+DistributedVector TwoParticleGF::computeDistributed(bool clear, FreqGrid3 const& grid, MPI_Comm const& comm) {
+    auto Fill = [&grid](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        p.accumulateMatsubaraValues(grid, data, First);
+    };
+    DistributedVector Slices(comm);
+    computeParts(clear, grid.size(), Fill, comm, &Slices);
+    return Slices;
+}
+
+std::vector<std::vector<ComplexType>> TwoParticleGF::computeFused(std::vector<TwoParticleGF*> const& GFs,
+                                                                  bool clear,
+                                                                  FreqVec3 const& freqs,
+                                                                  MPI_Comm const& comm) {
+    if(GFs.empty())
+        return {};
+    // Use the factorized evaluation if all frequencies belong to the Matsubara grid
+    std::vector<MatsubaraTriplet> indices = toMatsubaraIndices(freqs, GFs.front()->beta);
+    auto Fill = [&freqs, &indices](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        accumulateRange(p, freqs, indices, First, data);
+    };
+    return computePartsFused(GFs, clear, freqs.size(), Fill, comm);
+}
+
+std::vector<std::vector<ComplexType>> TwoParticleGF::computeFused(std::vector<TwoParticleGF*> const& GFs,
+                                                                  bool clear,
+                                                                  FreqGrid3 const& grid,
+                                                                  MPI_Comm const& comm) {
+    auto Fill = [&grid](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        p.accumulateMatsubaraValues(grid, data, First);
+    };
+    return computePartsFused(GFs, clear, grid.size(), Fill, comm);
+}
+
+std::vector<ComplexType> TwoParticleGF::evaluate(std::vector<MatsubaraTriplet> const& indices,
+                                                 MPI_Comm const& comm) const {
+    auto Fill = [&indices](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        withSublist(indices, First, data.size(), [&](std::vector<MatsubaraTriplet> const& n) {
+            p.accumulateMatsubaraValues(n, data);
+        });
+    };
+    return evaluateParts(indices.size(), Fill, comm);
+}
+
+std::vector<ComplexType> TwoParticleGF::evaluate(FreqVec3 const& freqs, MPI_Comm const& comm) const {
+    // Use the factorized evaluation if all frequencies belong to the Matsubara grid
+    std::vector<MatsubaraTriplet> indices = toMatsubaraIndices(freqs, beta);
+    if(!indices.empty())
+        return evaluate(indices, comm);
+    auto Fill = [&freqs](PartTerms const& p, std::size_t First, std::vector<ComplexType>& data) {
+        withSublist(freqs, First, data.size(), [&](FreqVec3 const& f) { p.accumulateValues(f, data); });
+    };
+    return evaluateParts(freqs.size(), Fill, comm);
+}
+
+template <typename FillFunc>
+std::vector<ComplexType>
+TwoParticleGF::evaluateParts(std::size_t NumFreqs, FillFunc const& Fill, MPI_Comm const& comm) const {
+    if(getStatus() < Computed)
+        throw StatusMismatch("TwoParticleGF is not computed yet.");
+
+    std::vector<ComplexType> data(NumFreqs, 0.0);
+    if(Vanishing)
+        return data;
+
+    if(!TermsDistributed && std::any_of(parts.begin(), parts.end(), [](TwoParticleGFPart const& p) {
+           return p.getStatus() != TwoParticleGFPart::Computed;
+       }))
+        throw StatusMismatch("TwoParticleGF: Evaluating uncomputed parts. Did you purge all the terms when called "
+                             "compute()?");
+
+    // Only the parts computed by or broadcast to this process carry terms
+    std::size_t Reserved = NumFreqs * sizeof(ComplexType) + getMemoryUsage();
+    for(auto const& part : parts) {
+        if(part.getStatus() != TwoParticleGFPart::Computed)
+            continue;
+        std::size_t PartReserved = Reserved + getTermsMemory(part) - part.getMemoryUsage();
+        fillInChunks(Fill, part, data, getChunkSize(MemoryBudget, NumFreqs, PartReserved));
+    }
+
+    if(TermsDistributed)
+        MPI_Allreduce(MPI_IN_PLACE,
+                      data.data(),
+                      static_cast<int>(data.size()),
+                      POMEROL_MPI_DOUBLE_COMPLEX,
+                      MPI_SUM,
+                      comm);
+
+    return data;
+}
+
+void TwoParticleGF::freeze() {
+    if(getStatus() < Computed)
+        throw StatusMismatch("TwoParticleGF is not computed yet.");
+    for(auto& part : parts) {
+        // Parts computed by other processes are skipped when the terms are distributed
+        if(!TermsDistributed || part.getStatus() == TwoParticleGFPart::Computed)
+            part.freeze();
+    }
+}
+
+std::size_t TwoParticleGF::getMemoryUsage() const {
+    std::size_t Usage = 0;
+    for(auto const& part : parts) {
+        if(part.getStatus() == TwoParticleGFPart::Computed)
+            Usage += part.getMemoryUsage();
+    }
+    return Usage;
+}
+
 ParticleIndex TwoParticleGF::getIndex(std::size_t Position) const {
     switch(Position) {
     case 0: return C1.getIndex();
@@ -17,6 +17,7 @@
 
 #include <cmath>
 #include <cstddef>
+#include <utility>
 
 namespace Pomerol {
 
@@ -26,20 +27,36 @@ void TwoParticleGFContainer::prepareAll(std::set<IndexCombination4> const& Initi
         auto& g2 = static_cast<TwoParticleGF&>(el.second);
         g2.PoleResolution = PoleResolution;
         g2.CoefficientTolerance = CoefficientTolerance;
+        g2.UseFrequencySymmetries = UseFrequencySymmetries;
+        g2.DistributedTerms = DistributedTerms;
+        g2.MemoryBudget = MemoryBudget;
         g2.prepare();
     }
 }
 
 std::map<IndexCombination4, std::vector<ComplexType>>
 TwoParticleGFContainer::computeAll(bool clearTerms, FreqVec3 const& freqs, MPI_Comm const& comm, bool split) {
-    if(split)
+    if(FuseComponents)
+        return computeAll_fused(clearTerms, freqs, comm);
+    else if(split)
         return computeAll_split(clearTerms, freqs, comm);
     else
         return computeAll_nosplit(clearTerms, freqs, comm);
 }
 
 std::map<IndexCombination4, std::vector<ComplexType>>
-TwoParticleGFContainer::computeAll_nosplit(bool clearTerms, FreqVec3 const& freqs, MPI_Comm const& comm) {
+TwoParticleGFContainer::computeAll(bool clearTerms, FreqGrid3 const& grid, MPI_Comm const& comm, bool split) {
+    if(FuseComponents)
+        return computeAll_fused(clearTerms, grid, comm);
+    else if(split)
+        return computeAll_split(clearTerms, grid, comm);
+    else
+        return computeAll_nosplit(clearTerms, grid, comm);
+}
+
+template <typename Freqs>
+std::map<IndexCombination4, std::vector<ComplexType>>
+TwoParticleGFContainer::computeAll_nosplit(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm) {
     std::map<IndexCombination4, std::vector<ComplexType>> out;
     for(auto& el : ElementsMap) {
         INFO("Computing 2PGF for " << el.first);
@@ -48,8 +65,9 @@ TwoParticleGFContainer::computeAll_nosplit(bool clearTerms, FreqVec3 const& freq
     return out;
 }
 
+template <typename Freqs>
 std::map<IndexCombination4, std::vector<ComplexType>>
-TwoParticleGFContainer::computeAll_split(bool clearTerms, FreqVec3 const& freqs, MPI_Comm const& comm) {
+TwoParticleGFContainer::computeAll_split(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm) {
     std::map<IndexCombination4, std::vector<ComplexType>> out;
     std::map<IndexCombination4, std::vector<ComplexType>> storage;
 
@@ -95,12 +113,39 @@ TwoParticleGFContainer::computeAll_split(bool clearTerms, FreqVec3 const& freqs,
     if(!comm_rank)
         INFO_NONEWLINE("Distributing 2PGF container...");
     comp = 0;
+    // Memory occupied by the precomputed values of all components and by the terms broadcast to all processes
+    std::size_t OutputMemory = NonTrivialElements.size() * freqs.size() * sizeof(ComplexType);
+    std::size_t TermsMemory = 0;
     for(auto iter = NonTrivialElements.begin(); iter != NonTrivialElements.end(); iter++, comp++) {
         int sender = color_roots[elem_colors[comp]];
         TwoParticleGF& chi = *((iter)->second);
+        if(!clearTerms) {
+            // The terms may have stayed distributed within the communicator of the sender
+            int Distributed = chi.TermsDistributed;
+            auto ElementMemory = static_cast<unsigned long long>(chi.getMemoryUsage());
+            MPI_Bcast(&Distributed, 1, MPI_INT, sender, comm);
+            MPI_Bcast(&ElementMemory, 1, MPI_UNSIGNED_LONG_LONG, sender, comm);
+            chi.TermsDistributed = Distributed != 0;
+            if(!chi.TermsDistributed && chi.MemoryBudget > 0 &&
+               TermsMemory + ElementMemory + OutputMemory > chi.MemoryBudget) {
+                if(!comm_rank)
+                    INFO("Terms of 2PGF " << iter->first << " exceed the memory budget and will stay on process "
+                                          << sender << ", use evaluate() to obtain values");
+                // Keep only one copy of the terms, so that the collective evaluation counts them once
+                chi.TermsDistributed = true;
+                if(comm_rank != sender) {
+                    for(auto& part : chi.parts)
+                        part.clear();
+                }
+            } else if(!chi.TermsDistributed)
+                TermsMemory += ElementMemory;
+        }
         for(std::size_t p = 0; p < chi.parts.size(); p++) {
-            chi.parts[p].NonResonantTerms.broadcast(comm, sender);
-            chi.parts[p].ResonantTerms.broadcast(comm, sender);
+            if(!clearTerms && !chi.TermsDistributed) {
+                chi.parts[p].NonResonantTerms.broadcast(comm, sender);
+                chi.parts[p].ResonantTerms.broadcast(comm, sender);
+                chi.parts[p].setStatus(TwoParticleGFPart::Computed);
+            }
             std::vector<ComplexType> freq_data;
             int freq_data_size = {};
             if(comm_rank == sender) {
@@ -126,6 +171,24 @@ TwoParticleGFContainer::computeAll_split(bool clearTerms, FreqVec3 const& freqs,
     return out;
 }
 
+template <typename Freqs>
+std::map<IndexCombination4, std::vector<ComplexType>>
+TwoParticleGFContainer::computeAll_fused(bool clearTerms, Freqs const& freqs, MPI_Comm const& comm) {
+    std::vector<TwoParticleGF*> GFs;
+    GFs.reserve(NonTrivialElements.size());
+    for(auto const& el : NonTrivialElements)
+        GFs.push_back(el.second.get());
+
+    INFO("Computing " << GFs.size() << " 2PGF components with fused parts");
+    std::vector<std::vector<ComplexType>> data = TwoParticleGF::computeFused(GFs, clearTerms, freqs, comm);
+
+    std::map<IndexCombination4, std::vector<ComplexType>> out;
+    std::size_t comp = 0;
+    for(auto const& el : NonTrivialElements)
+        out.emplace(el.first, std::move(data[comp++]));
+    return out;
+}
+
 std::shared_ptr<TwoParticleGF> TwoParticleGFContainer::createElement(IndexCombination4 const& Indices) const {
     AnnihilationOperator const& C1 = Operators.getAnnihilationOperator(Indices.Index1);
     AnnihilationOperator const& C2 = Operators.getAnnihilationOperator(Indices.Index2);
@@ -16,9 +16,14 @@
 #include "pomerol/TwoParticleGFPart.hpp"
 #include "pomerol/ChaseIndices.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <cmath>
+#include <cstddef>
 #include <mutex>
 #include <stdexcept>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -29,6 +34,476 @@ static std::mutex ResonantTerm_mpi_datatype_mutex;
 
 namespace Pomerol {
 
+namespace {
+
+// Union of sparsity patterns of several matrices of the same shape.
+// Each stored element carries values of all matrices, zeros for matrices that do not have the element.
+// Matrices of densely stored operator parts contribute their non-zero elements and are read directly.
+template <bool Complex> struct FusedSparseMatrix {
+
+    std::size_t NumMatrices;
+    // Elements of the o-th outer vector occupy positions [OuterStarts[o], OuterStarts[o+1])
+    std::vector<std::size_t> OuterStarts = {0};
+    std::vector<InnerQuantumState> InnerIndices;
+    // Values of the n-th element occupy positions [n * NumMatrices, (n+1) * NumMatrices)
+    std::vector<MelemType<Complex>> Values;
+
+    // getView() returns a row-major or a column-major sparse view of a part and defines the storage order.
+    template <typename GetView>
+    FusedSparseMatrix(std::vector<MonomialOperatorPart const*> const& Parts, GetView const& getView)
+        : NumMatrices(Parts.size()) {
+        using ViewType = decltype(getView(*Parts.front()));
+        bool const RowMajor = ViewType::IsRowMajor;
+
+        // Views of sparsely stored matrices and pointers to densely stored ones
+        std::vector<ViewType> Views;
+        std::vector<std::size_t> ViewPositions(NumMatrices, 0);
+        std::vector<MatrixType<Complex> const*> DenseMatrices(NumMatrices, nullptr);
+        for(std::size_t m = 0; m < NumMatrices; ++m) {
+            if(Parts[m]->isDense())
+                DenseMatrices[m] = &Parts[m]->getDenseValue<Complex>();
+            else {
+                ViewPositions[m] = Views.size();
+                Views.push_back(getView(*Parts[m]));
+            }
+        }
+        Eigen::Index OuterSize = RowMajor ? Parts.front()->getNumberOfRows() : Parts.front()->getNumberOfColumns();
+        Eigen::Index InnerSize = RowMajor ? Parts.front()->getNumberOfColumns() : Parts.front()->getNumberOfRows();
+
+        struct Element {
+            InnerQuantumState Inner;
+            std::size_t Matrix;
+            MelemType<Complex> Value;
+        };
+        std::vector<Element> Elements;
+        for(Eigen::Index outer = 0; outer < OuterSize; ++outer) {
+            Elements.clear();
+            for(std::size_t m = 0; m < NumMatrices; ++m) {
+                if(DenseMatrices[m]) {
+                    auto const& M = *DenseMatrices[m];
+                    for(Eigen::Index inner = 0; inner < InnerSize; ++inner) {
+                        MelemType<Complex> Value = RowMajor ? M(outer, inner) : M(inner, outer);
+                        if(Value != MelemType<Complex>(0))
+                            Elements.push_back({static_cast<InnerQuantumState>(inner), m, Value});
+                    }
+                } else {
+                    for(typename ViewType::InnerIterator it(Views[ViewPositions[m]], outer); it; ++it)
+                        Elements.push_back({static_cast<InnerQuantumState>(it.index()), m, it.value()});
+                }
+            }
+            std::stable_sort(Elements.begin(), Elements.end(), [](Element const& e1, Element const& e2) {
+                return e1.Inner < e2.Inner;
+            });
+            for(std::size_t e = 0; e < Elements.size(); ++e) {
+                if(e == 0 || Elements[e].Inner != Elements[e - 1].Inner) {
+                    InnerIndices.push_back(Elements[e].Inner);
+                    Values.resize(Values.size() + NumMatrices, MelemType<Complex>(0));
+                }
+                Values[Values.size() - NumMatrices + Elements[e].Matrix] = Elements[e].Value;
+            }
+            OuterStarts.push_back(InnerIndices.size());
+        }
+    }
+
+    MelemType<Complex> const* values(std::size_t n) const { return Values.data() + n * NumMatrices; }
+};
+
+// Lists of pairs (index4, <index3|O3|index4><index4|CX4|index1>) for a fixed state index1 and all states index3
+// connected to it by at least one intermediate state index4. The lists of one row index1 are built on demand
+// by a symbolic sparse product of O3 and the column index1 of CX4, and are stored contiguously, ordered by
+// index3 and index4. For fused parts, each element carries the products for all parts.
+// Every thread owns an instance, so that the memory footprint is bounded by O(Size3 * Size4) per thread.
+template <bool Complex> struct Index4Lists {
+
+    FusedSparseMatrix<Complex> const& O3;
+    FusedSparseMatrix<Complex> const& CX4;
+    std::size_t NumMatrices;
+    // Indices index3 of each non-empty list
+    std::vector<InnerQuantumState> Index3;
+    // Elements of the p-th list occupy positions [Offsets[p], Offsets[p+1]) in Index4
+    std::vector<std::size_t> Offsets = {0};
+    std::vector<InnerQuantumState> Index4;
+    // NumMatrices values per element
+    std::vector<MelemType<Complex>> Values;
+
+    Index4Lists(FusedSparseMatrix<Complex> const& O3, FusedSparseMatrix<Complex> const& CX4, std::size_t Size3)
+        : O3(O3), CX4(CX4), NumMatrices(O3.NumMatrices), BucketIndices(Size3), BucketValues(Size3) {}
+
+    // Build the lists for a given state index1, replacing the previously built ones
+    void build(InnerQuantumState index1) {
+        Index3.clear();
+        Offsets.resize(1);
+        Index4.clear();
+        Values.clear();
+
+        for(std::size_t n4 = CX4.OuterStarts[index1]; n4 < CX4.OuterStarts[index1 + 1]; ++n4) {
+            InnerQuantumState index4 = CX4.InnerIndices[n4];
+            auto const* Values4 = CX4.values(n4);
+            for(std::size_t n3 = O3.OuterStarts[index4]; n3 < O3.OuterStarts[index4 + 1]; ++n3) {
+                InnerQuantumState index3 = O3.InnerIndices[n3];
+                auto const* Values3 = O3.values(n3);
+                if(BucketIndices[index3].empty())
+                    Touched.push_back(index3);
+                BucketIndices[index3].push_back(index4);
+                for(std::size_t m = 0; m < NumMatrices; ++m)
+                    BucketValues[index3].push_back(Values3[m] * Values4[m]);
+            }
+        }
+        std::sort(Touched.begin(), Touched.end());
+        for(InnerQuantumState index3 : Touched) {
+            Index3.push_back(index3);
+            Index4.insert(Index4.end(), BucketIndices[index3].begin(), BucketIndices[index3].end());
+            Values.insert(Values.end(), BucketValues[index3].begin(), BucketValues[index3].end());
+            Offsets.push_back(Index4.size());
+            BucketIndices[index3].clear();
+            BucketValues[index3].clear();
+        }
+        Touched.clear();
+    }
+
+    std::size_t size() const { return Index3.size(); }
+
+    MelemType<Complex> const* values(std::size_t n) const { return Values.data() + n * NumMatrices; }
+
+private:
+    // Scratch space of build(): intermediate states and products grouped by index3
+    std::vector<std::vector<InnerQuantumState>> BucketIndices;
+    std::vector<std::vector<MelemType<Complex>>> BucketValues;
+    std::vector<InnerQuantumState> Touched;
+};
+
+// Copy statistical weights of a block into a flat array
+std::vector<RealType> getWeights(DensityMatrixPart const& DMpart, Eigen::Index Size) {
+    std::vector<RealType> Weights(static_cast<std::size_t>(Size));
+    for(Eigen::Index s = 0; s < Size; ++s)
+        Weights[s] = DMpart.getWeight(static_cast<InnerQuantumState>(s));
+    return Weights;
+}
+
+// Copy upper bounds of statistical weights of a block, max_{s' >= s} w_{s'}, into a flat array
+std::vector<RealType> getMaxWeights(DensityMatrixPart const& DMpart, Eigen::Index Size) {
+    std::vector<RealType> MaxWeights(static_cast<std::size_t>(Size));
+    for(Eigen::Index s = 0; s < Size; ++s)
+        MaxWeights[s] = DMpart.getMaxWeight(static_cast<InnerQuantumState>(s));
+    return MaxWeights;
+}
+
+// Number of frequency triplets evaluated at once by the structure-of-arrays kernels
+constexpr std::size_t FreqTileSize = 8;
+
+// A tile of frequency triplets (z1, z2, z3) in the structure-of-arrays layout,
+// and the accumulated values of the terms at those triplets.
+struct FreqTile {
+    std::array<RealType, FreqTileSize> Re1, Im1, Re2, Im2, Re3, Im3;
+    std::array<RealType, FreqTileSize> ValueRe, ValueIm;
+};
+
+// Terms C / ((z1 - P1)(z2 - P2)(z3 - P3)) or, if Z4 is true, C / ((z1 - P1)(z1 + z2 + z3 - P1 - P2 - P3)(z3 - P3))
+template <bool Z4> void addNonResonantTerms(TwoParticleGFPart::TermArrays const& Terms, FreqTile& F) {
+    for(std::size_t n = 0; n < Terms.size(); ++n) {
+        RealType Cr = Terms.CoeffRe[n], Ci = Terms.CoeffIm[n];
+        RealType P1 = Terms.P1[n], P2 = Terms.P2[n], P3 = Terms.P3[n];
+#ifdef POMEROL_USE_OPENMP
+#pragma omp simd
+#endif
+        for(std::size_t t = 0; t < FreqTileSize; ++t) {
+            RealType D1r = F.Re1[t] - P1, D1i = F.Im1[t];
+            RealType D2r = Z4 ? F.Re1[t] + F.Re2[t] + F.Re3[t] - P1 - P2 - P3 : F.Re2[t] - P2;
+            RealType D2i = Z4 ? F.Im1[t] + F.Im2[t] + F.Im3[t] : F.Im2[t];
+            RealType D3r = F.Re3[t] - P3, D3i = F.Im3[t];
+            RealType D12r = D1r * D2r - D1i * D2i, D12i = D1r * D2i + D1i * D2r;
+            RealType Dr = D12r * D3r - D12i * D3i, Di = D12r * D3i + D12i * D3r;
+            RealType InvNorm = 1.0 / (Dr * Dr + Di * Di);
+            F.ValueRe[t] += (Cr * Dr + Ci * Di) * InvNorm;
+            F.ValueIm[t] += (Ci * Dr - Cr * Di) * InvNorm;
+        }
+    }
+}
+
+// Terms (R if |Diff| <= DeltaTolerance, N / Diff otherwise) / ((z1 - P1)(z3 - P3)),
+// where Diff = z1 + z2 - P1 - P2 if Z1Z2 is true, and Diff = z2 + z3 - P2 - P3 otherwise
+template <bool Z1Z2>
+void addResonantTerms(TwoParticleGFPart::TermArrays const& Terms, FreqTile& F, RealType DeltaTolerance) {
+    RealType DeltaTolerance2 = DeltaTolerance * DeltaTolerance;
+    for(std::size_t n = 0; n < Terms.size(); ++n) {
+        RealType Rr = Terms.CoeffRe[n], Ri = Terms.CoeffIm[n];
+        RealType Nr = Terms.NonResCoeffRe[n], Ni = Terms.NonResCoeffIm[n];
+        RealType P1 = Terms.P1[n], P2 = Terms.P2[n], P3 = Terms.P3[n];
+#ifdef POMEROL_USE_OPENMP
+#pragma omp simd
+#endif
+        for(std::size_t t = 0; t < FreqTileSize; ++t) {
+            RealType Diffr = Z1Z2 ? F.Re1[t] + F.Re2[t] - P1 - P2 : F.Re2[t] + F.Re3[t] - P2 - P3;
+            RealType Diffi = Z1Z2 ? F.Im1[t] + F.Im2[t] : F.Im2[t] + F.Im3[t];
+            bool Resonance = Diffr * Diffr + Diffi * Diffi <= DeltaTolerance2;
+            // Avoid division by zero in the masked out branch
+            RealType SafeDiffr = Resonance ? 1.0 : Diffr, SafeDiffi = Resonance ? 0.0 : Diffi;
+            RealType InvDiffNorm = 1.0 / (SafeDiffr * SafeDiffr + SafeDiffi * SafeDiffi);
+            RealType Numr = Resonance ? Rr : (Nr * SafeDiffr + Ni * SafeDiffi) * InvDiffNorm;
+            RealType Numi = Resonance ? Ri : (Ni * SafeDiffr - Nr * SafeDiffi) * InvDiffNorm;
+
+            RealType D1r = F.Re1[t] - P1, D1i = F.Im1[t];
+            RealType D3r = F.Re3[t] - P3, D3i = F.Im3[t];
+            RealType Dr = D1r * D3r - D1i * D3i, Di = D1r * D3i + D1i * D3r;
+            RealType InvNorm = 1.0 / (Dr * Dr + Di * Di);
+            F.ValueRe[t] += (Numr * Dr + Numi * Di) * InvNorm;
+            F.ValueIm[t] += (Numi * Dr - Numr * Di) * InvNorm;
+        }
+    }
+}
+
+// Evaluate all frozen terms at all triplets of a tile
+void evaluateTile(TwoParticleGFPart::FrozenTerms const& Terms, FreqTile& F, RealType DeltaTolerance) {
+    F.ValueRe.fill(0);
+    F.ValueIm.fill(0);
+    addNonResonantTerms<false>(Terms.NonResonantZ2, F);
+    addNonResonantTerms<true>(Terms.NonResonantZ4, F);
+    addResonantTerms<true>(Terms.ResonantZ1Z2, F, DeltaTolerance);
+    addResonantTerms<false>(Terms.ResonantZ2Z3, F, DeltaTolerance);
+}
+
+// Put a frequency triplet into a tile
+void setTileFrequencies(FreqTile& F, std::size_t t, std::array<ComplexType, 3> const& z) {
+    F.Re1[t] = z[0].real();
+    F.Im1[t] = z[0].imag();
+    F.Re2[t] = z[1].real();
+    F.Im2[t] = z[1].imag();
+    F.Re3[t] = z[2].real();
+    F.Im3[t] = z[2].imag();
+}
+
+// Table of factors 1/(i\omega_m - P) for a set of distinct poles P and a range of Matsubara indices m.
+// Factors for one Matsubara index are stored contiguously.
+class PoleTable {
+    std::vector<RealType> Poles;
+    long MinIndex = 0;
+    long MaxIndex = -1;
+    std::vector<ComplexType> Values;
+
+public:
+    // Which values to store
+    enum Kind {
+        Factors, // 1/(i\omega_m - P), or 0 if |i\omega_m - P| <= DeltaTolerance
+        Resonances // 1 if |i\omega_m - P| <= DeltaTolerance, 0 otherwise
+    };
+
+    // Build a table for poles AllPoles (possibly repeated) and Matsubara indices MinIndex <= m <= MaxIndex
+    PoleTable(std::vector<RealType> AllPoles,
+              long MinIndex,
+              long MaxIndex,
+              RealType beta,
+              bool Bosonic,
+              RealType DeltaTolerance,
+              Kind kind = Factors)
+        : Poles(std::move(AllPoles)), MinIndex(MinIndex), MaxIndex(MaxIndex) {
+        std::sort(Poles.begin(), Poles.end());
+        Poles.erase(std::unique(Poles.begin(), Poles.end()), Poles.end());
+        if(Poles.empty())
+            return;
+
+        Values.resize((MaxIndex - MinIndex + 1) * Poles.size());
+        for(long m = MinIndex; m <= MaxIndex; ++m) {
+            ComplexType iomega(0, Bosonic ? 2 * M_PI * m / beta : M_PI * (2 * m + 1) / beta);
+            for(std::size_t u = 0; u < Poles.size(); ++u) {
+                ComplexType D = iomega - Poles[u];
+                bool Resonance = std::abs(D) <= DeltaTolerance;
+                if(kind == Factors)
+                    Values[row(m) + u] = Resonance ? ComplexType(0) : ComplexType(D.real(), -D.imag()) / std::norm(D);
+                else
+                    Values[row(m) + u] = Resonance ? 1 : 0;
+            }
+        }
+    }
+
+    // Number of distinct poles
+    std::size_t numPoles() const { return Poles.size(); }
+    // Column of the table corresponding to a pole
+    std::size_t column(RealType P) const { return std::lower_bound(Poles.begin(), Poles.end(), P) - Poles.begin(); }
+    // Offset of the row corresponding to a Matsubara index
+    std::size_t row(long m) const { return (m - MinIndex) * Poles.size(); }
+    // Pointer to the row corresponding to a Matsubara index
+    ComplexType const* operator[](long m) const { return Values.data() + row(m); }
+    // Is a column identically zero?
+    bool isZeroColumn(std::size_t u) const {
+        for(long m = MinIndex; m <= MaxIndex; ++m) {
+            if(Values[row(m) + u] != ComplexType(0))
+                return false;
+        }
+        return true;
+    }
+};
+
+// Product of complex numbers without the overhead of the C99 Annex G semantics
+inline ComplexType mul(ComplexType a, ComplexType b) {
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+// A group of terms of the form C * F_0(k_0) * F_1(k_1) * F_2(k_2), where F_a are columns of pole tables
+// and k_a are integer Matsubara indices determined by a frequency point.
+struct FactorizedTerms {
+    std::vector<ComplexType> Coeff;
+    std::array<PoleTable const*, 3> Tables;
+    std::array<std::vector<std::size_t>, 3> Columns;
+    // Values of k_a at all frequency points
+    std::array<std::vector<long> const*, 3> Indices;
+
+    std::size_t size() const { return Coeff.size(); }
+    void add(ComplexType C, std::size_t c0, std::size_t c1, std::size_t c2) {
+        Coeff.push_back(C);
+        Columns[0].push_back(c0);
+        Columns[1].push_back(c1);
+        Columns[2].push_back(c2);
+    }
+};
+
+// Add the values of a group of terms at all frequency points to Values.
+//
+// The terms are contracted one factor at a time. With the factors reordered as (A, B, C),
+//   H_{uA,uB}(k_C) = \sum_{terms with (uA,uB)} Coeff * F_C(k_C),
+//   K_{uA}(k_B, k_C) = \sum_{uB} F_B(k_B) H_{uA,uB}(k_C),
+//   Value(k_A, k_B, k_C) = \sum_{uA} F_A(k_A) K_{uA}(k_B, k_C).
+// On a regular grid, k_C and (k_B, k_C) take much fewer distinct values than there are frequency points,
+// and the pairs (uA, uB) are much fewer than terms. The order of factors that minimizes the estimated
+// number of operations is chosen, and the direct summation is used if it is cheaper.
+void addFactorizedTerms(FactorizedTerms const& T, std::vector<ComplexType>& Values) {
+    if(T.size() == 0)
+        return;
+    long NumFreqs = static_cast<long>(Values.size());
+
+    std::array<long, 3> MinIndex, MaxIndex;
+    for(int a = 0; a < 3; ++a) {
+        auto MinMax = std::minmax_element(T.Indices[a]->begin(), T.Indices[a]->end());
+        MinIndex[a] = *MinMax.first;
+        MaxIndex[a] = *MinMax.second;
+    }
+
+    // Distinct pairs of columns (uA, uB) and distinct pairs of indices (k_B, k_C)
+    auto columnPairs = [&T](int A, int B) {
+        std::vector<std::pair<std::size_t, std::size_t>> Pairs(T.size());
+        for(std::size_t t = 0; t < T.size(); ++t)
+            Pairs[t] = std::make_pair(T.Columns[A][t], T.Columns[B][t]);
+        std::sort(Pairs.begin(), Pairs.end());
+        Pairs.erase(std::unique(Pairs.begin(), Pairs.end()), Pairs.end());
+        return Pairs;
+    };
+    auto indexPairs = [&T, NumFreqs](int B, int C) {
+        std::vector<std::pair<long, long>> Pairs(NumFreqs);
+        for(long w = 0; w < NumFreqs; ++w)
+            Pairs[w] = std::make_pair((*T.Indices[B])[w], (*T.Indices[C])[w]);
+        std::sort(Pairs.begin(), Pairs.end());
+        Pairs.erase(std::unique(Pairs.begin(), Pairs.end()), Pairs.end());
+        return Pairs;
+    };
+
+    std::array<std::array<double, 3>, 3> NumColumnPairs{}, NumIndexPairs{};
+    for(int a = 0; a < 3; ++a) {
+        for(int b = a + 1; b < 3; ++b) {
+            NumColumnPairs[a][b] = NumColumnPairs[b][a] = double(columnPairs(a, b).size());
+            NumIndexPairs[a][b] = NumIndexPairs[b][a] = double(indexPairs(a, b).size());
+        }
+    }
+
+    double DirectCost = double(T.size()) * double(NumFreqs);
+    double BestCost = DirectCost;
+    std::array<int, 3> Best = {-1, -1, -1};
+    std::array<std::array<int, 3>, 6> const Orders = {
+        {{{0, 1, 2}}, {{0, 2, 1}}, {{1, 0, 2}}, {{1, 2, 0}}, {{2, 0, 1}}, {{2, 1, 0}}}};
+    for(auto const& Order : Orders) {
+        int A = Order[0], B = Order[1], C = Order[2];
+        double Cost = double(T.size()) * double(MaxIndex[C] - MinIndex[C] + 1) +
+                      NumColumnPairs[A][B] * NumIndexPairs[B][C] + double(T.Tables[A]->numPoles()) * double(NumFreqs);
+        if(Cost < BestCost) {
+            BestCost = Cost;
+            Best = Order;
+        }
+    }
+
+    if(Best[0] == -1) { // Direct summation
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long w = 0; w < NumFreqs; ++w) {
+            ComplexType const* F0 = (*T.Tables[0])[(*T.Indices[0])[w]];
+            ComplexType const* F1 = (*T.Tables[1])[(*T.Indices[1])[w]];
+            ComplexType const* F2 = (*T.Tables[2])[(*T.Indices[2])[w]];
+            ComplexType Value = 0;
+            for(std::size_t t = 0; t < T.size(); ++t)
+                Value += mul(mul(T.Coeff[t], F0[T.Columns[0][t]]), mul(F1[T.Columns[1][t]], F2[T.Columns[2][t]]));
+            Values[w] += Value;
+        }
+        return;
+    }
+
+    int A = Best[0], B = Best[1], C = Best[2];
+    auto const& TA = *T.Tables[A];
+    auto const& TB = *T.Tables[B];
+    auto const& TC = *T.Tables[C];
+    auto ColumnPairs = columnPairs(A, B);
+    auto IndexPairs = indexPairs(B, C);
+    long RangeC = MaxIndex[C] - MinIndex[C] + 1;
+
+    // H_{uA,uB}(k_C)
+    std::vector<ComplexType> H(ColumnPairs.size() * RangeC, 0);
+    for(std::size_t t = 0; t < T.size(); ++t) {
+        std::size_t p = std::lower_bound(ColumnPairs.begin(),
+                                         ColumnPairs.end(),
+                                         std::make_pair(T.Columns[A][t], T.Columns[B][t])) -
+                        ColumnPairs.begin();
+        std::size_t uC = T.Columns[C][t];
+        for(long kC = MinIndex[C]; kC <= MaxIndex[C]; ++kC)
+            H[p * RangeC + (kC - MinIndex[C])] += mul(T.Coeff[t], TC[kC][uC]);
+    }
+
+    // K_{uA}(k_B, k_C)
+    std::size_t NumPolesA = TA.numPoles();
+    std::vector<ComplexType> K(IndexPairs.size() * NumPolesA, 0);
+    long NumBC = static_cast<long>(IndexPairs.size());
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+    for(long bc = 0; bc < NumBC; ++bc) {
+        long kB = IndexPairs[bc].first, kC = IndexPairs[bc].second;
+        ComplexType const* FB = TB[kB];
+        ComplexType* Kbc = K.data() + bc * NumPolesA;
+        for(std::size_t p = 0; p < ColumnPairs.size(); ++p)
+            Kbc[ColumnPairs[p].first] += mul(FB[ColumnPairs[p].second], H[p * RangeC + (kC - MinIndex[C])]);
+    }
+
+    // Values at the frequency points
+    std::vector<std::size_t> ColumnsA;
+    for(auto const& pair : ColumnPairs) {
+        if(ColumnsA.empty() || ColumnsA.back() != pair.first)
+            ColumnsA.push_back(pair.first);
+    }
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+    for(long w = 0; w < NumFreqs; ++w) {
+        auto bc = std::lower_bound(IndexPairs.begin(),
+                                   IndexPairs.end(),
+                                   std::make_pair((*T.Indices[B])[w], (*T.Indices[C])[w])) -
+                  IndexPairs.begin();
+        ComplexType const* FA = TA[(*T.Indices[A])[w]];
+        ComplexType const* Kbc = K.data() + bc * NumPolesA;
+        ComplexType Value = 0;
+        for(std::size_t uA : ColumnsA)
+            Value += mul(FA[uA], Kbc[uA]);
+        Values[w] += Value;
+    }
+}
+
+// Contiguous range of points of a frequency grid
+struct GridRange {
+    FreqGrid3 const& Grid;
+    std::size_t First;
+    std::size_t Count;
+
+    std::size_t size() const { return Count; }
+    MatsubaraTriplet operator[](std::size_t w) const { return Grid[First + w]; }
+};
+
+} // namespace
+
 //
 // TwoParticleGFPart::NonResonantTerm
 //
@@ -174,97 +649,258 @@ TwoParticleGFPart::TwoParticleGFPart(MonomialOperatorPart const& O1,
                     ResonantTerm::KeyEqual(PoleResolution),
                     ResonantTerm::IsNegligible(CoefficientTolerance)),
       PoleResolution(PoleResolution),
-      CoefficientTolerance(CoefficientTolerance) {}
+      CoefficientTolerance(CoefficientTolerance) {
+    O1.request();
+    O2.request();
+    O3.request();
+    CX4.request();
+}
 
 void TwoParticleGFPart::compute() {
     if(getStatus() >= Computed)
         return;
 
-    if(O1.isComplex() || O2.isComplex() || O3.isComplex() || CX4.isComplex())
-        computeImpl<true>();
+    computeFused({this});
+}
+
+double TwoParticleGFPart::estimateCost() const {
+    double N1 = std::max<double>(Hpart1.getNumberOfEigenValues(), 1);
+    double N2 = std::max<double>(Hpart2.getNumberOfEigenValues(), 1);
+    double N3 = std::max<double>(Hpart3.getNumberOfEigenValues(), 1);
+    double N4 = std::max<double>(Hpart4.getNumberOfEigenValues(), 1);
+    double NNZ = O1.estimateNonZeros() * O2.estimateNonZeros() * O3.estimateNonZeros() * CX4.estimateNonZeros();
+    return N1 * N3 + NNZ / (N1 * N2 * N3 * N4);
+}
+
+bool TwoParticleGFPart::isFusibleWith(TwoParticleGFPart const& Part) const {
+    auto isComplex = [](TwoParticleGFPart const& p) {
+        return p.O1.isComplex() || p.O2.isComplex() || p.O3.isComplex() || p.CX4.isComplex();
+    };
+    // The fused kernel takes the energies and the statistical weights from the first part of a group
+    return &Hpart1 == &Part.Hpart1 && &Hpart2 == &Part.Hpart2 && &Hpart3 == &Part.Hpart3 &&
+           &Hpart4 == &Part.Hpart4 && &DMpart1 == &Part.DMpart1 && &DMpart2 == &Part.DMpart2 &&
+           &DMpart3 == &Part.DMpart3 && &DMpart4 == &Part.DMpart4 && Permutation.perm == Part.Permutation.perm &&
+           PoleResolution == Part.PoleResolution && isComplex(*this) == isComplex(Part);
+}
+
+void TwoParticleGFPart::computeFused(std::vector<TwoParticleGFPart*> const& Parts) {
+    std::vector<TwoParticleGFPart*> PartsToCompute;
+    for(TwoParticleGFPart* Part : Parts) {
+        if(Part->getStatus() < Computed)
+            PartsToCompute.push_back(Part);
+    }
+    if(PartsToCompute.empty())
+        return;
+
+    for(TwoParticleGFPart const* Part : PartsToCompute) {
+        if(!Part->isFusibleWith(*PartsToCompute.front()))
+            throw std::runtime_error("2PGFPart: Parts cannot be computed together.");
+    }
+
+    TwoParticleGFPart const& Part0 = *PartsToCompute.front();
+    if(Part0.O1.isComplex() || Part0.O2.isComplex() || Part0.O3.isComplex() || Part0.CX4.isComplex())
+        computeFusedImpl<true>(PartsToCompute);
     else
-        computeImpl<false>();
+        computeFusedImpl<false>(PartsToCompute);
 }
 
-template <bool Complex> void TwoParticleGFPart::computeImpl() {
-    NonResonantTerms.clear();
-    ResonantTerms.clear();
+template <bool Complex> void TwoParticleGFPart::computeFusedImpl(std::vector<TwoParticleGFPart*> const& Parts) {
+    std::size_t NumParts = Parts.size();
+    TwoParticleGFPart const& Part0 = *Parts.front();
 
-    RealType beta = DMpart1.beta;
+    RealType CoefficientTolerance = Part0.CoefficientTolerance;
+    for(TwoParticleGFPart* Part : Parts) {
+        Part->NonResonantTerms.clear();
+        Part->ResonantTerms.clear();
+        Part->Frozen = FrozenTerms();
+        Part->IsFrozen = false;
+        CoefficientTolerance = std::min(CoefficientTolerance, Part->CoefficientTolerance);
+    }
+
+    RealType beta = Part0.DMpart1.beta;
     // I don't have any pen now, so I'm writing here:
     // <1 | O1 | 2> <2 | O2 | 3> <3 | O3 |4> <4| CX4 |1>
-    // Iterate over all values of |1><1| and |3><3|
-    // Chase indices |2> and <2|, |4> and <4|.
-    RowMajorMatrixType<Complex> const& O1matrix = O1.getRowMajorValue<Complex>();
-    ColMajorMatrixType<Complex> const& O2matrix = O2.getColMajorValue<Complex>();
-    RowMajorMatrixType<Complex> const& O3matrix = O3.getRowMajorValue<Complex>();
-    ColMajorMatrixType<Complex> const& CX4matrix = CX4.getColMajorValue<Complex>();
-
-    InnerQuantumState index1Max =
-        CX4matrix.outerSize(); // One can not make a cutoff in external index for evaluating 2PGF
-    InnerQuantumState index3Max = O2matrix.outerSize();
-
-    std::vector<InnerQuantumState> Index4List;
-    Index4List.reserve(index1Max * index3Max);
-
-    for(InnerQuantumState index1 = 0; index1 < index1Max; ++index1)
-        for(InnerQuantumState index3 = 0; index3 < index3Max; ++index3) {
-            typename ColMajorMatrixType<Complex>::InnerIterator index4bra_iter(CX4matrix, index1);
-            typename RowMajorMatrixType<Complex>::InnerIterator index4ket_iter(O3matrix, index3);
-            Index4List.clear();
-            while(index4bra_iter && index4ket_iter) {
-                if(chaseIndices<Complex>(index4ket_iter, index4bra_iter)) {
-                    Index4List.push_back(index4bra_iter.index());
-                    ++index4bra_iter;
-                    ++index4ket_iter;
-                }
-            };
-
-            if(!Index4List.empty()) {
-                RealType E1 = Hpart1.getEigenValue(index1);
-                RealType E3 = Hpart3.getEigenValue(index3);
-                RealType weight1 = DMpart1.getWeight(index1);
-                RealType weight3 = DMpart3.getWeight(index3);
-
-                typename ColMajorMatrixType<Complex>::InnerIterator index2bra_iter(O2matrix, index3);
-                typename RowMajorMatrixType<Complex>::InnerIterator index2ket_iter(O1matrix, index1);
-                while(index2bra_iter && index2ket_iter) {
-                    if(chaseIndices<Complex>(index2ket_iter, index2bra_iter)) {
-
-                        InnerQuantumState index2 = index2ket_iter.index();
-                        RealType E2 = Hpart2.getEigenValue(index2);
-                        RealType weight2 = DMpart2.getWeight(index2);
-
-                        for(unsigned long index4 : Index4List) {
-                            RealType E4 = Hpart4.getEigenValue(index4);
-                            RealType weight4 = DMpart4.getWeight(index4);
-                            if(weight1 + weight2 + weight3 + weight4 > CoefficientTolerance) {
-                                ComplexType MatrixElement = index2ket_iter.value() * index2bra_iter.value() *
-                                                            O3matrix.coeff(index3, index4) *
-                                                            CX4matrix.coeff(index4, index1);
-
-                                MatrixElement *= Permutation.sign;
-
-                                addMultiterm(MatrixElement, beta, E1, E2, E3, E4, weight1, weight2, weight3, weight4);
+    // Iterate over all values of |1><1| and |3><3| connected by at least one state |4>.
+    // Chase indices |2> and <2|.
+    // All parts share the blocks 1, 2, 3, 4, so the operators are traversed once for all parts.
+    std::vector<MonomialOperatorPart const*> O1parts, O2parts, O3parts, CX4parts;
+    for(TwoParticleGFPart const* Part : Parts) {
+        O1parts.push_back(&Part->O1);
+        O2parts.push_back(&Part->O2);
+        O3parts.push_back(&Part->O3);
+        CX4parts.push_back(&Part->CX4);
+    }
+    auto RowMajorView = [](MonomialOperatorPart const& Op) { return Op.getRowMajorView<Complex>(); };
+    auto ColMajorView = [](MonomialOperatorPart const& Op) { return Op.getColMajorView<Complex>(); };
+    FusedSparseMatrix<Complex> const O1matrix(O1parts, RowMajorView);
+    FusedSparseMatrix<Complex> const O2matrix(O2parts, ColMajorView);
+
+    FusedSparseMatrix<Complex> const O3matrix(O3parts, ColMajorView);
+    FusedSparseMatrix<Complex> const CX4matrix(CX4parts, ColMajorView);
+    std::size_t const Size3 = static_cast<std::size_t>(Part0.O3.getNumberOfRows());
+    // One can not make a cutoff in external index for evaluating 2PGF
+    long const Size1 = static_cast<long>(CX4matrix.OuterStarts.size()) - 1;
+
+    // Energies and weights of all states
+    RealVectorType const& E1 = Part0.Hpart1.getEigenValues();
+    RealVectorType const& E2 = Part0.Hpart2.getEigenValues();
+    RealVectorType const& E3 = Part0.Hpart3.getEigenValues();
+    RealVectorType const& E4 = Part0.Hpart4.getEigenValues();
+    std::vector<RealType> const Weights1 = getWeights(Part0.DMpart1, E1.size());
+    std::vector<RealType> const Weights2 = getWeights(Part0.DMpart2, E2.size());
+    std::vector<RealType> const Weights3 = getWeights(Part0.DMpart3, E3.size());
+    std::vector<RealType> const Weights4 = getWeights(Part0.DMpart4, E4.size());
+    // Upper bounds of the weights used to skip states, whose combined weight is negligible
+    std::vector<RealType> const MaxWeights2 = getMaxWeights(Part0.DMpart2, E2.size());
+    std::vector<RealType> const MaxWeights4 = getMaxWeights(Part0.DMpart4, E4.size());
+    RealType const MaxWeight2 = Part0.DMpart2.getMaxWeight();
+
+#ifdef POMEROL_USE_OPENMP
+    int NumThreads = omp_get_max_threads();
+#else
+    int NumThreads = 1;
+#endif
+
+    // Thread-local term lists, the master thread adds its terms directly to NonResonantTerms/ResonantTerms
+    std::vector<TermList<NonResonantTerm>> ThreadNonResonantTerms;
+    std::vector<TermList<ResonantTerm>> ThreadResonantTerms;
+    ThreadNonResonantTerms.reserve((NumThreads - 1) * NumParts);
+    ThreadResonantTerms.reserve((NumThreads - 1) * NumParts);
+    for(int Thread = 1; Thread < NumThreads; ++Thread) {
+        for(TwoParticleGFPart const* Part : Parts) {
+            ThreadNonResonantTerms.emplace_back(NonResonantTerm::Hash(Part->PoleResolution),
+                                                NonResonantTerm::KeyEqual(Part->PoleResolution),
+                                                NonResonantTerm::IsNegligible(Part->CoefficientTolerance));
+            ThreadResonantTerms.emplace_back(ResonantTerm::Hash(Part->PoleResolution),
+                                             ResonantTerm::KeyEqual(Part->PoleResolution),
+                                             ResonantTerm::IsNegligible(Part->CoefficientTolerance));
+        }
+    }
+
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel num_threads(NumThreads)
+#endif
+    {
+#ifdef POMEROL_USE_OPENMP
+        int Thread = omp_get_thread_num();
+#else
+        int Thread = 0;
+#endif
+        auto NRTerms = [&](std::size_t p) -> TermList<NonResonantTerm>& {
+            return Thread == 0 ? Parts[p]->NonResonantTerms : ThreadNonResonantTerms[(Thread - 1) * NumParts + p];
+        };
+        auto RTerms = [&](std::size_t p) -> TermList<ResonantTerm>& {
+            return Thread == 0 ? Parts[p]->ResonantTerms : ThreadResonantTerms[(Thread - 1) * NumParts + p];
+        };
+        std::vector<MelemType<Complex>> Elements12(NumParts);
+        Index4Lists<Complex> Index4(O3matrix, CX4matrix, Size3);
+
+        // Iterate over all states index1 and all states index3 connected to them
+#ifdef POMEROL_USE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+        for(long index1_ = 0; index1_ < Size1; ++index1_) {
+            InnerQuantumState index1 = static_cast<InnerQuantumState>(index1_);
+            RealType E1_ = E1(index1);
+            RealType weight1 = Weights1[index1];
+
+            Index4.build(index1);
+            for(std::size_t pair13 = 0; pair13 < Index4.size(); ++pair13) {
+                InnerQuantumState index3 = Index4.Index3[pair13];
+                std::size_t Index4Begin = Index4.Offsets[pair13];
+                std::size_t Index4End = Index4.Offsets[pair13 + 1];
+
+                RealType E3_ = E3(index3);
+                RealType weight3 = Weights3[index3];
+
+                // States index4 are sorted, so MaxWeight4 bounds weights of all of them
+                RealType MaxWeight4 = MaxWeights4[Index4.Index4[Index4Begin]];
+                if(weight1 + MaxWeight2 + weight3 + MaxWeight4 <= CoefficientTolerance)
+                    continue;
+
+                // Chase the common states index2 of the row index1 of O1 and the column index3 of O2
+                std::size_t n2ket = O1matrix.OuterStarts[index1], n2ketEnd = O1matrix.OuterStarts[index1 + 1];
+                std::size_t n2bra = O2matrix.OuterStarts[index3], n2braEnd = O2matrix.OuterStarts[index3 + 1];
+                while(n2ket < n2ketEnd && n2bra < n2braEnd) {
+                    InnerQuantumState index2 = O1matrix.InnerIndices[n2ket];
+                    if(index2 < O2matrix.InnerIndices[n2bra]) {
+                        ++n2ket;
+                        continue;
+                    } else if(O2matrix.InnerIndices[n2bra] < index2) {
+                        ++n2bra;
+                        continue;
+                    }
+
+                    // Weights of the remaining states index2 are negligible as well
+                    if(weight1 + MaxWeights2[index2] + weight3 + MaxWeight4 <= CoefficientTolerance)
+                        break;
+
+                    RealType E2_ = E2(index2);
+                    RealType weight2 = Weights2[index2];
+                    auto const* Values1 = O1matrix.values(n2ket);
+                    auto const* Values2 = O2matrix.values(n2bra);
+                    for(std::size_t p = 0; p < NumParts; ++p)
+                        Elements12[p] = Values1[p] * Values2[p];
+
+                    for(std::size_t n4 = Index4Begin; n4 < Index4End; ++n4) {
+                        InnerQuantumState index4 = Index4.Index4[n4];
+                        if(weight1 + weight2 + weight3 + MaxWeights4[index4] <= CoefficientTolerance)
+                            break;
+                        RealType weight4 = Weights4[index4];
+                        if(weight1 + weight2 + weight3 + weight4 > CoefficientTolerance) {
+                            auto const* Values34 = Index4.values(n4);
+                            for(std::size_t p = 0; p < NumParts; ++p) {
+                                MelemType<Complex> Element = Elements12[p] * Values34[p];
+                                if(Element == MelemType<Complex>(0))
+                                    continue;
+
+                                ComplexType MatrixElement = Element;
+                                MatrixElement *= Parts[p]->Permutation.sign;
+
+                                Parts[p]->addMultiterm(NRTerms(p),
+                                                       RTerms(p),
+                                                       MatrixElement,
+                                                       beta,
+                                                       E1_,
+                                                       E2_,
+                                                       E3_,
+                                                       E4(index4),
+                                                       weight1,
+                                                       weight2,
+                                                       weight3,
+                                                       weight4);
                             }
                         }
-                        ++index2bra_iter;
-                        ++index2ket_iter;
                     }
+                    ++n2ket;
+                    ++n2bra;
                 }
             }
         }
+    }
+
+    for(std::size_t p = 0; p < NumParts; ++p) {
+        TwoParticleGFPart& Part = *Parts[p];
+
+        // Reduce thread-local term lists
+        for(int Thread = 1; Thread < NumThreads; ++Thread) {
+            Part.NonResonantTerms.merge(ThreadNonResonantTerms[(Thread - 1) * NumParts + p]);
+            Part.ResonantTerms.merge(ThreadResonantTerms[(Thread - 1) * NumParts + p]);
+        }
 
-    INFO("Total " << NonResonantTerms.size() << "+" << ResonantTerms.size() << "="
-                  << NonResonantTerms.size() + ResonantTerms.size() << " terms");
+        INFO("Total " << Part.NonResonantTerms.size() << "+" << Part.ResonantTerms.size() << "="
+                      << Part.NonResonantTerms.size() + Part.ResonantTerms.size() << " terms");
 
-    assert(NonResonantTerms.check_terms());
-    assert(ResonantTerms.check_terms());
+        assert(Part.NonResonantTerms.check_terms());
+        assert(Part.ResonantTerms.check_terms());
 
-    setStatus(Computed);
+        Part.setStatus(Computed);
+    }
 }
 
-inline void TwoParticleGFPart::addMultiterm(ComplexType Coeff,
+inline void TwoParticleGFPart::addMultiterm(TermList<NonResonantTerm>& NRTerms,
+                                            TermList<ResonantTerm>& RTerms,
+                                            ComplexType Coeff,
                                             RealType beta,
                                             RealType Ei,
                                             RealType Ej,
@@ -273,7 +909,7 @@ inline void TwoParticleGFPart::addMultiterm(ComplexType Coeff,
                                             RealType Wi,
                                             RealType Wj,
                                             RealType Wk,
-                                            RealType Wl) {
+                                            RealType Wl) const {
     RealType P1 = Ej - Ei;
     RealType P2 = Ek - Ej;
     RealType P3 = El - Ek;
@@ -281,20 +917,20 @@ inline void TwoParticleGFPart::addMultiterm(ComplexType Coeff,
     // Non-resonant part of the multiterm
     ComplexType CoeffZ2 = -Coeff * (Wj + Wk);
     if(std::abs(CoeffZ2) > CoefficientTolerance)
-        NonResonantTerms.add_term(NonResonantTerm(CoeffZ2, P1, P2, P3, false));
+        NRTerms.add_term(NonResonantTerm(CoeffZ2, P1, P2, P3, false));
     ComplexType CoeffZ4 = Coeff * (Wi + Wl);
     if(std::abs(CoeffZ4) > CoefficientTolerance)
-        NonResonantTerms.add_term(NonResonantTerm(CoeffZ4, P1, P2, P3, true));
+        NRTerms.add_term(NonResonantTerm(CoeffZ4, P1, P2, P3, true));
 
     // Resonant part of the multiterm
     ComplexType CoeffZ1Z2Res = Coeff * beta * Wi;
     ComplexType CoeffZ1Z2NonRes = Coeff * (Wk - Wi);
     if(std::abs(CoeffZ1Z2Res) > CoefficientTolerance || abs(CoeffZ1Z2NonRes) > CoefficientTolerance)
-        ResonantTerms.add_term(ResonantTerm(CoeffZ1Z2Res, CoeffZ1Z2NonRes, P1, P2, P3, true));
+        RTerms.add_term(ResonantTerm(CoeffZ1Z2Res, CoeffZ1Z2NonRes, P1, P2, P3, true));
     ComplexType CoeffZ2Z3Res = -Coeff * beta * Wj;
     ComplexType CoeffZ2Z3NonRes = Coeff * (Wj - Wl);
     if(std::abs(CoeffZ2Z3Res) > CoefficientTolerance || abs(CoeffZ2Z3NonRes) > CoefficientTolerance)
-        ResonantTerms.add_term(ResonantTerm(CoeffZ2Z3Res, CoeffZ2Z3NonRes, P1, P2, P3, false));
+        RTerms.add_term(ResonantTerm(CoeffZ2Z3Res, CoeffZ2Z3NonRes, P1, P2, P3, false));
 }
 
 ComplexType TwoParticleGFPart::operator()(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const {
@@ -307,23 +943,203 @@ ComplexType TwoParticleGFPart::operator()(long MatsubaraNumber1, long MatsubaraN
 }
 
 ComplexType TwoParticleGFPart::operator()(ComplexType z1, ComplexType z2, ComplexType z3) const {
-    std::array<ComplexType, 3> Frequencies = {z1, z2, -z3};
+    std::array<ComplexType, 3> Frequencies = permuteFrequencies(z1, z2, z3);
 
-    z1 = Frequencies[Permutation.perm[0]];
-    z2 = Frequencies[Permutation.perm[1]];
-    z3 = Frequencies[Permutation.perm[2]];
+    z1 = Frequencies[0];
+    z2 = Frequencies[1];
+    z3 = Frequencies[2];
 
     if(getStatus() != Computed) {
         throw StatusMismatch(
             "2PGFPart: Calling operator() on uncomputed container. Did you purge all the terms when called compute()?");
     }
 
+    // A single triplet would occupy only one lane of a tile, so the term lists are summed directly
     return NonResonantTerms(z1, z2, z3) + ResonantTerms(z1, z2, z3, PoleResolution);
 }
 
+TwoParticleGFPart::FrozenTerms TwoParticleGFPart::makeFrozenTerms() const {
+    FrozenTerms Terms;
+
+    auto pushBack = [](TermArrays& A, ComplexType Coeff, std::array<RealType, 3> const& Poles) {
+        A.CoeffRe.push_back(Coeff.real());
+        A.CoeffIm.push_back(Coeff.imag());
+        A.P1.push_back(Poles[0]);
+        A.P2.push_back(Poles[1]);
+        A.P3.push_back(Poles[2]);
+    };
+
+    for(auto const& t : NonResonantTerms.as_vector())
+        pushBack(t.isz4 ? Terms.NonResonantZ4 : Terms.NonResonantZ2, t.Coeff, t.Poles);
+    for(auto const& t : ResonantTerms.as_vector()) {
+        TermArrays& A = t.isz1z2 ? Terms.ResonantZ1Z2 : Terms.ResonantZ2Z3;
+        pushBack(A, t.ResCoeff, t.Poles);
+        A.NonResCoeffRe.push_back(t.NonResCoeff.real());
+        A.NonResCoeffIm.push_back(t.NonResCoeff.imag());
+    }
+
+    return Terms;
+}
+
+void TwoParticleGFPart::freeze() {
+    if(getStatus() != Computed)
+        throw StatusMismatch("2PGFPart: Cannot freeze an uncomputed part.");
+    Frozen = makeFrozenTerms();
+    IsFrozen = true;
+}
+
+void TwoParticleGFPart::accumulateValues(std::vector<std::tuple<ComplexType, ComplexType, ComplexType>> const& freqs,
+                                         std::vector<ComplexType>& data,
+                                         FrozenTerms const* Terms) const {
+    if(getStatus() != Computed)
+        throw StatusMismatch("2PGFPart: Calling accumulateValues() on uncomputed container.");
+
+    FrozenTerms TemporaryTerms;
+    if(!IsFrozen && !Terms)
+        TemporaryTerms = makeFrozenTerms();
+    FrozenTerms const& Arrays = IsFrozen ? Frozen : (Terms ? *Terms : TemporaryTerms);
+
+    long NumFreqs = static_cast<long>(freqs.size());
+    long NumTiles = (NumFreqs + FreqTileSize - 1) / FreqTileSize;
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for(long Tile = 0; Tile < NumTiles; ++Tile) {
+        long First = Tile * static_cast<long>(FreqTileSize);
+        long Size = std::min(static_cast<long>(FreqTileSize), NumFreqs - First);
+
+        // Unused lanes of the last tile are padded with copies of the first triplet
+        FreqTile F;
+        for(long t = 0; t < static_cast<long>(FreqTileSize); ++t) {
+            auto const& z = freqs[First + (t < Size ? t : 0)];
+            setTileFrequencies(F, t, permuteFrequencies(std::get<0>(z), std::get<1>(z), std::get<2>(z)));
+        }
+        evaluateTile(Arrays, F, PoleResolution);
+        for(long t = 0; t < Size; ++t)
+            data[First + t] += ComplexType(F.ValueRe[t], F.ValueIm[t]);
+    }
+}
+
+void TwoParticleGFPart::accumulateMatsubaraValues(std::vector<MatsubaraTriplet> const& indices,
+                                                  std::vector<ComplexType>& data,
+                                                  FrozenTerms const* Terms) const {
+    accumulateMatsubaraValuesImpl(indices, data, Terms);
+}
+
+void TwoParticleGFPart::accumulateMatsubaraValues(FreqGrid3 const& grid,
+                                                  std::vector<ComplexType>& data,
+                                                  std::size_t First,
+                                                  FrozenTerms const* Terms) const {
+    if(First == 0 && data.size() == grid.size())
+        accumulateMatsubaraValuesImpl(grid, data, Terms);
+    else
+        accumulateMatsubaraValuesImpl(GridRange{grid, First, data.size()}, data, Terms);
+}
+
+template <typename MatsubaraIndices>
+void TwoParticleGFPart::accumulateMatsubaraValuesImpl(MatsubaraIndices const& indices,
+                                                      std::vector<ComplexType>& data,
+                                                      FrozenTerms const* Terms) const {
+    if(getStatus() != Computed)
+        throw StatusMismatch("2PGFPart: Calling accumulateMatsubaraValues() on uncomputed container.");
+    if(indices.size() == 0)
+        return;
+
+    FrozenTerms TemporaryTerms;
+    if(!IsFrozen && !Terms)
+        TemporaryTerms = makeFrozenTerms();
+    FrozenTerms const& Arrays = IsFrozen ? Frozen : (Terms ? *Terms : TemporaryTerms);
+    TermArrays const& Z2 = Arrays.NonResonantZ2;
+    TermArrays const& Z4 = Arrays.NonResonantZ4;
+    TermArrays const& Z1Z2 = Arrays.ResonantZ1Z2;
+    TermArrays const& Z2Z3 = Arrays.ResonantZ2Z3;
+
+    // Matsubara indices of the permuted frequencies z1, z2, z3 (-z3 corresponds to the index -n3-1),
+    // fermionic indices of z1+z2+z3 and bosonic indices of z1+z2, z2+z3
+    std::size_t NumFreqs = indices.size();
+    std::vector<long> m1(NumFreqs), m2(NumFreqs), m3(NumFreqs), m123(NumFreqs), k12(NumFreqs), k23(NumFreqs);
+    for(std::size_t w = 0; w < NumFreqs; ++w) {
+        MatsubaraTriplet const nw = indices[w];
+        MatsubaraTriplet n = {nw[0], nw[1], -nw[2] - 1};
+        m1[w] = n[Permutation.perm[0]];
+        m2[w] = n[Permutation.perm[1]];
+        m3[w] = n[Permutation.perm[2]];
+        m123[w] = m1[w] + m2[w] + m3[w] + 1;
+        k12[w] = m1[w] + m2[w] + 1;
+        k23[w] = m2[w] + m3[w] + 1;
+    }
+    auto minIndex = [](std::vector<long> const& k) { return *std::min_element(k.begin(), k.end()); };
+    auto maxIndex = [](std::vector<long> const& k) { return *std::max_element(k.begin(), k.end()); };
+
+    // Pole tables
+    std::vector<RealType> Poles1, Poles3, Poles123, Poles12, Poles23;
+    for(TermArrays const* A : {&Z2, &Z4, &Z1Z2, &Z2Z3}) {
+        Poles1.insert(Poles1.end(), A->P1.begin(), A->P1.end());
+        Poles3.insert(Poles3.end(), A->P3.begin(), A->P3.end());
+    }
+    for(std::size_t t = 0; t < Z4.size(); ++t)
+        Poles123.push_back(Z4.P1[t] + Z4.P2[t] + Z4.P3[t]);
+    for(std::size_t t = 0; t < Z1Z2.size(); ++t)
+        Poles12.push_back(Z1Z2.P1[t] + Z1Z2.P2[t]);
+    for(std::size_t t = 0; t < Z2Z3.size(); ++t)
+        Poles23.push_back(Z2Z3.P2[t] + Z2Z3.P3[t]);
+
+    PoleTable T1(Poles1, minIndex(m1), maxIndex(m1), beta, false, PoleResolution);
+    PoleTable T2(Z2.P2, minIndex(m2), maxIndex(m2), beta, false, PoleResolution);
+    PoleTable T3(Poles3, minIndex(m3), maxIndex(m3), beta, false, PoleResolution);
+    PoleTable T123(Poles123, minIndex(m123), maxIndex(m123), beta, false, PoleResolution);
+    PoleTable T12(Poles12, minIndex(k12), maxIndex(k12), beta, true, PoleResolution);
+    PoleTable T23(Poles23, minIndex(k23), maxIndex(k23), beta, true, PoleResolution);
+    PoleTable R12(Poles12, minIndex(k12), maxIndex(k12), beta, true, PoleResolution, PoleTable::Resonances);
+    PoleTable R23(Poles23, minIndex(k23), maxIndex(k23), beta, true, PoleResolution, PoleTable::Resonances);
+
+    // Groups of terms in the factorized form
+    FactorizedTerms G2{{}, {{&T1, &T2, &T3}}, {}, {{&m1, &m2, &m3}}};
+    for(std::size_t t = 0; t < Z2.size(); ++t)
+        G2.add({Z2.CoeffRe[t], Z2.CoeffIm[t]}, T1.column(Z2.P1[t]), T2.column(Z2.P2[t]), T3.column(Z2.P3[t]));
+
+    FactorizedTerms G4{{}, {{&T1, &T123, &T3}}, {}, {{&m1, &m123, &m3}}};
+    for(std::size_t t = 0; t < Z4.size(); ++t)
+        G4.add({Z4.CoeffRe[t], Z4.CoeffIm[t]}, T1.column(Z4.P1[t]), T123.column(Poles123[t]), T3.column(Z4.P3[t]));
+
+    // Non-resonant (N / Diff) and resonant (R) contributions of the resonant terms
+    FactorizedTerms G12N{{}, {{&T1, &T12, &T3}}, {}, {{&m1, &k12, &m3}}};
+    FactorizedTerms G12R{{}, {{&T1, &R12, &T3}}, {}, {{&m1, &k12, &m3}}};
+    for(std::size_t t = 0; t < Z1Z2.size(); ++t) {
+        std::size_t c1 = T1.column(Z1Z2.P1[t]), c12 = T12.column(Poles12[t]), c3 = T3.column(Z1Z2.P3[t]);
+        G12N.add({Z1Z2.NonResCoeffRe[t], Z1Z2.NonResCoeffIm[t]}, c1, c12, c3);
+        if(!R12.isZeroColumn(c12))
+            G12R.add({Z1Z2.CoeffRe[t], Z1Z2.CoeffIm[t]}, c1, c12, c3);
+    }
+    FactorizedTerms G23N{{}, {{&T1, &T23, &T3}}, {}, {{&m1, &k23, &m3}}};
+    FactorizedTerms G23R{{}, {{&T1, &R23, &T3}}, {}, {{&m1, &k23, &m3}}};
+    for(std::size_t t = 0; t < Z2Z3.size(); ++t) {
+        std::size_t c1 = T1.column(Z2Z3.P1[t]), c23 = T23.column(Poles23[t]), c3 = T3.column(Z2Z3.P3[t]);
+        G23N.add({Z2Z3.NonResCoeffRe[t], Z2Z3.NonResCoeffIm[t]}, c1, c23, c3);
+        if(!R23.isZeroColumn(c23))
+            G23R.add({Z2Z3.CoeffRe[t], Z2Z3.CoeffIm[t]}, c1, c23, c3);
+    }
+
+    for(FactorizedTerms const* G : {&G2, &G4, &G12N, &G12R, &G23N, &G23R})
+        addFactorizedTerms(*G, data);
+}
+
+std::size_t TwoParticleGFPart::getMemoryUsage() const {
+    std::size_t Usage = NonResonantTerms.getMemoryUsage() + ResonantTerms.getMemoryUsage();
+    for(TermArrays const* A :
+        {&Frozen.NonResonantZ2, &Frozen.NonResonantZ4, &Frozen.ResonantZ1Z2, &Frozen.ResonantZ2Z3}) {
+        for(std::vector<RealType> const* V :
+            {&A->CoeffRe, &A->CoeffIm, &A->NonResCoeffRe, &A->NonResCoeffIm, &A->P1, &A->P2, &A->P3})
+            Usage += V->capacity() * sizeof(RealType);
+    }
+    return Usage;
+}
+
 void TwoParticleGFPart::clear() {
     NonResonantTerms.clear();
     ResonantTerms.clear();
+    Frozen = FrozenTerms();
+    IsFrozen = false;
     setStatus(Constructed);
 }
 
@@ -15,6 +15,10 @@
 
 #include "pomerol/Vertex4.hpp"
 
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
 namespace Pomerol {
 
 Vertex4::Vertex4(TwoParticleGF const& Chi,
@@ -25,14 +29,76 @@ Vertex4::Vertex4(TwoParticleGF const& Chi,
     : Thermal(Chi.beta), ComputableObject(), Chi(Chi), G13(G13), G24(G24), G14(G14), G23(G23), Storage(*this) {}
 
 void Vertex4::compute(long NumberOfMatsubaras) {
+    fillStorage(NumberOfMatsubaras, nullptr, nullptr, nullptr);
+}
+
+void Vertex4::compute(long NumberOfMatsubaras, MPI_Comm const& comm) {
+    fillStorage(NumberOfMatsubaras, nullptr, nullptr, &comm);
+}
+
+void Vertex4::compute(long NumberOfMatsubaras,
+                      FreqGrid3 const& Grid,
+                      std::vector<ComplexType> const& ChiValues,
+                      MPI_Comm const& comm) {
+    if(ChiValues.size() != Grid.size())
+        throw std::invalid_argument("Vertex4: Size of ChiValues does not match the size of the grid");
+    fillStorage(NumberOfMatsubaras, &Grid, &ChiValues, &comm);
+}
+
+void Vertex4::fillStorage(long NumberOfMatsubaras,
+                          FreqGrid3 const* Grid,
+                          std::vector<ComplexType> const* ChiValues,
+                          MPI_Comm const* comm) {
     if(getStatus() >= Computed)
         return;
-    Storage.fill(NumberOfMatsubaras);
+    if(!comm && Chi.areTermsDistributed())
+        throw StatusMismatch("Vertex4: Terms of the 2PGF are distributed, pass an MPI communicator to compute()");
+
+    Storage.fill(NumberOfMatsubaras, [&](std::vector<MatsubaraTriplet> const& Indices) {
+        long Size = static_cast<long>(Indices.size());
+        std::vector<ComplexType> Values(Indices.size());
+
+        // Values of chi found on the grid
+        std::vector<char> Found(Indices.size(), false);
+        if(Grid) {
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+            for(long k = 0; k < Size; ++k) {
+                std::size_t Position = 0;
+                if(Grid->find(Indices[k], Position)) {
+                    Values[k] = (*ChiValues)[Position];
+                    Found[k] = true;
+                }
+            }
+        }
+
+        // Values of chi that are not found on the grid
+        std::vector<std::size_t> Missing;
+        std::vector<MatsubaraTriplet> MissingIndices;
+        for(std::size_t k = 0; k < Indices.size(); ++k) {
+            if(!Found[k]) {
+                Missing.push_back(k);
+                MissingIndices.push_back(Indices[k]);
+            }
+        }
+        std::vector<ComplexType> MissingValues = chiValues(MissingIndices, comm);
+        for(std::size_t m = 0; m < Missing.size(); ++m)
+            Values[Missing[m]] = MissingValues[m];
+
+#ifdef POMEROL_USE_OPENMP
+#pragma omp parallel for
+#endif
+        for(long k = 0; k < Size; ++k)
+            Values[k] += disconnectedValue(Indices[k][0], Indices[k][1], Indices[k][2]);
+        return Values;
+    });
+
     setStatus(Computed);
 }
 
-ComplexType Vertex4::value(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const {
-    ComplexType Value = Chi(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3);
+ComplexType Vertex4::disconnectedValue(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const {
+    ComplexType Value = 0;
 
     if(MatsubaraNumber1 == MatsubaraNumber3)
         Value += beta * G13(MatsubaraNumber1) * G24(MatsubaraNumber2);
@@ -42,6 +108,34 @@ ComplexType Vertex4::value(long MatsubaraNumber1, long MatsubaraNumber2, long Ma
     return Value;
 }
 
+ComplexType Vertex4::value(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const {
+    return Chi(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3) +
+           disconnectedValue(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3);
+}
+
+std::vector<ComplexType> Vertex4::chiValues(std::vector<MatsubaraTriplet> const& Indices,
+                                            MPI_Comm const* comm) const {
+    if(!comm)
+        return Chi.evaluate(Indices, MPI_COMM_SELF);
+    if(Chi.areTermsDistributed())
+        return Chi.evaluate(Indices, *comm);
+
+    // Each process evaluates its own slice of the list
+    DistributedVector Slices(*comm);
+    Slices.resize(Indices.size());
+    auto First = Indices.begin() + static_cast<std::ptrdiff_t>(Slices.getOffset());
+    std::vector<MatsubaraTriplet> LocalIndices(First, First + static_cast<std::ptrdiff_t>(Slices.getLocalSize()));
+    Slices.getLocalData() = Chi.evaluate(LocalIndices, *comm);
+    return Slices.allgather();
+}
+
+std::vector<ComplexType> Vertex4::values(std::vector<MatsubaraTriplet> const& Indices, MPI_Comm const& comm) const {
+    std::vector<ComplexType> Values = chiValues(Indices, &comm);
+    for(std::size_t k = 0; k < Indices.size(); ++k)
+        Values[k] += disconnectedValue(Indices[k][0], Indices[k][1], Indices[k][2]);
+    return Values;
+}
+
 ComplexType Vertex4::operator()(long MatsubaraNumber1, long MatsubaraNumber2, long MatsubaraNumber3) const {
     return Storage(MatsubaraNumber1, MatsubaraNumber2, MatsubaraNumber3);
 }
@@ -26,7 +26,9 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <numeric>
+#include <tuple>
 #include <vector>
 
 using namespace Pomerol;
@@ -212,6 +214,118 @@ TEST_CASE("3-point susceptibilities of a single Hubbard atom", "[ThreePointSusce
         }
     }
 
+    SECTION("Particle-hole channel on a frequency grid") {
+        FreqGrid2 grid({-n_iw, n_iw}, {-n_iw, n_iw});
+        for(auto index1 : {up_index, dn_index}) {
+            for(auto index2 : {up_index, dn_index}) {
+                ThreePointSusceptibility chi3ph(Channel::PH,
+                                                S,
+                                                H,
+                                                Operators.getCreationOperator(index1),
+                                                Operators.getAnnihilationOperator(index1),
+                                                Operators.getCreationOperator(index2),
+                                                Operators.getAnnihilationOperator(index2),
+                                                rho);
+                chi3ph.prepare();
+                auto data = chi3ph.compute(false, grid);
+                REQUIRE(data.size() == grid.size());
+
+                for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+                    for(int n2 = -n_iw; n2 < n_iw; ++n2) {
+                        REQUIRE_THAT(data[grid.index(n1 + n_iw, n2 + n_iw)], IsCloseTo(chi3ph(n1, n2), 1e-14));
+                    }
+                }
+            }
+        }
+    }
+
+    SECTION("Particle-hole channel with distributed terms") {
+        FreqVec2 freqs;
+        for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+            for(int n2 = -n_iw; n2 < n_iw; ++n2)
+                freqs.emplace_back(I * omega(n1), I * omega(n2));
+        }
+        for(auto index1 : {up_index, dn_index}) {
+            for(auto index2 : {up_index, dn_index}) {
+                ThreePointSusceptibility chi3ph(Channel::PH,
+                                                S,
+                                                H,
+                                                Operators.getCreationOperator(index1),
+                                                Operators.getAnnihilationOperator(index1),
+                                                Operators.getCreationOperator(index2),
+                                                Operators.getAnnihilationOperator(index2),
+                                                rho);
+                chi3ph.prepare();
+                chi3ph.compute();
+
+                ThreePointSusceptibility chi3ph_dist(Channel::PH,
+                                                     S,
+                                                     H,
+                                                     Operators.getCreationOperator(index1),
+                                                     Operators.getAnnihilationOperator(index1),
+                                                     Operators.getCreationOperator(index2),
+                                                     Operators.getAnnihilationOperator(index2),
+                                                     rho);
+                chi3ph_dist.DistributedTerms = true;
+                chi3ph_dist.prepare();
+                chi3ph_dist.compute();
+                REQUIRE(chi3ph_dist.areTermsDistributed());
+
+                auto values = chi3ph_dist.evaluate(freqs, MPI_COMM_WORLD);
+                REQUIRE(values.size() == freqs.size());
+                for(std::size_t w = 0; w < freqs.size(); ++w) {
+                    auto const& z = freqs[w];
+                    REQUIRE_THAT(values[w], IsCloseTo(chi3ph(std::get<0>(z), std::get<1>(z)), 1e-14));
+                }
+
+                // Terms purged by compute() cannot be evaluated
+                ThreePointSusceptibility chi3ph_clear(Channel::PH,
+                                                      S,
+                                                      H,
+                                                      Operators.getCreationOperator(index1),
+                                                      Operators.getAnnihilationOperator(index1),
+                                                      Operators.getCreationOperator(index2),
+                                                      Operators.getAnnihilationOperator(index2),
+                                                      rho);
+                chi3ph_clear.prepare();
+                chi3ph_clear.compute(true);
+                REQUIRE_FALSE(chi3ph_clear.areTermsDistributed());
+                REQUIRE_THROWS_AS(chi3ph_clear.evaluate(freqs, MPI_COMM_WORLD),
+                                  ComputableObject::StatusMismatch);
+            }
+        }
+    }
+
+    SECTION("Frequency symmetries") {
+        for(auto channel : {Channel::PP, Channel::PH, Channel::xPH}) {
+            for(auto index1 : {up_index, dn_index}) {
+                for(auto index2 : {up_index, dn_index}) {
+                    ThreePointSusceptibility chi3(channel,
+                                                  S,
+                                                  H,
+                                                  Operators.getCreationOperator(index1),
+                                                  Operators.getAnnihilationOperator(index2),
+                                                  Operators.getCreationOperator(index2),
+                                                  Operators.getAnnihilationOperator(index1),
+                                                  rho);
+                    chi3.UseFrequencySymmetries = true;
+                    chi3.prepare();
+                    FreqGrid2 grid({-n_iw, n_iw}, {-n_iw, n_iw});
+                    auto data = chi3.compute(false, grid);
+                    if(chi3.isVanishing())
+                        continue;
+
+                    REQUIRE(data.size() == grid.size());
+                    for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+                        for(int n2 = -n_iw; n2 < n_iw; ++n2) {
+                            REQUIRE_THAT(data[grid.index(n1 + n_iw, n2 + n_iw)], IsCloseTo(chi3(n1, n2), 1e-14));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     SECTION("Crossing symmetry") {
         for(auto index1 : {up_index, dn_index}) {
             for(auto index2 : {up_index, dn_index}) {
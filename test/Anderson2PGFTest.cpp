@@ -15,6 +15,7 @@
 
 #include <pomerol/DensityMatrix.hpp>
 #include <pomerol/FieldOperatorContainer.hpp>
+#include <pomerol/GreensFunction.hpp>
 #include <pomerol/Hamiltonian.hpp>
 #include <pomerol/HilbertSpace.hpp>
 #include <pomerol/IndexClassification.hpp>
@@ -25,7 +26,9 @@
 
 #include "catch2/catch-pomerol.hpp"
 
+#include <cstddef>
 #include <set>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -150,4 +153,345 @@ TEST_CASE("Two-particle GF of the Anderson model", "[Anderson2PGF]") {
         }
         // cppcheck-suppress-end unreadVariable
     }
+
+    SECTION("Chi4.computeAll() with precomputation on a frequency grid") {
+        // cppcheck-suppress-begin unreadVariable
+        // (omega + Omega, w_p, omega) in the particle-hole channel
+        long n_ref = static_cast<long>(chi_ref.size());
+        FreqGrid3 grid(PH, {1, 2}, {0, 1}, {0, n_ref});
+        REQUIRE(grid.size() == chi_ref.size());
+
+        auto computed_data = Chi4.computeAll(false, grid, MPI_COMM_WORLD, true);
+        auto chi_uuuu = computed_data[IndexCombination4(u0, u0, u0, u0)];
+        auto chi_dddd = computed_data[IndexCombination4(d0, d0, d0, d0)];
+
+        for(int i = 0; i < chi_ref.size(); ++i) {
+            INFO("i = " << i);
+            auto ref = chi_ref[i];
+            REQUIRE_THAT(chi_uuuu[grid.index(0, 0, i)], IsCloseTo(ref, 1e-6));
+            REQUIRE_THAT(chi_dddd[grid.index(0, 0, i)], IsCloseTo(ref, 1e-6));
+        }
+
+        // Frequency conventions of all channels
+        TwoParticleGF const& chi_udud = Chi4(IndexCombination4(u0, d0, u0, d0));
+        for(Channel channel : {PH, PP, xPH}) {
+            TwoParticleGF chi(S,
+                              H,
+                              Operators.getAnnihilationOperator(u0),
+                              Operators.getAnnihilationOperator(d0),
+                              Operators.getCreationOperator(u0),
+                              Operators.getCreationOperator(d0),
+                              rho);
+            chi.PoleResolution = reduce_tol;
+            chi.CoefficientTolerance = coeff_tol;
+            chi.prepare();
+            FreqGrid3 box(channel, {-2, 3}, {-3, 3}, {-2, 2});
+            auto data = chi.compute(true, box, MPI_COMM_WORLD);
+            REQUIRE(data.size() == box.size());
+            for(long m = -2; m < 3; ++m) {
+                for(long n = -3; n < 3; ++n) {
+                    for(long np = -2; np < 2; ++np) {
+                        ComplexType val = data[box.index(m + 2, n + 3, np + 2)];
+                        ComplexType ref;
+                        switch(channel) {
+                        case PH: ref = chi_udud(n + m, np, n); break;
+                        case PP: ref = chi_udud(n, m - n - 1, np); break;
+                        case xPH: ref = chi_udud(n + m, np, np + m); break;
+                        }
+                        REQUIRE_THAT(val, IsCloseTo(ref, 1e-10));
+                    }
+                }
+            }
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Chi4.computeAll() with fused components") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGFContainer Chi4Fused(IndexInfo, S, H, rho, Operators);
+        Chi4Fused.PoleResolution = reduce_tol;
+        Chi4Fused.CoefficientTolerance = coeff_tol;
+        Chi4Fused.FuseComponents = true;
+        Chi4Fused.prepareAll(indices4);
+
+        FreqGrid3 grid(PH, {-2, 3}, {-3, 3}, {-2, 2});
+        auto computed_data = Chi4.computeAll(false, grid, MPI_COMM_WORLD, true);
+        auto fused_data = Chi4Fused.computeAll(false, grid, MPI_COMM_WORLD);
+
+        for(auto const& indices : indices4) {
+            INFO("indices = " << indices);
+            auto const& data = computed_data[indices];
+            auto const& data_fused = fused_data[indices];
+            REQUIRE(data_fused.size() == grid.size());
+            for(std::size_t k = 0; k < grid.size(); ++k)
+                REQUIRE_THAT(data_fused[k], IsCloseTo(data[k], 1e-10));
+        }
+
+        TwoParticleGF const& chi_uuuu = Chi4Fused(IndexCombination4(u0, u0, u0, u0));
+        for(int i = 0; i < chi_ref.size(); ++i) {
+            ComplexType w_p = I * (2. * i + 1.) * M_PI / beta;
+            INFO("i = " << i << ", w_p = " << w_p);
+            REQUIRE_THAT(chi_uuuu(omega + Omega, w_p, omega), IsCloseTo(chi_ref[i], 1e-6));
+        }
+
+        // Green's functions at different temperatures share the Hamiltonian blocks, but must not be fused
+        DensityMatrix rho2(S, H, beta / 2);
+        rho2.prepare();
+        rho2.compute();
+        auto makeChi = [&](DensityMatrix const& DM) {
+            TwoParticleGF chi(S,
+                              H,
+                              Operators.getAnnihilationOperator(u0),
+                              Operators.getAnnihilationOperator(u0),
+                              Operators.getCreationOperator(u0),
+                              Operators.getCreationOperator(u0),
+                              DM);
+            chi.PoleResolution = reduce_tol;
+            chi.CoefficientTolerance = coeff_tol;
+            chi.prepare();
+            return chi;
+        };
+        TwoParticleGF chi1 = makeChi(rho), chi2 = makeChi(rho2), chi2_ref = makeChi(rho2);
+        auto temperatures_data = TwoParticleGF::computeFused({&chi1, &chi2}, false, grid, MPI_COMM_WORLD);
+        auto ref_data = chi2_ref.compute(false, grid, MPI_COMM_WORLD);
+        auto const& data_uuuu = computed_data[IndexCombination4(u0, u0, u0, u0)];
+        for(std::size_t k = 0; k < grid.size(); ++k) {
+            REQUIRE_THAT(temperatures_data[0][k], IsCloseTo(data_uuuu[k], 1e-10));
+            REQUIRE_THAT(temperatures_data[1][k], IsCloseTo(ref_data[k], 1e-10));
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Chi4.computeAll() with frequency symmetries") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGFContainer Chi4Sym(IndexInfo, S, H, rho, Operators);
+        Chi4Sym.PoleResolution = reduce_tol;
+        Chi4Sym.CoefficientTolerance = coeff_tol;
+        Chi4Sym.UseFrequencySymmetries = true;
+        Chi4Sym.prepareAll(indices4);
+
+        FreqGrid3 grid(PH, {-2, 3}, {-3, 3}, {-3, 3});
+        auto computed_data = Chi4.computeAll(false, grid, MPI_COMM_WORLD, true);
+        auto sym_data = Chi4Sym.computeAll(false, grid, MPI_COMM_WORLD, true);
+
+        for(auto const& indices : indices4) {
+            INFO("indices = " << indices);
+            auto const& data = computed_data[indices];
+            auto const& data_sym = sym_data[indices];
+            REQUIRE(data_sym.size() == grid.size());
+            for(std::size_t k = 0; k < grid.size(); ++k)
+                REQUIRE_THAT(data_sym[k], IsCloseTo(data[k], 1e-10));
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Distributed output") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGF chi(S,
+                          H,
+                          Operators.getAnnihilationOperator(u0),
+                          Operators.getAnnihilationOperator(d0),
+                          Operators.getCreationOperator(u0),
+                          Operators.getCreationOperator(d0),
+                          rho);
+        chi.PoleResolution = reduce_tol;
+        chi.CoefficientTolerance = coeff_tol;
+        chi.prepare();
+
+        FreqGrid3 grid(PH, {-2, 3}, {-3, 3}, {-2, 2});
+        DistributedVector slices = chi.computeDistributed(false, grid, MPI_COMM_WORLD);
+        REQUIRE(slices.size() == grid.size());
+
+        // Each process owns a slice of the grid
+        auto const& local_data = slices.getLocalData();
+        for(std::size_t k = 0; k < local_data.size(); ++k) {
+            auto n = grid[slices.getOffset() + k];
+            REQUIRE_THAT(local_data[k], IsCloseTo(chi(n[0], n[1], n[2]), 1e-10));
+        }
+
+        // Assemble the whole grid on the root process
+        auto data = slices.gather(0);
+        if(pMPI::rank(MPI_COMM_WORLD) == 0) {
+            REQUIRE(data.size() == grid.size());
+            for(std::size_t k = 0; k < grid.size(); ++k) {
+                auto n = grid[k];
+                REQUIRE_THAT(data[k], IsCloseTo(chi(n[0], n[1], n[2]), 1e-10));
+            }
+        } else
+            REQUIRE(data.empty());
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Densely stored operator parts") {
+        // cppcheck-suppress-begin unreadVariable
+        FieldOperatorContainer DenseOperators(IndexInfo, HS, S, H, f);
+        DenseOperators.DenseFillThreshold = 0.2;
+        DenseOperators.prepareAll(HS);
+        DenseOperators.computeAll();
+
+        std::size_t NumDense = 0;
+        auto const& cdag_map = DenseOperators.getCreationOperator(u0).getBlockMapping();
+        for(auto it = cdag_map.right.begin(); it != cdag_map.right.end(); ++it) {
+            auto const& part = DenseOperators.getCreationOperator(u0).getPartFromRightIndex(it->first);
+            auto const& part_ref = Operators.getCreationOperator(u0).getPartFromRightIndex(it->first);
+            NumDense += part.isDense();
+            if(part.isDense())
+                REQUIRE_THROWS_AS(part.getRowMajorView<false>(), std::runtime_error);
+            REQUIRE(part.getNonZeros() == part_ref.getNonZeros());
+            RowMajorMatrixType<false> Storage;
+            RealType Diff = (RowMajorMatrixType<false>(part.getRowMajorView<false>(Storage)) -
+                             RowMajorMatrixType<false>(part_ref.getRowMajorView<false>()))
+                                .norm();
+            REQUIRE(Diff < 1e-14);
+        }
+        REQUIRE(NumDense > 0);
+
+        // Green's function
+        GreensFunction G(S, H, Operators.getAnnihilationOperator(u0), Operators.getCreationOperator(u0), rho);
+        GreensFunction GDense(
+            S, H, DenseOperators.getAnnihilationOperator(u0), DenseOperators.getCreationOperator(u0), rho);
+        for(GreensFunction* g : {&G, &GDense}) {
+            g->prepare();
+            g->compute();
+        }
+        for(long n = -10; n < 10; ++n)
+            REQUIRE_THAT(GDense(n), IsCloseTo(G(n), 1e-12));
+
+        // Two-particle Green's function
+        TwoParticleGFContainer Chi4Dense(IndexInfo, S, H, rho, DenseOperators);
+        Chi4Dense.PoleResolution = reduce_tol;
+        Chi4Dense.CoefficientTolerance = coeff_tol;
+        Chi4Dense.FuseComponents = true;
+        Chi4Dense.prepareAll(indices4);
+
+        FreqGrid3 grid(PH, {-2, 3}, {-3, 3}, {-2, 2});
+        auto computed_data = Chi4.computeAll(false, grid, MPI_COMM_WORLD, true);
+        auto dense_data = Chi4Dense.computeAll(false, grid, MPI_COMM_WORLD);
+
+        for(auto const& indices : indices4) {
+            INFO("indices = " << indices);
+            auto const& data = computed_data[indices];
+            auto const& data_dense = dense_data[indices];
+            REQUIRE(data_dense.size() == grid.size());
+            for(std::size_t k = 0; k < grid.size(); ++k)
+                REQUIRE_THAT(data_dense[k], IsCloseTo(data[k], 1e-10));
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Memory budget") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGF chi(S,
+                          H,
+                          Operators.getAnnihilationOperator(u0),
+                          Operators.getAnnihilationOperator(d0),
+                          Operators.getCreationOperator(u0),
+                          Operators.getCreationOperator(d0),
+                          rho);
+        TwoParticleGF chi_budget(S,
+                                 H,
+                                 Operators.getAnnihilationOperator(u0),
+                                 Operators.getAnnihilationOperator(d0),
+                                 Operators.getCreationOperator(u0),
+                                 Operators.getCreationOperator(d0),
+                                 rho);
+        for(TwoParticleGF* c : {&chi, &chi_budget}) {
+            c->PoleResolution = reduce_tol;
+            c->CoefficientTolerance = coeff_tol;
+        }
+        // Enough to store the values, but the frequencies are evaluated in several chunks
+        chi_budget.MemoryBudget = 100000;
+        chi.prepare();
+        chi_budget.prepare();
+
+        FreqGrid3 grid(PH, {-6, 6}, {-10, 10}, {-10, 10});
+        REQUIRE(grid.size() * sizeof(ComplexType) < chi_budget.MemoryBudget);
+        auto data = chi.compute(false, grid, MPI_COMM_WORLD);
+        auto data_budget = chi_budget.compute(false, grid, MPI_COMM_WORLD);
+        REQUIRE(data_budget.size() == grid.size());
+        for(std::size_t k = 0; k < grid.size(); ++k)
+            REQUIRE_THAT(data_budget[k], IsCloseTo(data[k], 1e-10));
+
+        // The terms are still available for evaluation, whether they have been broadcast or not
+        std::vector<MatsubaraTriplet> indices(grid.size());
+        for(std::size_t k = 0; k < grid.size(); ++k)
+            indices[k] = grid[k];
+        auto values = chi_budget.evaluate(indices, MPI_COMM_WORLD);
+        for(std::size_t k = 0; k < grid.size(); ++k)
+            REQUIRE_THAT(values[k], IsCloseTo(data[k], 1e-10));
+
+        // Containers pass the budget to their elements, terms of the elements that do not fit are not broadcast
+        TwoParticleGFContainer Chi4Budget(IndexInfo, S, H, rho, Operators);
+        Chi4Budget.PoleResolution = reduce_tol;
+        Chi4Budget.CoefficientTolerance = coeff_tol;
+        Chi4Budget.MemoryBudget = 8000;
+        Chi4Budget.prepareAll(indices4);
+
+        FreqGrid3 small_grid(PH, {-2, 3}, {-3, 3}, {-2, 2});
+        REQUIRE(indices4.size() * small_grid.size() * sizeof(ComplexType) < Chi4Budget.MemoryBudget);
+        auto computed_data = Chi4.computeAll(false, small_grid, MPI_COMM_WORLD, true);
+        auto budget_data = Chi4Budget.computeAll(false, small_grid, MPI_COMM_WORLD, true);
+        for(auto const& ic : indices4) {
+            INFO("indices = " << ic);
+            auto const& data_ref = computed_data[ic];
+            auto const& data_el = budget_data[ic];
+            REQUIRE(data_el.size() == small_grid.size());
+            for(std::size_t k = 0; k < small_grid.size(); ++k)
+                REQUIRE_THAT(data_el[k], IsCloseTo(data_ref[k], 1e-10));
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("Evaluation of frozen terms and on Matsubara grids") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGF chi(S,
+                          H,
+                          Operators.getAnnihilationOperator(u0),
+                          Operators.getAnnihilationOperator(u0),
+                          Operators.getCreationOperator(u0),
+                          Operators.getCreationOperator(u0),
+                          rho);
+        chi.PoleResolution = reduce_tol;
+        chi.CoefficientTolerance = coeff_tol;
+        chi.prepare();
+
+        // A box of Matsubara frequencies triggers the pole-table evaluation
+        FreqVec3 box;
+        for(int n1 = -3; n1 < 3; ++n1) {
+            for(int n3 = -3; n3 < 3; ++n3) {
+                for(int i = 0; i < chi_ref.size(); ++i) {
+                    box.emplace_back(I * (2. * n1 + 1.) * M_PI / beta,
+                                     I * (2. * i + 1.) * M_PI / beta,
+                                     I * (2. * n3 + 1.) * M_PI / beta);
+                }
+            }
+        }
+        auto box_data = chi.compute(false, box, MPI_COMM_WORLD);
+
+        std::vector<ComplexType> values;
+        for(int n1 = -3; n1 < 3; ++n1) {
+            for(int n3 = -3; n3 < 3; ++n3) {
+                for(int i = 0; i < chi_ref.size(); ++i)
+                    values.push_back(chi(n1, i, n3));
+            }
+        }
+        for(std::size_t k = 0; k < values.size(); ++k)
+            REQUIRE_THAT(box_data[k], IsCloseTo(values[k], 1e-10));
+
+        chi.freeze();
+
+        auto it = values.begin();
+        for(int n1 = -3; n1 < 3; ++n1) {
+            for(int n3 = -3; n3 < 3; ++n3) {
+                for(int i = 0; i < chi_ref.size(); ++i)
+                    REQUIRE_THAT(chi(n1, i, n3), IsCloseTo(*it++, 1e-10));
+            }
+        }
+
+        for(int i = 0; i < chi_ref.size(); ++i) {
+            ComplexType w_p = I * (2. * i + 1.) * M_PI / beta;
+            REQUIRE_THAT(chi(omega + Omega, w_p, omega), IsCloseTo(chi_ref[i], 1e-6));
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
 }
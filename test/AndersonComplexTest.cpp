@@ -121,29 +121,34 @@ TEST_CASE("Bare Anderson atom with complex spin mixing", "[AndersonComplex]") {
     rho.prepare();
     rho.compute();
 
-    FieldOperatorContainer Operators(IndexInfo, HS, S, H);
-    Operators.prepareAll(HS);
-    Operators.computeAll();
-
     // Reference
     GF_ref G_ref(J);
 
-    for(spin s1 : {down, up}) {
-        for(spin s2 : {down, up}) {
-            ParticleIndex index1 = IndexInfo.getIndex("C", 0, s1);
-            ParticleIndex index2 = IndexInfo.getIndex("C", 0, s2);
-            GreensFunction GF(S,
-                              H,
-                              Operators.getAnnihilationOperator(index1),
-                              Operators.getCreationOperator(index2),
-                              rho);
-            GF.prepare();
-            GF.compute();
-
-            for(int n = 0; n < 10; ++n) {
-                auto result = GF(n);
-                auto ref = G_ref(s1, s2, n);
-                REQUIRE_THAT(result, IsCloseTo(ref, 1e-12));
+    // Annihilation operators with their own matrices and sharing the matrices with the creation operators
+    for(bool SharedStorage : {false, true}) {
+        INFO("SharedStorage = " << SharedStorage);
+        FieldOperatorContainer Operators(IndexInfo, HS, S, H);
+        Operators.SharedStorage = SharedStorage;
+        Operators.prepareAll(HS);
+        Operators.computeAll();
+
+        for(spin s1 : {down, up}) {
+            for(spin s2 : {down, up}) {
+                ParticleIndex index1 = IndexInfo.getIndex("C", 0, s1);
+                ParticleIndex index2 = IndexInfo.getIndex("C", 0, s2);
+                GreensFunction GF(S,
+                                  H,
+                                  Operators.getAnnihilationOperator(index1),
+                                  Operators.getCreationOperator(index2),
+                                  rho);
+                GF.prepare();
+                GF.compute();
+
+                for(int n = 0; n < 10; ++n) {
+                    auto result = GF(n);
+                    auto ref = G_ref(s1, s2, n);
+                    REQUIRE_THAT(result, IsCloseTo(ref, 1e-12));
+                }
             }
         }
     }
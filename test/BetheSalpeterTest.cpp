@@ -0,0 +1,145 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file test/BetheSalpeterTest.cpp
+/// \brief Generalized susceptibilities and irreducible vertices of a single Hubbard atom.
+
+#include <pomerol/BetheSalpeter.hpp>
+#include <pomerol/DensityMatrix.hpp>
+#include <pomerol/FieldOperatorContainer.hpp>
+#include <pomerol/GFContainer.hpp>
+#include <pomerol/Hamiltonian.hpp>
+#include <pomerol/HilbertSpace.hpp>
+#include <pomerol/IndexClassification.hpp>
+#include <pomerol/LatticePresets.hpp>
+#include <pomerol/Misc.hpp>
+#include <pomerol/StatesClassification.hpp>
+#include <pomerol/TwoParticleGFContainer.hpp>
+#include <pomerol/Vertex4.hpp>
+
+#include "catch2/catch-pomerol.hpp"
+
+#include <map>
+#include <vector>
+
+using namespace Pomerol;
+
+// cppcheck-suppress syntaxError
+TEST_CASE("Bethe-Salpeter equation for a single Hubbard atom", "[BetheSalpeter]") {
+    // Parameters
+    RealType U = 1.0;
+    RealType beta = 5;
+    MatsubaraRange W(-2, 3);
+    MatsubaraRange Nu(-4, 4);
+
+    using namespace LatticePresets;
+
+    auto HExpr = CoulombS("A", U, -U / 2);
+    INFO("Hamiltonian\n" << HExpr);
+
+    auto IndexInfo = MakeIndexClassification(HExpr);
+    INFO("Indices\n" << IndexInfo);
+
+    auto HS = MakeHilbertSpace(IndexInfo, HExpr);
+    HS.compute();
+    StatesClassification S;
+    S.compute(HS);
+
+    Hamiltonian H(S);
+    H.prepare(HExpr, HS, MPI_COMM_WORLD);
+    H.compute(MPI_COMM_WORLD);
+
+    DensityMatrix rho(S, H, beta);
+    rho.prepare();
+    rho.compute();
+
+    FieldOperatorContainer Operators(IndexInfo, HS, S, H);
+    Operators.prepareAll(HS);
+    Operators.computeAll();
+
+    GFContainer G(IndexInfo, S, H, rho, Operators);
+    G.prepareAll();
+    G.computeAll();
+
+    TwoParticleGFContainer Chi(IndexInfo, S, H, rho, Operators);
+    Chi.PoleResolution = 1e-4;
+    Chi.CoefficientTolerance = 1e-12;
+    Chi.prepareAll();
+    Chi.computeAll();
+
+    ParticleIndex up_index = IndexInfo.getIndex("A", 0, up);
+    ParticleIndex down_index = IndexInfo.getIndex("A", 0, down);
+
+    // ic is the index combination of the element formed by the first pair as both the row and the column pair
+    auto check = [&](Channel channel, std::vector<IndexCombination2> const& Pairs, IndexCombination4 const& ic) {
+        BetheSalpeter BSE(channel, Pairs, W, Nu);
+        FreqGrid3 grid = BSE.getGrid();
+        std::size_t D = BSE.getMatrixSize();
+        REQUIRE(D == Pairs.size() * Nu.size());
+
+        // Values of chi on the grid
+        std::map<IndexCombination4, std::vector<ComplexType>> chi_data;
+        for(auto const& c : BSE.getIndexCombinations()) {
+            auto& chi_data_c = chi_data[c];
+            for(std::size_t k = 0; k < grid.size(); ++k)
+                chi_data_c.push_back(Chi(c)(grid[k][0], grid[k][1], grid[k][2]));
+        }
+        BSE.compute(chi_data, G);
+
+        BetheSalpeter BSEFromTerms(channel, Pairs, W, Nu);
+        BSEFromTerms.compute(Chi, G);
+
+        // Connected part of the element
+        REQUIRE(BSE.getIndexCombinations().count(ic) == 1);
+        Vertex4 Gamma4(Chi(ic),
+                       G(ic.Index1, ic.Index3),
+                       G(ic.Index2, ic.Index4),
+                       G(ic.Index1, ic.Index4),
+                       G(ic.Index2, ic.Index3));
+
+        MatsubaraRange LocalW = BSE.getLocalBosonicRange();
+        for(long m = LocalW.Begin; m < LocalW.End; ++m) {
+            INFO("m = " << m);
+            ComplexMatrixType X = BSE.getSusceptibility(m);
+            ComplexMatrixType X0 = BSE.getBubble(m);
+            ComplexMatrixType Gamma = BSE.getVertex(m);
+
+            REQUIRE((BSEFromTerms.getSusceptibility(m) - X).norm() < 1e-10 * X.norm());
+            REQUIRE((BSEFromTerms.getVertex(m) - Gamma).norm() < 1e-8 * Gamma.norm());
+
+            for(long n = Nu.Begin; n < Nu.End; ++n) {
+                for(long np = Nu.Begin; np < Nu.End; ++np) {
+                    MatsubaraTriplet n3 = grid[grid.index(static_cast<std::size_t>(m - W.Begin),
+                                                          static_cast<std::size_t>(n - Nu.Begin),
+                                                          static_cast<std::size_t>(np - Nu.Begin))];
+                    INFO(n3[0] << " " << n3[1] << " " << n3[2]);
+                    std::size_t I = BSE.getMatrixIndex(0, n);
+                    std::size_t J = BSE.getMatrixIndex(0, np);
+                    REQUIRE_THAT(X(I, J) - X0(I, J), IsCloseTo(Gamma4.value(n3[0], n3[1], n3[2]), 1e-10));
+                }
+            }
+
+            // Bethe-Salpeter equation
+            ComplexMatrixType Residual = X - X0 - X0 * Gamma * X;
+            REQUIRE(Residual.norm() < 1e-8 * X.norm());
+        }
+    };
+
+    std::vector<IndexCombination2> ph_pairs = {IndexCombination2(up_index, up_index),
+                                               IndexCombination2(down_index, down_index)};
+    std::vector<IndexCombination2> pp_pairs = {IndexCombination2(up_index, down_index),
+                                               IndexCombination2(down_index, up_index)};
+    IndexCombination4 uuuu(up_index, up_index, up_index, up_index);
+    IndexCombination4 udud(up_index, down_index, up_index, down_index);
+
+    SECTION("Particle-hole channel") { check(PH, ph_pairs, uuuu); }
+    SECTION("Crossed particle-hole channel") { check(xPH, ph_pairs, uuuu); }
+    SECTION("Particle-particle channel") { check(PP, pp_pairs, udud); }
+}
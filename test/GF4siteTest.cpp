@@ -25,6 +25,9 @@
 
 #include "catch2/catch-pomerol.hpp"
 
+#include <cstddef>
+#include <vector>
+
 using namespace Pomerol;
 
 // cppcheck-suppress syntaxError
@@ -106,4 +109,48 @@ TEST_CASE("Green's function of a Hubbard plaquette", "[GF4site]") {
         // some contributions to the GF.
         REQUIRE_THAT(result, IsCloseTo(ref, 1e-6));
     }
+
+    // Lazy computation of operator parts, either on first access or for all requested parts at once
+    rho.truncateBlocks(1e-8, false);
+    GreensFunction GFTruncated(S,
+                               H,
+                               Operators.getAnnihilationOperator(A_down_index),
+                               Operators.getCreationOperator(A_down_index),
+                               rho);
+    GFTruncated.prepare();
+    GFTruncated.compute();
+
+    for(bool Bulk : {false, true}) {
+        INFO("Bulk = " << Bulk);
+        FieldOperatorContainer LazyOperators(IndexInfo, HS, S, H);
+        LazyOperators.Lazy = true;
+        LazyOperators.prepareAll(HS);
+        LazyOperators.computeAll();
+
+        auto const& c = LazyOperators.getAnnihilationOperator(A_down_index);
+        auto const& cdag = LazyOperators.getCreationOperator(A_down_index);
+        GreensFunction LazyGF(S, H, c, cdag, rho);
+        LazyGF.prepare();
+        if(Bulk)
+            LazyOperators.computeRequested();
+        LazyGF.compute();
+
+        for(int n = 0; n < G_ref.size(); ++n)
+            REQUIRE_THAT(LazyGF(n), IsCloseTo(GFTruncated(n), 1e-12));
+
+        // Parts connecting only discarded blocks are never computed
+        std::size_t NumPending = 0;
+        std::vector<MonomialOperator const*> Ops = {&c, &cdag};
+        for(MonomialOperator const* Op : Ops) {
+            auto const& block_map = Op->getBlockMapping();
+            for(auto it = block_map.right.begin(); it != block_map.right.end(); ++it) {
+                auto const& part = Op->getPartFromRightIndex(it->first);
+                bool Needed = rho.isRetained(part.getLeftIndex()) || rho.isRetained(part.getRightIndex());
+                REQUIRE(part.isRequested() == Needed);
+                REQUIRE(part.isPending() == !Needed);
+                NumPending += part.isPending();
+            }
+        }
+        REQUIRE(NumPending > 0);
+    }
 }
@@ -0,0 +1,140 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file test/HamiltonianDistributedTest.cpp
+/// \brief Distributed storage of Hamiltonian eigenvectors.
+
+#include <mpi_dispatcher/misc.hpp>
+
+#include <pomerol/DensityMatrix.hpp>
+#include <pomerol/FieldOperatorContainer.hpp>
+#include <pomerol/GreensFunction.hpp>
+#include <pomerol/Hamiltonian.hpp>
+#include <pomerol/HilbertSpace.hpp>
+#include <pomerol/IndexClassification.hpp>
+#include <pomerol/LatticePresets.hpp>
+#include <pomerol/Misc.hpp>
+#include <pomerol/StatesClassification.hpp>
+
+#include "catch2/catch-pomerol.hpp"
+
+#include <string>
+
+using namespace Pomerol;
+
+// cppcheck-suppress syntaxError
+TEST_CASE("Distributed storage of Hamiltonian eigenvectors", "[hamiltonian]") {
+    using namespace LatticePresets;
+
+    int const L = 4;
+    RealType const beta = 10.0;
+    int comm_rank = pMPI::rank(MPI_COMM_WORLD);
+
+    auto HExpr = CoulombS("0", 2.0, -1.0);
+    for(int i = 1; i < L; ++i)
+        HExpr += CoulombS(std::to_string(i), 2.0, -1.0);
+    for(int i = 0; i < L; ++i)
+        HExpr += Hopping(std::to_string(i), std::to_string((i + 1) % L), -1.0);
+
+    auto IndexInfo = MakeIndexClassification(HExpr);
+    auto HS = MakeHilbertSpace(IndexInfo, HExpr);
+    HS.compute();
+    StatesClassification S;
+    S.compute(HS);
+
+    Hamiltonian HRef(S);
+    HRef.prepare(HExpr, HS, MPI_COMM_WORLD);
+    HRef.compute(MPI_COMM_WORLD);
+
+    Hamiltonian H(S);
+    H.DistributedEigenvectors = true;
+    H.prepare(HExpr, HS, MPI_COMM_WORLD);
+    H.compute(MPI_COMM_WORLD);
+
+    REQUIRE_THAT(H.getGroundEnergy(), IsCloseTo(HRef.getGroundEnergy(), 1e-12));
+
+    for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+        auto const& part = H.getPart(Block);
+        auto const& part_ref = HRef.getPart(Block);
+
+        REQUIRE(part.hasLocalEigenvectors() == (part.getOwner() == comm_rank));
+        REQUIRE(part_ref.hasLocalEigenvectors());
+        REQUIRE_THAT((part.getEigenValues() - part_ref.getEigenValues()).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-12));
+
+        auto U = part.fetchMatrix<false>();
+        REQUIRE_THAT((*U - part_ref.getMatrix<false>()).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-12));
+    }
+
+    // Reduction of a distributed Hamiltonian
+    RealType const Cutoff = 3.0;
+    H.reduce(Cutoff, MPI_COMM_WORLD);
+    HRef.reduce(Cutoff, MPI_COMM_WORLD);
+    for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+        auto U = H.getPart(Block).fetchMatrix<false>();
+        auto const& U_ref = HRef.getPart(Block).getMatrix<false>();
+        REQUIRE(U->cols() == U_ref.cols());
+        REQUIRE_THAT((*U - U_ref).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-12));
+    }
+
+    // Operator rotation with fetched eigenvectors
+    ParticleIndex d0 = IndexInfo.getIndex("0", 0, down);
+
+    DensityMatrix rhoRef(S, HRef, beta);
+    rhoRef.prepare();
+    rhoRef.compute();
+    FieldOperatorContainer OperatorsRef(IndexInfo, HS, S, HRef);
+    OperatorsRef.prepareAll(HS);
+    OperatorsRef.computeAll();
+    GreensFunction GFRef(S, HRef, OperatorsRef.getAnnihilationOperator(d0), OperatorsRef.getCreationOperator(d0), rhoRef);
+    GFRef.prepare();
+    GFRef.compute();
+
+    DensityMatrix rho(S, H, beta);
+    rho.prepare();
+    rho.compute();
+    FieldOperatorContainer Operators(IndexInfo, HS, S, H);
+    Operators.prepareAll(HS);
+    Operators.computeAll();
+
+    // Parts computed by different processes are broadcast to all processes
+    auto check_parts = [](MonomialOperator const& Op, MonomialOperator const& OpRef) {
+        for(auto const& Blocks : Op.getBlockMapping().right) {
+            auto const& part = Op.getPartFromRightIndex(Blocks.first);
+            auto const& part_ref = OpRef.getPartFromRightIndex(Blocks.first);
+            REQUIRE(part.getStatus() == ComputableObject::Computed);
+            REQUIRE(part.getNonZeros() == part_ref.getNonZeros());
+            RealType Diff = (part.getRowMajorValue<false>() - part_ref.getRowMajorValue<false>()).norm();
+            REQUIRE_THAT(Diff, IsCloseTo(0, 1e-12));
+        }
+    };
+    check_parts(Operators.getCreationOperator(d0), OperatorsRef.getCreationOperator(d0));
+    check_parts(Operators.getAnnihilationOperator(d0), OperatorsRef.getAnnihilationOperator(d0));
+
+    // Each part is computed by the process storing the larger of the two eigenvector matrices
+    auto check_owners = [&H](MonomialOperator const& Op) {
+        for(auto const& Blocks : Op.getBlockMapping().right) {
+            auto const& part = Op.getPartFromRightIndex(Blocks.first);
+            auto const& HFrom = H.getPart(part.getRightIndex());
+            auto const& HTo = H.getPart(part.getLeftIndex());
+            double SizeFrom = static_cast<double>(HFrom.getSize()) * HFrom.getNumberOfEigenValues();
+            double SizeTo = static_cast<double>(HTo.getSize()) * HTo.getNumberOfEigenValues();
+            REQUIRE(part.getOwner() == (SizeTo > SizeFrom ? HTo.getOwner() : HFrom.getOwner()));
+        }
+    };
+    check_owners(Operators.getCreationOperator(d0));
+    check_owners(Operators.getAnnihilationOperator(d0));
+
+    GreensFunction GF(S, H, Operators.getAnnihilationOperator(d0), Operators.getCreationOperator(d0), rho);
+    GF.prepare();
+    GF.compute();
+
+    for(int n = 0; n < 10; ++n)
+        REQUIRE_THAT(GF(n), IsCloseTo(GFRef(n), 1e-12));
+}
@@ -0,0 +1,167 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file test/HamiltonianLowestTest.cpp
+/// \brief Partial diagonalization of a Hubbard ring.
+
+#include <pomerol/DensityMatrix.hpp>
+#include <pomerol/Hamiltonian.hpp>
+#include <pomerol/HamiltonianPart.hpp>
+#include <pomerol/HilbertSpace.hpp>
+#include <pomerol/IndexClassification.hpp>
+#include <pomerol/LatticePresets.hpp>
+#include <pomerol/Misc.hpp>
+#include <pomerol/StatesClassification.hpp>
+
+#include "catch2/catch-pomerol.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace Pomerol;
+
+// cppcheck-suppress syntaxError
+TEST_CASE("Lowest eigenpairs of a Hubbard ring", "[hamiltonian]") {
+    using namespace LatticePresets;
+
+    int const L = 6;
+    RealType const beta = 10.0;
+
+    auto HExpr = CoulombS("0", 2.0, -1.0);
+    for(int i = 1; i < L; ++i)
+        HExpr += CoulombS(std::to_string(i), 2.0, -1.0);
+    for(int i = 0; i < L; ++i)
+        HExpr += Hopping(std::to_string(i), std::to_string((i + 1) % L), -1.0);
+
+    auto IndexInfo = MakeIndexClassification(HExpr);
+    auto HS = MakeHilbertSpace(IndexInfo, HExpr);
+    HS.compute();
+    StatesClassification S;
+    S.compute(HS);
+
+    Hamiltonian HFull(S);
+    HFull.prepare(HExpr, HS, MPI_COMM_WORLD);
+
+    // Store matrices of H' parts
+    std::vector<MatrixType<false>> hmats;
+    hmats.reserve(S.getNumberOfBlocks());
+    for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+        hmats.push_back(HFull.getPart(Block).getMatrix<false>());
+    }
+
+    HFull.compute(MPI_COMM_WORLD);
+
+    // cppcheck-suppress-begin unreadVariable
+    SECTION("Fixed number of eigenpairs") {
+        InnerQuantumState const NumEigenvalues = 5;
+
+        Hamiltonian H(S);
+        H.prepare(HExpr, HS, MPI_COMM_WORLD);
+        H.computeLowest(NumEigenvalues, HUGE_VAL, 1e-10, MPI_COMM_WORLD);
+
+        REQUIRE_THAT(H.getGroundEnergy(), IsCloseTo(HFull.getGroundEnergy(), 1e-9));
+
+        for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+            auto const& part = H.getPart(Block);
+            auto const& hmat = hmats[Block];
+            auto n = std::min(NumEigenvalues, H.getBlockSize(Block));
+            REQUIRE(part.getNumberOfEigenValues() == n);
+            REQUIRE(static_cast<InnerQuantumState>(part.getMatrix<false>().rows()) == H.getBlockSize(Block));
+            REQUIRE(static_cast<InnerQuantumState>(part.getMatrix<false>().cols()) == n);
+
+            auto const& ev_ref = HFull.getEigenValues(Block);
+            for(InnerQuantumState Inner = 0; Inner < n; ++Inner) {
+                RealType E = part.getEigenValue(Inner);
+                REQUIRE_THAT(E, IsCloseTo(ev_ref(Inner), 1e-9));
+                auto state = part.getEigenState<false>(Inner);
+                REQUIRE_THAT((hmat * state - E * state).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-8));
+            }
+        }
+    }
+
+    SECTION("Energy cutoff") {
+        RealType const Cutoff = 2.0;
+
+        Hamiltonian H(S);
+        H.prepare(HExpr, HS, MPI_COMM_WORLD);
+        H.computeLowest(0, Cutoff, 1e-10, MPI_COMM_WORLD);
+
+        RealType E0 = HFull.getGroundEnergy();
+        REQUIRE_THAT(H.getGroundEnergy(), IsCloseTo(E0, 1e-9));
+
+        DensityMatrix rhoFull(S, HFull, beta);
+        rhoFull.prepare();
+        rhoFull.compute();
+        DensityMatrix rho(S, H, beta);
+        rho.prepare();
+        rho.compute();
+
+        for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+            auto const& part = H.getPart(Block);
+            auto const& ev_ref = HFull.getEigenValues(Block);
+            // All eigenvalues below the cutoff must have been found
+            InnerQuantumState n_ref = 0;
+            for(; n_ref < static_cast<InnerQuantumState>(ev_ref.size()) && ev_ref(n_ref) <= E0 + Cutoff; ++n_ref)
+                ;
+            if(n_ref == 0)
+                continue;
+            REQUIRE(part.getNumberOfEigenValues() == n_ref);
+            for(InnerQuantumState Inner = 0; Inner < n_ref; ++Inner) {
+                REQUIRE_THAT(part.getEigenValue(Inner), IsCloseTo(ev_ref(Inner), 1e-9));
+                REQUIRE_THAT(rho.getPart(Block).getWeight(Inner),
+                             IsCloseTo(rhoFull.getPart(Block).getWeight(Inner), 1e-8));
+            }
+        }
+    }
+    SECTION("Sparse and matrix-free storage") {
+        InnerQuantumState const NumEigenvalues = 5;
+
+        for(auto Storage : {HamiltonianPart::SparseStorage, HamiltonianPart::MatrixFreeStorage}) {
+            Hamiltonian H(S);
+            H.prepare(HExpr, HS, MPI_COMM_WORLD, Storage);
+
+            for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+                auto const& part = H.getPart(Block);
+                auto const& hmat = hmats[Block];
+                REQUIRE(part.getStorage() == Storage);
+
+                DavidsonBlockType<false> X = DavidsonBlockType<false>::Random(hmat.rows(), 3);
+                DavidsonBlockType<false> Y(hmat.rows(), 3);
+                part.apply<false>(X, Y);
+                REQUIRE_THAT((Y - hmat * X).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-12));
+
+                // A single vector is split between threads by ranges of basis states
+                DavidsonBlockType<false> x = DavidsonBlockType<false>::Random(hmat.rows(), 1);
+                DavidsonBlockType<false> y(hmat.rows(), 1);
+                part.apply<false>(x, y);
+                REQUIRE_THAT((y - hmat * x).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-12));
+            }
+
+            H.computeLowest(NumEigenvalues, HUGE_VAL, 1e-10, MPI_COMM_WORLD);
+            REQUIRE_THAT(H.getGroundEnergy(), IsCloseTo(HFull.getGroundEnergy(), 1e-9));
+
+            for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+                auto const& part = H.getPart(Block);
+                auto const& ev_ref = HFull.getEigenValues(Block);
+                auto n = std::min(NumEigenvalues, H.getBlockSize(Block));
+                REQUIRE(part.getNumberOfEigenValues() == n);
+                for(InnerQuantumState Inner = 0; Inner < n; ++Inner) {
+                    RealType E = part.getEigenValue(Inner);
+                    REQUIRE_THAT(E, IsCloseTo(ev_ref(Inner), 1e-9));
+                    auto state = part.getEigenState<false>(Inner);
+                    REQUIRE_THAT((hmats[Block] * state - E * state).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-8));
+                }
+            }
+        }
+    }
+    // cppcheck-suppress-end unreadVariable
+}
@@ -87,6 +87,29 @@ TEST_CASE("Simple Hamiltonian test", "[hamiltonian]") {
             }
         }
     }
+
+    SECTION("Eigenvalues only") {
+        Hamiltonian H2(S);
+        H2.prepare(HExpr, HS, MPI_COMM_WORLD);
+        H2.compute(MPI_COMM_WORLD, true);
+
+        REQUIRE_THAT(H2.getGroundEnergy(), IsCloseTo(H.getGroundEnergy(), 1e-12));
+        for(BlockNumber Block = 0; Block < S.getNumberOfBlocks(); ++Block) {
+            auto const& part = H2.getPart(Block);
+            REQUIRE_FALSE(part.hasLocalEigenvectors());
+            REQUIRE_THAT((part.getEigenValues() - H.getEigenValues(Block)).cwiseAbs().maxCoeff(),
+                         IsCloseTo(0, 1e-12));
+
+            // Eigenvectors are computed on demand
+            auto const& hmat = hmats[Block];
+            for(BlockNumber Inner = 0; Inner < H2.getBlockSize(Block); ++Inner) {
+                RealType E = part.getEigenValue(Inner);
+                auto state = part.getEigenState<false>(Inner);
+                REQUIRE_THAT((hmat * state - E * state).cwiseAbs().maxCoeff(), IsCloseTo(0, 1e-10));
+            }
+            REQUIRE(part.hasLocalEigenvectors());
+        }
+    }
     // cppcheck-suppress-end unreadVariable
 
     SECTION("Monomial operators") {
@@ -15,17 +15,29 @@
 
 #include <mpi_dispatcher/misc.hpp>
 #include <mpi_dispatcher/mpi_dispatcher.hpp>
+#include <mpi_dispatcher/mpi_skel.hpp>
 
 #include "catch2/catch-pomerol.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <map>
 #include <memory>
+#include <numeric>
 #include <random>
+#include <set>
 #include <thread>
+#include <vector>
 
 using namespace pMPI;
 
+struct cost_task_type {
+    int& counter;
+    CostType complexity;
+    void run() { ++counter; }
+};
+
 struct dumb_task_type {
     int counter = 0;
     void operator()(double seconds, int jobid, int rank) {
@@ -102,4 +114,114 @@ TEST_CASE("Test mpi_dispatcher", "[mpi_dispatcher]") {
         MPI_Allreduce(MPI_IN_PLACE, &dumb_task.counter, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
         REQUIRE(dumb_task.counter == ntasks);
     }
+
+    SECTION("With affinity") {
+        std::uniform_real_distribution<double> dist(0, 0.001);
+
+        int comm_size = pMPI::size(MPI_COMM_WORLD);
+        dumb_task_type dumb_task;
+        // cppcheck-suppress variableScope
+        int ntasks = 45;
+
+        std::map<JobId, WorkerId> affinity;
+        for(int job = 0; job < ntasks; job += 2)
+            affinity[job] = job % comm_size;
+
+        std::unique_ptr<MPIMaster> disp(comm_rank == root ? new MPIMaster(MPI_COMM_WORLD, ntasks, true) : nullptr);
+        if(comm_rank == root)
+            disp->set_affinity(affinity);
+
+        for(MPIWorker worker(MPI_COMM_WORLD, root); !worker.is_finished();) {
+            if(comm_rank == root)
+                disp->order();
+            worker.receive_order();
+            if(worker.is_working()) {
+                dumb_task(dist(gen), worker.current_job(), comm_rank);
+                worker.report_job_done();
+            }
+            if(comm_rank == root)
+                disp->check_workers();
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &dumb_task.counter, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        REQUIRE(dumb_task.counter == ntasks);
+        if(comm_rank == root)
+            REQUIRE(disp->DispatchMap.size() == ntasks);
+    }
+
+    SECTION("With strict affinity") {
+        std::uniform_real_distribution<double> dist(0, 0.001);
+
+        int comm_size = pMPI::size(MPI_COMM_WORLD);
+        dumb_task_type dumb_task;
+        // cppcheck-suppress variableScope
+        int ntasks = 45;
+
+        // All jobs of the first half, and none of the second half are bound to specific workers
+        std::map<JobId, WorkerId> affinity;
+        for(int job = 0; job < ntasks / 2; ++job)
+            affinity[job] = (job / 3) % comm_size;
+
+        std::unique_ptr<MPIMaster> disp(comm_rank == root ? new MPIMaster(MPI_COMM_WORLD, ntasks, true) : nullptr);
+        if(comm_rank == root)
+            disp->set_affinity(affinity, true);
+
+        for(MPIWorker worker(MPI_COMM_WORLD, root); !worker.is_finished();) {
+            if(comm_rank == root)
+                disp->order();
+            worker.receive_order();
+            if(worker.is_working()) {
+                dumb_task(dist(gen), worker.current_job(), comm_rank);
+                worker.report_job_done();
+            }
+            if(comm_rank == root)
+                disp->check_workers();
+        }
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Allreduce(MPI_IN_PLACE, &dumb_task.counter, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        REQUIRE(dumb_task.counter == ntasks);
+        if(comm_rank == root) {
+            REQUIRE(disp->DispatchMap.size() == ntasks);
+            for(auto const& a : affinity)
+                REQUIRE(disp->DispatchMap[a.first] == a.second);
+        }
+    }
+
+    SECTION("With mpi_skel and a cost model") {
+        REQUIRE(lpt_imbalance({4, 3, 3, 2, 2, 2}, 2) == 1.0);
+        REQUIRE(lpt_imbalance({6, 1, 1}, 2) == 1.5);
+        REQUIRE(lpt_imbalance({}, 4) == 1.0);
+
+        int counter = 0;
+        int ntasks = 30;
+        mpi_skel<cost_task_type> skel;
+        for(int job = 0; job < ntasks; ++job)
+            skel.parts.push_back(cost_task_type{counter, CostType(job % 7 + 1)});
+        skel.cost_estimator = [](cost_task_type const& t) { return t.complexity * t.complexity; };
+
+        std::map<JobId, WorkerId> job_map = skel.run(MPI_COMM_WORLD, false);
+
+        MPI_Allreduce(MPI_IN_PLACE, &counter, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+        REQUIRE(counter == ntasks);
+        REQUIRE(job_map.size() == ntasks);
+
+        std::vector<CostType> costs;
+        for(auto const& t : skel.parts)
+            costs.push_back(t.complexity * t.complexity);
+        REQUIRE(skel.predicted_imbalance == lpt_imbalance(costs, pMPI::size(MPI_COMM_WORLD)));
+
+        // The heaviest jobs are dispatched first, one per worker
+        std::vector<JobId> job_order(ntasks);
+        std::iota(job_order.begin(), job_order.end(), 0);
+        std::stable_sort(job_order.begin(), job_order.end(), [&costs](JobId l, JobId r) {
+            return costs[l] > costs[r];
+        });
+        std::size_t n_heavy = std::min<std::size_t>(pMPI::size(MPI_COMM_WORLD), ntasks);
+        std::set<WorkerId> heavy_workers;
+        for(std::size_t i = 0; i < n_heavy; ++i)
+            heavy_workers.insert(job_map[job_order[i]]);
+        REQUIRE(heavy_workers.size() == n_heavy);
+    }
 }
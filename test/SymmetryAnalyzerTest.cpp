@@ -0,0 +1,149 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file test/SymmetryAnalyzerTest.cpp
+/// \brief Index permutation symmetries of a Hubbard dimer and their use in GF/2PGF containers.
+
+#include <pomerol/DensityMatrix.hpp>
+#include <pomerol/FieldOperatorContainer.hpp>
+#include <pomerol/GFContainer.hpp>
+#include <pomerol/Hamiltonian.hpp>
+#include <pomerol/HilbertSpace.hpp>
+#include <pomerol/IndexClassification.hpp>
+#include <pomerol/LatticePresets.hpp>
+#include <pomerol/Misc.hpp>
+#include <pomerol/StatesClassification.hpp>
+#include <pomerol/SymmetryAnalyzer.hpp>
+#include <pomerol/TwoParticleGFContainer.hpp>
+
+#include "catch2/catch-pomerol.hpp"
+
+#include <set>
+
+using namespace Pomerol;
+
+// cppcheck-suppress syntaxError
+TEST_CASE("Symmetries of a Hubbard dimer", "[SymmetryAnalyzer]") {
+    RealType U = 1.0;
+    RealType mu = 0.4;
+    RealType beta = 10.0;
+
+    using namespace LatticePresets;
+
+    auto HExpr = CoulombS("A", U, -mu) + CoulombS("B", U, -mu);
+    HExpr += Hopping("A", "B", -1.0);
+    INFO("Hamiltonian\n" << HExpr);
+
+    auto IndexInfo = MakeIndexClassification(HExpr);
+    INFO("Indices\n" << IndexInfo);
+
+    ParticleIndex A_up = IndexInfo.getIndex("A", 0, up);
+    ParticleIndex A_dn = IndexInfo.getIndex("A", 0, down);
+    ParticleIndex B_up = IndexInfo.getIndex("B", 0, up);
+    ParticleIndex B_dn = IndexInfo.getIndex("B", 0, down);
+
+    SECTION("Symmetry group") {
+        // Exchange of the sites and spin flip
+        SymmetryAnalyzer Symmetries(HExpr, IndexInfo);
+        REQUIRE(Symmetries.getNumIndices() == 4);
+        REQUIRE_FALSE(Symmetries.isTrivial());
+        for(auto const& P : Symmetries.getGenerators())
+            REQUIRE(std::set<ParticleIndex>(P.begin(), P.end()).size() == 4);
+
+        REQUIRE(Symmetries.getOrbit(IndexCombination2(A_up, A_up)) ==
+                std::set<IndexCombination2>{IndexCombination2(A_up, A_up),
+                                            IndexCombination2(A_dn, A_dn),
+                                            IndexCombination2(B_up, B_up),
+                                            IndexCombination2(B_dn, B_dn)});
+        REQUIRE(Symmetries.getOrbit(IndexCombination2(A_up, B_dn)).size() == 4);
+        REQUIRE(Symmetries.getOrbit(IndexCombination4(A_up, A_dn, A_up, A_dn)).size() == 4);
+
+        // A local field on site A breaks the exchange symmetry, spin flip survives
+        SymmetryAnalyzer SymmetriesSpin(HExpr + Level("A", -0.1), IndexInfo);
+        REQUIRE(SymmetriesSpin.getOrbit(IndexCombination2(A_up, A_up)) ==
+                std::set<IndexCombination2>{IndexCombination2(A_up, A_up), IndexCombination2(A_dn, A_dn)});
+
+        // A magnetic field breaks all symmetries
+        SymmetryAnalyzer SymmetriesNone(HExpr + Magnetization("A", 0.1) + Magnetization("B", 0.2), IndexInfo);
+        REQUIRE(SymmetriesNone.isTrivial());
+    }
+
+    auto HS = MakeHilbertSpace(IndexInfo, HExpr);
+    HS.compute();
+    StatesClassification S;
+    S.compute(HS);
+
+    Hamiltonian H(S);
+    H.prepare(HExpr, HS, MPI_COMM_WORLD);
+    H.compute(MPI_COMM_WORLD);
+
+    DensityMatrix rho(S, H, beta);
+    rho.prepare();
+    rho.compute();
+
+    FieldOperatorContainer Operators(IndexInfo, HS, S, H);
+    Operators.prepareAll(HS);
+    Operators.computeAll();
+
+    SymmetryAnalyzer Symmetries(HExpr, IndexInfo);
+
+    SECTION("GFContainer") {
+        GFContainer G(IndexInfo, S, H, rho, Operators);
+        G.prepareAll();
+        G.computeAll();
+
+        GFContainer GSym(IndexInfo, S, H, rho, Operators);
+        GSym.setSymmetries(Symmetries);
+        GSym.prepareAll();
+        GSym.computeAll();
+
+        // Equivalent elements are shared
+        REQUIRE(&GSym(A_up, A_up) == &GSym(B_dn, B_dn));
+        REQUIRE(&GSym(A_up, B_up) == &GSym(B_dn, A_dn));
+
+        for(ParticleIndex i = 0; i < 4; ++i) {
+            for(ParticleIndex j = 0; j < 4; ++j) {
+                INFO("i = " << i << ", j = " << j);
+                for(int n = 0; n < 10; ++n)
+                    REQUIRE_THAT(GSym(i, j)(n), IsCloseTo(G(i, j)(n), 1e-10));
+            }
+        }
+    }
+
+    SECTION("TwoParticleGFContainer") {
+        std::set<IndexCombination4> indices4 = {IndexCombination4(A_up, A_up, A_up, A_up),
+                                                IndexCombination4(B_dn, B_dn, B_dn, B_dn),
+                                                IndexCombination4(A_up, A_dn, A_up, A_dn),
+                                                IndexCombination4(B_up, B_dn, B_up, B_dn),
+                                                IndexCombination4(A_up, B_up, A_up, B_up),
+                                                IndexCombination4(B_dn, A_dn, B_dn, A_dn)};
+
+        TwoParticleGFContainer Chi4(IndexInfo, S, H, rho, Operators);
+        Chi4.prepareAll(indices4);
+        Chi4.computeAll();
+
+        TwoParticleGFContainer Chi4Sym(IndexInfo, S, H, rho, Operators);
+        Chi4Sym.setSymmetries(Symmetries);
+        Chi4Sym.prepareAll(indices4);
+        Chi4Sym.computeAll();
+
+        // Equivalent elements are shared
+        REQUIRE(&static_cast<TwoParticleGF&>(Chi4Sym(A_up, A_up, A_up, A_up)) ==
+                &static_cast<TwoParticleGF&>(Chi4Sym(B_dn, B_dn, B_dn, B_dn)));
+
+        for(auto const& ic : indices4) {
+            INFO("indices = " << ic);
+            for(long n1 = -2; n1 < 2; ++n1) {
+                for(long n3 = -2; n3 < 2; ++n3)
+                    REQUIRE_THAT(Chi4Sym(ic)(n1, 0, n3), IsCloseTo(Chi4(ic)(n1, 0, n3), 1e-10));
+            }
+        }
+    }
+}
@@ -0,0 +1,146 @@
+//
+// This file is part of pomerol, an exact diagonalization library aimed at
+// solving condensed matter models of interacting fermions.
+//
+// Copyright (C) 2016-2026 A. Antipov, I. Krivenko and contributors
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// \file test/TermListTest.cpp
+/// \brief Addition, reduction and removal of terms in TermList.
+
+#include <pomerol/Misc.hpp>
+#include <pomerol/TermList.hpp>
+
+#include "catch2/catch-pomerol.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <random>
+
+using namespace Pomerol;
+
+// A single-pole term C / (z - P)
+struct PoleTerm {
+    ComplexType Coeff = 0;
+    RealType Pole = 0;
+    long Weight = 1;
+
+    PoleTerm() = default;
+    PoleTerm(ComplexType Coeff, RealType Pole) : Coeff(Coeff), Pole(Pole) {}
+
+    ComplexType operator()(ComplexType z) const { return Coeff / (z - Pole); }
+
+    PoleTerm& operator+=(PoleTerm const& t) {
+        Pole = (Weight * Pole + t.Weight * t.Pole) / RealType(Weight + t.Weight);
+        Weight += t.Weight;
+        Coeff += t.Coeff;
+        return *this;
+    }
+
+    struct Hash {
+        double EnergySpacing;
+        explicit Hash(double EnergySpacing) : EnergySpacing(EnergySpacing) {}
+        std::size_t operator()(PoleTerm const& t) const {
+            return std::hash<long>()(std::lround(t.Pole / EnergySpacing));
+        }
+    };
+    struct KeyEqual {
+        double Tolerance;
+        explicit KeyEqual(double Tolerance) : Tolerance(Tolerance) {}
+        bool operator()(PoleTerm const& t1, PoleTerm const& t2) const {
+            return std::abs(t1.Pole - t2.Pole) <= Tolerance;
+        }
+    };
+    struct IsNegligible {
+        double Tolerance;
+        explicit IsNegligible(double Tolerance) : Tolerance(Tolerance) {}
+        bool operator()(PoleTerm const& t, std::size_t ToleranceDivisor) const {
+            return std::abs(t.Coeff) <= Tolerance / ToleranceDivisor;
+        }
+    };
+};
+
+// cppcheck-suppress syntaxError
+TEST_CASE("Addition and removal of terms", "[TermList]") {
+    PoleTerm::Hash const hasher(1e-8);
+    PoleTerm::KeyEqual const key_equal(1e-8);
+    PoleTerm::IsNegligible const is_negligible(1e-12);
+    TermList<PoleTerm> tl(hasher, key_equal, is_negligible);
+
+    // Reference: sums of coefficients for each pole on an integer grid
+    std::map<int, ComplexType> ref;
+
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<int> pole_dist(-500, 500);
+    std::uniform_int_distribution<int> coeff_dist(-3, 3);
+
+    for(int n = 0; n < 20000; ++n) {
+        int p = pole_dist(gen);
+        ComplexType c(coeff_dist(gen), coeff_dist(gen));
+        // New terms are never checked for negligibility, so the callers are expected to filter them out
+        if(c == ComplexType(0))
+            continue;
+        tl.add_term(PoleTerm(c, 0.01 * p));
+        ref[p] += c;
+    }
+
+    // Add exact negatives of a half of the accumulated terms so that they are removed
+    for(auto& r : ref) {
+        if(r.first % 2 == 0 && r.second != ComplexType(0)) {
+            tl.add_term(PoleTerm(-r.second, 0.01 * r.first));
+            r.second = 0;
+        }
+    }
+
+    std::size_t n_nonzero = 0;
+    for(auto const& r : ref) {
+        if(r.second != ComplexType(0))
+            ++n_nonzero;
+    }
+    REQUIRE(tl.size() == n_nonzero);
+    REQUIRE(tl.as_set().size() == n_nonzero);
+    REQUIRE(tl.check_terms());
+
+    for(auto const& t : tl.as_vector()) {
+        auto p = static_cast<int>(std::lround(t.Pole / 0.01));
+        REQUIRE_THAT(t.Pole, IsCloseTo(0.01 * p, 1e-12));
+        REQUIRE(t.Coeff == ref.at(p));
+    }
+
+    ComplexType z(0.3, 1.0);
+    ComplexType val_ref = 0;
+    for(auto const& r : ref)
+        val_ref += r.second / (z - 0.01 * r.first);
+    REQUIRE_THAT(tl(z), IsCloseTo(val_ref, 1e-10));
+
+    SECTION("Merge") {
+        TermList<PoleTerm> tl2(hasher, key_equal, is_negligible);
+        for(auto const& r : ref)
+            tl2.add_term(PoleTerm(ComplexType(1.0), 0.01 * r.first));
+        tl2.merge(tl);
+        std::size_t n_nonzero2 = 0;
+        for(auto const& r : ref) {
+            if(r.second + 1.0 != ComplexType(0))
+                ++n_nonzero2;
+        }
+        REQUIRE(tl2.size() == n_nonzero2);
+        for(auto const& t : tl2.as_vector()) {
+            auto p = static_cast<int>(std::lround(t.Pole / 0.01));
+            REQUIRE(t.Coeff == ref.at(p) + 1.0);
+        }
+    }
+
+    SECTION("Clear") {
+        tl.clear();
+        REQUIRE(tl.size() == 0);
+        tl.add_term(PoleTerm(1.0, 0.5));
+        tl.add_term(PoleTerm(2.0, 0.5));
+        REQUIRE(tl.size() == 1);
+        REQUIRE(tl.as_vector().front().Coeff == ComplexType(3.0));
+    }
+}
@@ -20,6 +20,7 @@
 #include <pomerol/HilbertSpace.hpp>
 #include <pomerol/IndexClassification.hpp>
 #include <pomerol/LatticePresets.hpp>
+#include <pomerol/MatsubaraContainers.hpp>
 #include <pomerol/Misc.hpp>
 #include <pomerol/StatesClassification.hpp>
 #include <pomerol/TwoParticleGFContainer.hpp>
@@ -28,6 +29,8 @@
 #include "catch2/catch-pomerol.hpp"
 
 #include <cmath>
+#include <cstddef>
+#include <vector>
 
 // Generalized 'square' function.
 template <typename T> inline T sqr(T x) {
@@ -146,6 +149,116 @@ TEST_CASE("Two-particle vertex of a single Hubbard atom", "[Vertex4]") {
                 }
             }
         }
+
+        // Point-wise filling of the same storage
+        MatsubaraContainer4<Vertex4> Pointwise(Gamma4_uuuu);
+        Pointwise.fill(n_iw);
+        REQUIRE(Pointwise.getNumberOfMatsubaras() == n_iw);
+        for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+            for(int n2 = -n_iw; n2 < n_iw; ++n2) {
+                for(int n3 = -n_iw; n3 < n_iw; ++n3) {
+                    INFO(n1 << " " << n2 << " " << n3);
+                    REQUIRE_THAT(Pointwise(n1, n2, n3), IsCloseTo(Gamma4_uuuu(n1, n2, n3), 1e-10));
+                }
+            }
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("\\Gamma_{\\up\\up\\up\\up} from precomputed \\chi_{\\up\\up\\up\\up}") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGFContainer ChiGrid(IndexInfo, S, H, rho, Operators);
+        ChiGrid.PoleResolution = 1e-4;
+        ChiGrid.CoefficientTolerance = 1e-12;
+        ChiGrid.prepareAll();
+
+        // This grid covers all precomputed values of the vertex
+        FreqGrid3 grid(PP, {-2 * n_iw + 1, 2 * n_iw}, {-n_iw, n_iw}, {-n_iw, n_iw});
+        auto chi_data = ChiGrid.computeAll(false, grid);
+        auto const& chi_uuuu_data = chi_data[IndexCombination4(up_index, up_index, up_index, up_index)];
+
+        GreensFunction const& GF = G(up_index, up_index);
+        TwoParticleGF const& Chi_uuuu = ChiGrid(IndexCombination4(up_index, up_index, up_index, up_index));
+        Vertex4 Gamma4_uuuu(Chi_uuuu, GF, GF, GF, GF);
+        Gamma4_uuuu.compute(n_iw, grid, chi_uuuu_data);
+
+        for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+            for(int n2 = -n_iw; n2 < n_iw; ++n2) {
+                for(int n3 = -n_iw; n3 < n_iw; ++n3) {
+                    int n4 = n1 + n2 - n3;
+                    INFO(n1 << " " << n2 << " " << n3 << " " << n4);
+                    ComplexType Gamma_ref = Gamma4uuuu_ref(n1, n2, n3) * GF(n1) * GF(n2) * GF(n3) * GF(n4);
+                    REQUIRE_THAT(Gamma4_uuuu(n1, n2, n3), IsCloseTo(Gamma_ref, 1e-10));
+                }
+            }
+        }
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("\\Gamma_{\\up\\up\\up\\up} from purged \\chi_{\\up\\up\\up\\up}") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGFContainer ChiClear(IndexInfo, S, H, rho, Operators);
+        ChiClear.PoleResolution = 1e-4;
+        ChiClear.CoefficientTolerance = 1e-12;
+        ChiClear.prepareAll();
+        ChiClear.computeAll(true);
+
+        GreensFunction const& GF = G(up_index, up_index);
+        TwoParticleGF const& ChiClear_uuuu = ChiClear(IndexCombination4(up_index, up_index, up_index, up_index));
+        REQUIRE_FALSE(ChiClear_uuuu.areTermsDistributed());
+
+        // The connected part cannot be computed without the terms
+        Vertex4 Gamma4_uuuu(ChiClear_uuuu, GF, GF, GF, GF);
+        REQUIRE_THROWS_AS(Gamma4_uuuu.compute(n_iw), ComputableObject::StatusMismatch);
+        REQUIRE_THROWS_AS(Gamma4_uuuu.compute(n_iw, MPI_COMM_WORLD), ComputableObject::StatusMismatch);
+        // cppcheck-suppress-end unreadVariable
+    }
+
+    SECTION("\\Gamma_{\\up\\up\\up\\up} with distributed terms") {
+        // cppcheck-suppress-begin unreadVariable
+        TwoParticleGFContainer ChiDist(IndexInfo, S, H, rho, Operators);
+        ChiDist.PoleResolution = 1e-4;
+        ChiDist.CoefficientTolerance = 1e-12;
+        ChiDist.DistributedTerms = true;
+        ChiDist.prepareAll();
+        ChiDist.computeAll();
+
+        GreensFunction const& GF = G(up_index, up_index);
+        TwoParticleGF const& Chi_uuuu = Chi(IndexCombination4(up_index, up_index, up_index, up_index));
+        TwoParticleGF const& ChiDist_uuuu = ChiDist(IndexCombination4(up_index, up_index, up_index, up_index));
+
+        std::vector<MatsubaraTriplet> indices;
+        for(int n1 = -n_iw; n1 < n_iw; ++n1) {
+            for(int n2 = -n_iw; n2 < n_iw; ++n2) {
+                for(int n3 = -n_iw; n3 < n_iw; ++n3)
+                    indices.push_back({n1, n2, n3});
+            }
+        }
+        auto chi_values = ChiDist_uuuu.evaluate(indices, MPI_COMM_WORLD);
+        REQUIRE(chi_values.size() == indices.size());
+        for(std::size_t k = 0; k < indices.size(); ++k) {
+            auto const& n = indices[k];
+            REQUIRE_THAT(chi_values[k], IsCloseTo(Chi_uuuu(n[0], n[1], n[2]), 1e-10));
+        }
+
+        // Pointwise evaluation works only if all parts are stored on this process
+        REQUIRE(ChiDist_uuuu.areTermsDistributed());
+        if(pMPI::size(MPI_COMM_WORLD) == 1)
+            REQUIRE_THAT(ChiDist_uuuu(0, 1, 2), IsCloseTo(Chi_uuuu(0, 1, 2), 1e-10));
+
+        Vertex4 Gamma4_uuuu(ChiDist_uuuu, GF, GF, GF, GF);
+        // The local overload cannot evaluate terms stored on other processes
+        REQUIRE_THROWS_AS(Gamma4_uuuu.compute(n_iw), ComputableObject::StatusMismatch);
+        Gamma4_uuuu.compute(n_iw, MPI_COMM_WORLD);
+        for(auto const& n : indices) {
+            INFO(n[0] << " " << n[1] << " " << n[2]);
+            // Only the precomputed values are available on all processes
+            long n4 = n[0] + n[1] - n[2];
+            if(n4 < -n_iw || n4 >= n_iw)
+                continue;
+            ComplexType Gamma_ref = Gamma4uuuu_ref(n[0], n[1], n[2]) * GF(n[0]) * GF(n[1]) * GF(n[2]) * GF(n4);
+            REQUIRE_THAT(Gamma4_uuuu(n[0], n[1], n[2]), IsCloseTo(Gamma_ref, 1e-10));
+        }
         // cppcheck-suppress-end unreadVariable
     }
 